@@ -0,0 +1,487 @@
+/*
+ * Harness.cpp
+ */
+
+#include "Harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace BulletEngine {
+namespace bench {
+
+static constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+static constexpr uint64_t MAX_ITERATIONS = uint64_t(1) << 40;
+static constexpr size_t EVICT_BYTES = 64 * 1024 * 1024;
+
+static void writeJsonString(std::ostream& out, const std::string& text)
+{
+    out << '"';
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out << escaped;
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// json has no nan, unavailable counters become null
+static void writeJsonNumber(std::ostream& out, double value)
+{
+    if (std::isfinite(value))
+    {
+        out << value;
+    }
+    else
+    {
+        out << "null";
+    }
+}
+
+std::string Case::id() const
+{
+    std::string result = name;
+    for (const auto& [key, value] : params)
+    {
+        result += "/" + key + "=" + value;
+    }
+    return result;
+}
+
+Harness::Config Harness::parseArgs(int argc, char** argv, Config defaults)
+{
+    Config config = defaults;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--samples") config.samples = std::max<size_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+        else if (arg == "--min-time") config.minSampleTime = std::strtod(argv[i + 1], nullptr) * 1e-3;
+        else if (arg == "--filter") config.filter = argv[i + 1];
+        else if (arg == "--out") config.output = argv[i + 1];
+        else if (arg == "--seed") config.seed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (arg == "--cpu") config.cpu = std::atoi(argv[i + 1]);
+        else if (arg == "--realtime") config.realtime = std::atoi(argv[i + 1]) != 0;
+        else if (arg == "--counters") config.counters = std::atoi(argv[i + 1]) != 0;
+    }
+
+    return config;
+}
+
+Harness::Harness(const Config& config) : m_config(config)
+{
+#ifdef __linux__
+    if (m_config.cpu >= 0)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(m_config.cpu, &cpuset);
+        if (sched_setaffinity(0, sizeof(cpuset), &cpuset) != 0)
+            std::cerr << "warning: sched_setaffinity failed: " << std::strerror(errno) << "\n";
+    }
+
+    if (m_config.realtime)
+    {
+        sched_param param{};
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0)
+            std::cerr << "warning: sched_setscheduler failed: " << std::strerror(errno) << "\n";     // use sudo
+    }
+#endif
+
+    if (m_config.counters)
+    {
+        m_counters = std::make_unique<PerfCounters>();
+        if (!m_counters->isAvailable())
+            std::cerr << "warning: hardware counters unavailable: " << m_counters->getError() << "\n";
+    }
+}
+
+Harness::~Harness() = default;
+
+Case& Harness::add(std::string name, Params params, std::function<void(uint64_t iterations)> run)
+{
+    auto benchmark = std::make_unique<Case>();
+    benchmark->name = std::move(name);
+    benchmark->params = std::move(params);
+    benchmark->run = std::move(run);
+    m_cases.push_back(std::move(benchmark));
+    return *m_cases.back();
+}
+
+void Harness::evictCaches()
+{
+    static std::vector<std::uint8_t> buffer(EVICT_BYTES, 1);
+    std::uint64_t sum = 0;
+    for (size_t i = 0; i < buffer.size(); i += 64)
+    {
+        sum += buffer[i];
+    }
+    doNotOptimize(sum);
+}
+
+double Harness::sample(const Case& benchmark, uint64_t iterations, CounterValues* counts)
+{
+    if (benchmark.setup)
+    {
+        benchmark.setup();
+    }
+
+    if (benchmark.coldCache)
+    {
+        evictCaches();
+    }
+
+    bool counting = counts && m_counters && m_counters->isAvailable();
+    if (counting)
+    {
+        m_counters->start();
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    benchmark.run(iterations);
+    auto t1 = std::chrono::steady_clock::now();
+
+    if (counting)
+    {
+        *counts = m_counters->stop();
+    }
+
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+uint64_t Harness::calibrate(const Case& benchmark)
+{
+    uint64_t iterations = 1;
+
+    while (iterations < MAX_ITERATIONS)
+    {
+        double seconds = sample(benchmark, iterations, nullptr);
+        if (seconds >= m_config.minSampleTime)
+        {
+            break;
+        }
+
+        // aim a bit past the target, grow at most tenfold per try so one lucky sample cannot overshoot
+        double scale = seconds > 0.0 ? std::min(m_config.minSampleTime / seconds * 1.2, 10.0) : 10.0;
+        iterations = std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) * scale));
+    }
+
+    return std::min(iterations, MAX_ITERATIONS);
+}
+
+size_t Harness::warmup(const Case& benchmark, uint64_t iterations)
+{
+    size_t window = std::max<size_t>(m_config.warmupWindow, 1);
+    std::vector<double> times;
+    double previous = 0.0;
+    size_t samples = 0;
+
+    // warm once two consecutive windows agree
+    while (samples + window <= m_config.maxWarmupSamples)
+    {
+        times.clear();
+        for (size_t i = 0; i < window; i++)
+        {
+            times.push_back(sample(benchmark, iterations, nullptr));
+        }
+        samples += window;
+
+        double current = median(times);
+        if (previous > 0.0 && std::abs(current - previous) <= m_config.warmupTolerance * previous)
+        {
+            break;
+        }
+
+        previous = current;
+    }
+
+    return samples;
+}
+
+void Harness::run()
+{
+    m_results.clear();
+
+    for (const auto& benchmark : m_cases)
+    {
+        if (m_config.filter.empty() || benchmark->id().find(m_config.filter) != std::string::npos)
+        {
+            m_results.push_back({});
+            m_results.back().benchmark = benchmark.get();
+        }
+    }
+
+    std::vector<size_t> order(m_results.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(m_config.seed));
+
+    // calibration and warmup, one case at a time
+    std::shuffle(order.begin(), order.end(), rng);
+    for (size_t index : order)
+    {
+        auto& result = m_results[index];
+        const auto& benchmark = *result.benchmark;
+
+        result.iterations = benchmark.iterations > 0 ? benchmark.iterations : calibrate(benchmark);
+        result.warmupSamples = warmup(benchmark, result.iterations);
+    }
+
+    std::vector<std::vector<CounterValues>> counts(m_results.size());
+
+    for (size_t round = 0; round < m_config.samples; round++)
+    {
+        std::shuffle(order.begin(), order.end(), rng);
+
+        for (size_t index : order)
+        {
+            auto& result = m_results[index];
+            const auto& benchmark = *result.benchmark;
+            double items = static_cast<double>(result.iterations) * benchmark.itemsPerIteration;
+
+            CounterValues sampleCounts;
+            double seconds = sample(benchmark, result.iterations, &sampleCounts);
+
+            result.samples.push_back(seconds * 1e9 / items);
+            if (m_counters && m_counters->isAvailable())
+            {
+                counts[index].push_back(sampleCounts.per(items));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_results.size(); i++)
+    {
+        auto& result = m_results[i];
+        result.time = summarize(result.samples, m_config.outlierThreshold, &result.outliers);
+
+        // counters of the samples the time kept
+        for (size_t c = 0; c < COUNTER_COUNT; c++)
+        {
+            std::vector<double> values;
+            for (size_t s = 0; s < counts[i].size(); s++)
+            {
+                if (!result.outliers[s] && !std::isnan(counts[i][s].values[c]))
+                {
+                    values.push_back(counts[i][s].values[c]);
+                }
+            }
+            result.counters.values[c] = values.empty() ? std::nan("") : median(values);
+        }
+
+        std::cout << result.benchmark->id() << ": " << result.time.median << " ns"
+                  << " +-" << result.time.mad
+                  << " (95% " << result.time.ciLow << ".." << result.time.ciHigh << ")"
+                  << ", " << result.time.kept << " samples, " << result.time.rejected << " outliers"
+                  << ", " << result.iterations << " iterations";
+        if (result.counters.has(Counter::CYCLES) && result.counters.has(Counter::INSTRUCTIONS))
+        {
+            std::cout << ", ipc " << result.counters.ipc();
+        }
+        std::cout << "\n";
+    }
+
+    if (!m_config.output.empty())
+    {
+        std::string json = m_config.output + ".json";
+        std::string csv = m_config.output + ".csv";
+
+        if (writeJson(json) && writeCsv(csv))
+            std::cout << "done " << json << ", " << csv << "\n";
+        else
+            std::cerr << "failed to write " << json << " or " << csv << "\n";
+    }
+}
+
+bool Harness::writeJson(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        return false;
+    }
+
+    out.precision(10);
+
+    char date[32] = {};
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+
+    // what makes two runs comparable
+    out << "{\n  \"context\": {\"date\": \"" << date << "\", \"build\": \"" << build << "\", \"compiler\": ";
+    writeJsonString(out, __VERSION__);
+    out << ", \"hardware_threads\": " << std::thread::hardware_concurrency()
+        << ", \"counters\": " << (m_counters && m_counters->isAvailable() ? "true" : "false") << "},\n";
+
+    out << "  \"config\": {\"samples\": " << m_config.samples << ", \"min_sample_time\": " << m_config.minSampleTime
+        << ", \"outlier_threshold\": " << m_config.outlierThreshold << ", \"seed\": " << m_config.seed
+        << ", \"cpu\": " << m_config.cpu << ", \"realtime\": " << (m_config.realtime ? "true" : "false") << "},\n";
+
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < m_results.size(); i++)
+    {
+        const auto& result = m_results[i];
+        const auto& benchmark = *result.benchmark;
+
+        out << (i > 0 ? ",\n" : "\n") << "    {\"id\": ";
+        writeJsonString(out, benchmark.id());
+        out << ", \"name\": ";
+        writeJsonString(out, benchmark.name);
+
+        out << ", \"params\": {";
+        for (size_t p = 0; p < benchmark.params.size(); p++)
+        {
+            out << (p > 0 ? ", " : "");
+            writeJsonString(out, benchmark.params[p].first);
+            out << ": ";
+            writeJsonString(out, benchmark.params[p].second);
+        }
+
+        out << "}, \"metrics\": {";
+        for (size_t m = 0; m < benchmark.metrics.size(); m++)
+        {
+            out << (m > 0 ? ", " : "");
+            writeJsonString(out, benchmark.metrics[m].first);
+            out << ": ";
+            writeJsonNumber(out, benchmark.metrics[m].second);
+        }
+
+        out << "},\n     \"iterations\": " << result.iterations << ", \"items_per_iteration\": " << benchmark.itemsPerIteration
+            << ", \"warmup_samples\": " << result.warmupSamples << ",\n";
+
+        out << "     \"median_ns\": " << result.time.median << ", \"mad_ns\": " << result.time.mad
+            << ", \"ci_low_ns\": " << result.time.ciLow << ", \"ci_high_ns\": " << result.time.ciHigh
+            << ", \"mean_ns\": " << result.time.mean << ", \"min_ns\": " << result.time.min << ", \"max_ns\": " << result.time.max
+            << ", \"kept\": " << result.time.kept << ", \"rejected\": " << result.time.rejected << ",\n";
+
+        out << "     \"counters\": {";
+        for (size_t c = 0; c < COUNTER_COUNT; c++)
+        {
+            out << (c > 0 ? ", " : "") << "\"" << PerfCounters::name(static_cast<Counter>(c)) << "\": ";
+            writeJsonNumber(out, result.counters.values[c]);
+        }
+
+        out << "},\n     \"samples_ns\": [";
+        for (size_t s = 0; s < result.samples.size(); s++)
+        {
+            out << (s > 0 ? ", " : "") << result.samples[s];
+        }
+
+        out << "], \"outliers\": [";
+        bool first = true;
+        for (size_t s = 0; s < result.outliers.size(); s++)
+        {
+            if (result.outliers[s])
+            {
+                out << (first ? "" : ", ") << s;
+                first = false;
+            }
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+
+    return static_cast<bool>(out);
+}
+
+bool Harness::writeCsv(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        return false;
+    }
+
+    out.precision(10);
+
+    // union of parameter and metric names, first seen order, missing ones stay empty
+    std::vector<std::string> params;
+    std::vector<std::string> metrics;
+    for (const auto& result : m_results)
+    {
+        for (const auto& param : result.benchmark->params)
+        {
+            if (std::find(params.begin(), params.end(), param.first) == params.end())
+                params.push_back(param.first);
+        }
+        for (const auto& metric : result.benchmark->metrics)
+        {
+            if (std::find(metrics.begin(), metrics.end(), metric.first) == metrics.end())
+                metrics.push_back(metric.first);
+        }
+    }
+
+    out << "id,benchmark";
+    for (const auto& name : params)
+        out << "," << name;
+    for (const auto& name : metrics)
+        out << "," << name;
+    out << ",iterations,samples,rejected,median_ns,mad_ns,ci_low_ns,ci_high_ns,mean_ns,min_ns,max_ns";
+    PerfCounters::writeCsvHeader(out);
+    out << "\n";
+
+    for (const auto& result : m_results)
+    {
+        const auto& benchmark = *result.benchmark;
+
+        out << benchmark.id() << "," << benchmark.name;
+        for (const auto& name : params)
+        {
+            auto it = std::find_if(benchmark.params.begin(), benchmark.params.end(), [&](const auto& param) { return param.first == name; });
+            out << "," << (it != benchmark.params.end() ? it->second : "");
+        }
+        for (const auto& name : metrics)
+        {
+            auto it = std::find_if(benchmark.metrics.begin(), benchmark.metrics.end(), [&](const auto& metric) { return metric.first == name; });
+            out << ",";
+            if (it != benchmark.metrics.end())
+                out << it->second;
+        }
+
+        out << "," << result.iterations << "," << result.time.kept << "," << result.time.rejected
+            << "," << result.time.median << "," << result.time.mad << "," << result.time.ciLow << "," << result.time.ciHigh
+            << "," << result.time.mean << "," << result.time.min << "," << result.time.max;
+        PerfCounters::writeCsv(out, result.counters);
+        out << "\n";
+    }
+
+    return static_cast<bool>(out);
+}
+
+} // namespace bench
+} // namespace BulletEngine
@@ -0,0 +1,119 @@
+/*
+ * Harness.h
+ */
+
+#pragma once
+
+#include "bench/PerfCounters.h"
+#include "bench/Statistics.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace BulletEngine {
+namespace bench {
+
+// bound parameters of a case, name and value in registration order
+using Params = std::vector<std::pair<std::string, std::string>>;
+
+// keeps a value alive without the compiler seeing through it
+template<class T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// one measured configuration, run is timed and setup is not
+struct Case {
+    std::string name;
+    Params params;
+
+    std::function<void(uint64_t iterations)> run;
+    std::function<void()> setup;                    // before every sample, optional
+
+    double itemsPerIteration = 1.0;                 // results are per item
+    uint64_t iterations = 0;                        // fixed count, 0 calibrates
+    bool coldCache = false;                         // evict caches before every sample
+
+    // extra columns of the report, such as accuracy next to speed
+    std::vector<std::pair<std::string, double>> metrics;
+
+    // "name/key=value/..."
+    std::string id() const;
+
+    Case& withSetup(std::function<void()> function) { setup = std::move(function); return *this; }
+    Case& withItems(double items) { itemsPerIteration = items; return *this; }
+    Case& withIterations(uint64_t count) { iterations = count; return *this; }
+    Case& withColdCache(bool cold = true) { coldCache = cold; return *this; }
+    Case& withMetric(std::string metricName, double value) { metrics.emplace_back(std::move(metricName), value); return *this; }
+};
+
+struct Result {
+    const Case* benchmark = nullptr;
+    uint64_t iterations = 0;
+    size_t warmupSamples = 0;
+    std::vector<double> samples;            // ns per item, in measurement order
+    std::vector<bool> outliers;
+    Summary time;                           // ns per item
+    CounterValues counters;                 // median per item of kept samples
+};
+
+// registered cases run with calibrated iteration counts, detected warmup and interleaved samples
+// every round visits the cases in a new shuffled order so drift spreads over all of them
+class Harness {
+public:
+    struct Config {
+        size_t samples = 15;                // measured per case
+        double minSampleTime = 0.01;        // s, calibration target of one sample
+        size_t warmupWindow = 3;            // samples per warmup window
+        size_t maxWarmupSamples = 30;
+        double warmupTolerance = 0.03;      // window medians this close count as warm
+        double outlierThreshold = 3.5;
+        uint64_t seed = 12345;
+        bool counters = true;               // hardware counters, where permitted
+        int cpu = -1;                       // pin to this cpu, -1 leaves affinity alone
+        bool realtime = false;              // SCHED_FIFO, needs privileges
+        std::string filter;                 // run cases whose id contains this
+        std::string output;                 // <output>.json and <output>.csv, empty writes nothing
+    };
+
+    // --samples n, --min-time ms, --filter s, --out prefix, --seed n, --cpu n, --realtime 0|1, --counters 0|1
+    static Config parseArgs(int argc, char** argv, Config defaults);
+
+    explicit Harness(const Config& config);
+    ~Harness();
+
+    Harness(const Harness&) = delete;
+    Harness& operator=(const Harness&) = delete;
+
+    // reference stays valid until the harness is destroyed
+    Case& add(std::string name, Params params, std::function<void(uint64_t iterations)> run);
+
+    // measures every case passing the filter, prints a line each, writes output files if set
+    void run();
+
+    const std::vector<Result>& getResults() const { return m_results; }
+
+    bool writeJson(const std::string& path) const;
+    bool writeCsv(const std::string& path) const;
+
+    // touches a buffer larger than the last level cache
+    static void evictCaches();
+
+private:
+    double sample(const Case& benchmark, uint64_t iterations, CounterValues* counts);
+    uint64_t calibrate(const Case& benchmark);
+    size_t warmup(const Case& benchmark, uint64_t iterations);
+
+    Config m_config;
+    std::vector<std::unique_ptr<Case>> m_cases;
+    std::vector<Result> m_results;
+    std::unique_ptr<PerfCounters> m_counters;
+};
+
+} // namespace bench
+} // namespace BulletEngine
@@ -0,0 +1,234 @@
+/*
+ * PerfCounters.cpp
+ */
+
+#include "PerfCounters.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace BulletEngine {
+namespace bench {
+
+static constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+static constexpr double NOT_COUNTED = std::numeric_limits<double>::quiet_NaN();
+
+CounterValues CounterValues::per(double count) const
+{
+    CounterValues result;
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        result.values[i] = values[i] / count;
+    }
+    return result;
+}
+
+#ifdef __linux__
+
+static void describe(perf_event_attr& attr, Counter counter)
+{
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+
+    switch (counter)
+    {
+    case Counter::CYCLES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case Counter::INSTRUCTIONS:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case Counter::L1D_MISSES:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case Counter::LLC_MISSES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case Counter::BRANCH_MISSES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        break;
+    }
+
+    // user space only, allowed up to perf_event_paranoid 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+}
+
+PerfCounters::PerfCounters()
+{
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        m_fds[i] = -1;
+        m_slots[i] = 0;
+    }
+
+    // first counter that opens leads the group so all are scheduled together
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        auto counter = static_cast<Counter>(i);
+
+        perf_event_attr attr;
+        describe(attr, counter);
+        attr.disabled = m_leader < 0 ? 1 : 0;
+
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, m_leader, 0));
+        if (fd < 0)
+        {
+            m_error += std::string(m_error.empty() ? "" : ", ") + name(counter) + ": " + std::strerror(errno);
+            continue;
+        }
+
+        if (m_leader < 0)
+        {
+            m_leader = fd;
+        }
+
+        m_fds[i] = fd;
+        m_slots[i] = m_opened++;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (int fd : m_fds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+}
+
+void PerfCounters::start()
+{
+    if (m_leader < 0)
+    {
+        return;
+    }
+
+    ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+CounterValues PerfCounters::stop()
+{
+    CounterValues result;
+    for (auto& value : result.values)
+    {
+        value = NOT_COUNTED;
+    }
+
+    if (m_leader < 0)
+    {
+        return result;
+    }
+
+    ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time enabled, time running, one value per opened counter
+    uint64_t data[3 + COUNTER_COUNT] = {};
+    if (read(m_leader, data, sizeof(data)) < static_cast<ssize_t>((3 + m_opened) * sizeof(uint64_t)))
+    {
+        return result;
+    }
+
+    uint64_t enabled = data[1];
+    uint64_t running = data[2];
+    if (running == 0)
+    {
+        return result;
+    }
+
+    // group shared the pmu with others, extrapolate to the whole region
+    double scale = static_cast<double>(enabled) / static_cast<double>(running);
+
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        if (m_fds[i] >= 0)
+        {
+            result.values[i] = static_cast<double>(data[3 + m_slots[i]]) * scale;
+        }
+    }
+
+    return result;
+}
+
+#else
+
+PerfCounters::PerfCounters() : m_error("perf_event_open is linux only")
+{
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        m_fds[i] = -1;
+        m_slots[i] = 0;
+    }
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::start() {}
+
+CounterValues PerfCounters::stop()
+{
+    CounterValues result;
+    for (auto& value : result.values)
+    {
+        value = NOT_COUNTED;
+    }
+    return result;
+}
+
+#endif
+
+const char* PerfCounters::name(Counter counter)
+{
+    switch (counter)
+    {
+    case Counter::CYCLES: return "cycles";
+    case Counter::INSTRUCTIONS: return "instructions";
+    case Counter::L1D_MISSES: return "l1d_misses";
+    case Counter::LLC_MISSES: return "llc_misses";
+    case Counter::BRANCH_MISSES: return "branch_misses";
+    default: return "?";
+    }
+}
+
+void PerfCounters::writeCsvHeader(std::ostream& out)
+{
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        out << "," << name(static_cast<Counter>(i));
+    }
+}
+
+void PerfCounters::writeCsv(std::ostream& out, const CounterValues& values)
+{
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        out << ",";
+        if (values.has(static_cast<Counter>(i)))
+        {
+            out << values.values[i];
+        }
+    }
+}
+
+} // namespace bench
+} // namespace BulletEngine
@@ -0,0 +1,72 @@
+/*
+ * PerfCounters.h
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace BulletEngine {
+namespace bench {
+
+enum class Counter {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,         // l1 data cache read misses
+    LLC_MISSES,         // last level cache misses
+    BRANCH_MISSES,
+    COUNT
+};
+
+// counts of one measured region, nan where the counter is unavailable
+struct CounterValues {
+    double values[static_cast<size_t>(Counter::COUNT)];
+
+    double operator[](Counter counter) const { return values[static_cast<size_t>(counter)]; }
+    bool has(Counter counter) const { return !std::isnan((*this)[counter]); }
+
+    double ipc() const { return (*this)[Counter::INSTRUCTIONS] / (*this)[Counter::CYCLES]; }
+
+    // every counter divided, for per step or per item figures
+    CounterValues per(double count) const;
+};
+
+// hardware counters of the calling thread through perf_event_open, user space only
+// counters the kernel refuses (paranoid setting, vm without pmu, other os) read as nan instead of failing
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool isAvailable() const { return m_leader >= 0; }
+    bool isAvailable(Counter counter) const { return m_fds[static_cast<size_t>(counter)] >= 0; }
+
+    // why counters are missing, empty if all opened
+    const std::string& getError() const { return m_error; }
+
+    // counting covers the region between start and stop, scaled if the kernel multiplexed the group
+    void start();
+    CounterValues stop();
+
+    static const char* name(Counter counter);
+
+    // ",cycles,instructions,..." and matching values, empty fields for unavailable counters
+    static void writeCsvHeader(std::ostream& out);
+    static void writeCsv(std::ostream& out, const CounterValues& values);
+
+private:
+    int m_fds[static_cast<size_t>(Counter::COUNT)];
+    size_t m_slots[static_cast<size_t>(Counter::COUNT)];    // position in group read
+    int m_leader = -1;
+    size_t m_opened = 0;
+    std::string m_error;
+};
+
+} // namespace bench
+} // namespace BulletEngine
@@ -0,0 +1,128 @@
+/*
+ * Statistics.cpp
+ */
+
+#include "Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BulletEngine {
+namespace bench {
+
+// mad of a normal distribution is this fraction of its standard deviation
+static constexpr double MAD_TO_SIGMA = 1.4826;
+static constexpr double Z_95 = 1.959964;
+
+double median(std::vector<double> values)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+
+    size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    double upper = values[middle];
+
+    if (values.size() % 2 == 1)
+    {
+        return upper;
+    }
+
+    double lower = *std::max_element(values.begin(), values.begin() + middle);
+    return 0.5 * (lower + upper);
+}
+
+void medianInterval(const std::vector<double>& sorted, double& low, double& high)
+{
+    if (sorted.empty())
+    {
+        low = high = 0.0;
+        return;
+    }
+
+    // ranks n/2 -+ z sqrt(n) / 2 of the binomial around the median, 1 based
+    double n = static_cast<double>(sorted.size());
+    double spread = Z_95 * std::sqrt(n) * 0.5;
+    auto lowRank = static_cast<long>(std::floor(n * 0.5 - spread));
+    auto highRank = static_cast<long>(std::ceil(n * 0.5 + spread));
+
+    lowRank = std::clamp<long>(lowRank, 1, static_cast<long>(sorted.size()));
+    highRank = std::clamp<long>(highRank, 1, static_cast<long>(sorted.size()));
+
+    low = sorted[lowRank - 1];
+    high = sorted[highRank - 1];
+}
+
+Summary summarize(const std::vector<double>& samples, double outlierThreshold, std::vector<bool>* outliers)
+{
+    Summary summary;
+
+    if (outliers)
+    {
+        outliers->assign(samples.size(), false);
+    }
+
+    if (samples.empty())
+    {
+        return summary;
+    }
+
+    double center = median(samples);
+
+    std::vector<double> deviations(samples.size());
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        deviations[i] = std::abs(samples[i] - center);
+    }
+    double mad = median(deviations);
+
+    // identical samples have no spread to judge by, keep them all
+    std::vector<double> kept;
+    kept.reserve(samples.size());
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        bool outlier = mad > 0.0 && deviations[i] / (MAD_TO_SIGMA * mad) > outlierThreshold;
+        if (outlier)
+        {
+            summary.rejected++;
+            if (outliers)
+            {
+                (*outliers)[i] = true;
+            }
+        }
+        else
+        {
+            kept.push_back(samples[i]);
+        }
+    }
+
+    std::sort(kept.begin(), kept.end());
+
+    summary.kept = kept.size();
+    summary.median = median(kept);
+    summary.min = kept.front();
+    summary.max = kept.back();
+
+    double sum = 0.0;
+    for (double value : kept)
+    {
+        sum += value;
+    }
+    summary.mean = sum / static_cast<double>(kept.size());
+
+    deviations.resize(kept.size());
+    for (size_t i = 0; i < kept.size(); i++)
+    {
+        deviations[i] = std::abs(kept[i] - summary.median);
+    }
+    summary.mad = median(deviations);
+
+    medianInterval(kept, summary.ciLow, summary.ciHigh);
+
+    return summary;
+}
+
+} // namespace bench
+} // namespace BulletEngine
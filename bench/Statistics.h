@@ -0,0 +1,36 @@
+/*
+ * Statistics.h
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace BulletEngine {
+namespace bench {
+
+// robust summary of repeated measurements
+struct Summary {
+    double median = 0.0;
+    double mad = 0.0;           // median absolute deviation, unscaled
+    double mean = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double ciLow = 0.0;         // 95% confidence interval of the median
+    double ciHigh = 0.0;
+    size_t kept = 0;
+    size_t rejected = 0;        // outliers left out of everything above
+};
+
+double median(std::vector<double> values);
+
+// |x - median| / (1.4826 * mad) above threshold is an outlier, 3.5 is the usual cut
+// samples are kept in order, outliers[i] tells which were dropped
+Summary summarize(const std::vector<double>& samples, double outlierThreshold, std::vector<bool>* outliers = nullptr);
+
+// distribution free interval of the median from order statistics of sorted values
+void medianInterval(const std::vector<double>& sorted, double& low, double& high);
+
+} // namespace bench
+} // namespace BulletEngine
@@ -0,0 +1,464 @@
+"""
+regression.py
+
+Runs the benchmark suite, stores results per machine and commit, and compares them against a baseline.
+Python standard library only, so it runs on any machine that builds the samples.
+Only results of the same machine, build type and compiler are compared.
+
+    regression.py run      --bin-dir build --results bench/results
+    regression.py compare  --results bench/results [--baseline <commit>] [--threshold 5] [--alpha 0.01]
+    regression.py check    run followed by compare, exits 1 on a significant slowdown
+    regression.py baseline --results bench/results [<commit>]
+
+The perf-regression build target runs check on the freshly built samples.
+"""
+
+import argparse
+import csv
+import glob
+import hashlib
+import json
+import math
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+import time
+
+# executable, extra arguments, output prefix the harness writes
+SUITE = [
+    ("BenchmarkPerformance", [], "performance"),
+    ("ComparisonIntegrators", [], "timing"),
+    ("ComparisonCosts", [], "costs"),
+    ("TestConvergence", [], "convergence"),
+    ("BenchmarkEcs", ["--max-entities", "100000"], "ecs"),
+    ("BenchmarkFrame", ["--projectiles", "500", "--duration", "3"], "frame"),
+]
+
+BASELINE_FILE = "BASELINE"
+
+# sample sizes up to this product get the exact rank test
+EXACT_LIMIT = 2500
+
+# outlier rule of the harness, |x - median| / (MAD_TO_SIGMA * mad) above OUTLIER_THRESHOLD
+OUTLIER_THRESHOLD = 3.5
+MAD_TO_SIGMA = 1.4826
+
+# build type and compiler move timings more than most commits, results are only compared within one
+CONTEXT_KEYS = ("build", "compiler")
+
+
+# machine
+
+def cpu_model():
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor() or "unknown"
+
+
+def memory_gb():
+    try:
+        with open("/proc/meminfo") as f:
+            for line in f:
+                if line.startswith("MemTotal"):
+                    return round(int(line.split()[1]) / (1024 * 1024))
+    except OSError:
+        pass
+    return 0
+
+
+def machine():
+    # what decides whether two runs are comparable at all, kernel and load are recorded but not part of it
+    info = {
+        "system": platform.system(),
+        "arch": platform.machine(),
+        "cpu": cpu_model(),
+        "cores": os.cpu_count() or 0,
+        "memory_gb": memory_gb(),
+    }
+    key = json.dumps(info, sort_keys=True).encode()
+    info["fingerprint"] = hashlib.sha1(key).hexdigest()[:12]
+    info["kernel"] = platform.release()
+    info["hostname"] = platform.node()
+    return info
+
+
+# git
+
+def git(*args):
+    result = subprocess.run(["git", *args], capture_output=True, text=True)
+    return result.stdout.strip() if result.returncode == 0 else ""
+
+
+def current_commit():
+    commit = git("rev-parse", "HEAD") or "unknown"
+    dirty = bool(git("status", "--porcelain", "--untracked-files=no"))
+    return commit, dirty
+
+
+def resolve_commit(ref):
+    return git("rev-parse", ref) or ref
+
+
+# results
+
+def result_name(commit, dirty, stamp):
+    return commit + ("-dirty" if dirty else "") + "-" + stamp + ".json"
+
+
+def results_of(directory, commit):
+    # repeated runs of one commit are kept side by side, newest first
+    return sorted(glob.glob(os.path.join(directory, commit + "-*.json")), key=os.path.getmtime, reverse=True)
+
+
+def load_harness_json(path, suite):
+    benchmarks = {}
+    with open(path) as f:
+        data = json.load(f)
+
+    for entry in data["benchmarks"]:
+        outliers = set(entry.get("outliers", []))
+        samples = [s for i, s in enumerate(entry["samples_ns"]) if i not in outliers]
+        benchmarks[entry["id"]] = {
+            "suite": suite,
+            "median_ns": entry["median_ns"],
+            "ci_low_ns": entry["ci_low_ns"],
+            "ci_high_ns": entry["ci_high_ns"],
+            "samples_ns": samples,
+        }
+
+    return data.get("context", {}), benchmarks
+
+
+def load_frame_csv(prefix, suite):
+    # per stage frame times after the warmup frames the summary left out
+    benchmarks = {}
+    with open(prefix + ".csv") as f:
+        frames = list(csv.DictReader(f))
+    with open(prefix + "-summary.csv") as f:
+        summary = list(csv.DictReader(f))
+
+    for row in summary:
+        count = int(row["samples"]) + int(row["rejected"])
+        column = "total_ns" if row["system"] == "total" else row["system"] + "_ns"
+        samples = drop_outliers([float(frame[column]) for frame in frames[-count:]])
+        benchmarks[row["id"]] = {
+            "suite": suite,
+            "median_ns": float(row["median_ns"]),
+            "ci_low_ns": float(row["ci_low_ns"]),
+            "ci_high_ns": float(row["ci_high_ns"]),
+            "samples_ns": samples,
+        }
+
+    return benchmarks
+
+
+def find_executable(bin_dir, name):
+    for candidate in (os.path.join(bin_dir, name), os.path.join(bin_dir, name + ".exe")):
+        if os.path.isfile(candidate):
+            return candidate
+    return None
+
+
+def run_suite(args):
+    commit, dirty = current_commit()
+    now = time.gmtime()
+    record = {
+        "commit": commit,
+        "dirty": dirty,
+        "date": time.strftime("%Y-%m-%dT%H:%M:%SZ", now),
+        "machine": machine(),
+        "context": {},
+        "benchmarks": {},
+    }
+
+    extra = []
+    if args.samples:
+        extra += ["--samples", str(args.samples)]
+
+    with tempfile.TemporaryDirectory() as work:
+        for name, suite_args, prefix in SUITE:
+            if args.only and name not in args.only:
+                continue
+
+            executable = find_executable(args.bin_dir, name)
+            if not executable:
+                print(f"skip {name}: not built in {args.bin_dir}")
+                continue
+
+            out = os.path.join(work, prefix)
+            command = [executable, *suite_args, "--out", out]
+            if name != "BenchmarkFrame":
+                command += extra
+
+            # samples load assets relative to their own directory
+            print(f"run {name}", flush=True)
+            result = subprocess.run(command, cwd=os.path.dirname(executable), stdout=subprocess.DEVNULL if not args.verbose else None)
+            if result.returncode != 0:
+                print(f"error: {name} exited with {result.returncode}")
+                return None
+
+            if name == "BenchmarkFrame":
+                record["benchmarks"].update(load_frame_csv(out, name))
+                continue
+
+            for path in sorted(glob.glob(out + "*.json")):
+                context, benchmarks = load_harness_json(path, name)
+                record["context"] = record["context"] or context
+                record["benchmarks"].update(benchmarks)
+
+    directory = os.path.join(args.results, record["machine"]["fingerprint"])
+    os.makedirs(directory, exist_ok=True)
+    path = os.path.join(directory, result_name(commit, dirty, time.strftime("%Y%m%dT%H%M%S", now)))
+    with open(path, "w") as f:
+        json.dump(record, f, indent=1)
+
+    print(f"stored {len(record['benchmarks'])} benchmarks in {path}")
+    return path
+
+
+def machine_directory(args):
+    return os.path.join(args.results, machine()["fingerprint"])
+
+
+def load_record(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+def build_key(record):
+    context = record.get("context", {})
+    return tuple(context.get(key) for key in CONTEXT_KEYS)
+
+
+def same_build(path, key):
+    return build_key(load_record(path)) == key
+
+
+def pick_baseline(args, current_path):
+    directory = os.path.dirname(current_path)
+    key = build_key(load_record(current_path))
+
+    ref = args.baseline
+    if not ref and os.path.isfile(os.path.join(directory, BASELINE_FILE)):
+        with open(os.path.join(directory, BASELINE_FILE)) as f:
+            ref = f.read().strip()
+
+    if ref:
+        commit = resolve_commit(ref)
+        for path in results_of(directory, commit):
+            if os.path.abspath(path) != os.path.abspath(current_path) and same_build(path, key):
+                return path
+        print(f"error: no stored result for {ref} on this machine for {describe_build(key)}, run the suite on that commit first")
+        return None
+
+    # newest other result of this machine and build
+    others = [p for p in glob.glob(os.path.join(directory, "*.json"))
+              if os.path.abspath(p) != os.path.abspath(current_path) and same_build(p, key)]
+    if not others:
+        print(f"no baseline stored for this machine and {describe_build(key)} yet, nothing to compare")
+        return None
+    return max(others, key=os.path.getmtime)
+
+
+def describe_build(key):
+    return ", ".join(f"{name} {value}" for name, value in zip(CONTEXT_KEYS, key))
+
+
+def pick_current(args):
+    directory = machine_directory(args)
+    commit, dirty = current_commit()
+    for path in results_of(directory, commit):
+        if ("-dirty-" in os.path.basename(path)) == dirty:
+            return path
+    print(f"error: no stored result for {commit[:12]}{' (dirty)' if dirty else ''}, use run first")
+    return None
+
+
+# statistics
+
+def median(values):
+    ordered = sorted(values)
+    n = len(ordered)
+    if n == 0:
+        return math.nan
+    return ordered[n // 2] if n % 2 else 0.5 * (ordered[n // 2 - 1] + ordered[n // 2])
+
+
+def drop_outliers(samples):
+    """samples the harness would keep, identical samples have no spread to judge by and are all kept"""
+    center = median(samples)
+    mad = median([abs(s - center) for s in samples])
+    if not mad > 0.0:
+        return samples
+    return [s for s in samples if abs(s - center) / (MAD_TO_SIGMA * mad) <= OUTLIER_THRESHOLD]
+
+
+def mann_whitney_exact(u, n1, n2):
+    """two sided p value from the exact distribution of U, counts[k] arrangements give U = k"""
+    counts = [[1] + [0] * (n1 * n2) for _ in range(n2 + 1)]
+    for i in range(1, n1 + 1):
+        previous = counts
+        counts = [[0] * (n1 * n2 + 1) for _ in range(n2 + 1)]
+        counts[0][0] = 1
+        for j in range(1, n2 + 1):
+            for k in range(i * j + 1):
+                # largest value from the first sample adds j to U, or from the second adds nothing
+                counts[j][k] = (previous[j][k - j] if k >= j else 0) + counts[j - 1][k]
+
+    total = math.comb(n1 + n2, n1)
+    tail = min(u, n1 * n2 - u)
+    p = 2.0 * sum(counts[n2][:int(tail) + 1]) / total
+    return min(p, 1.0)
+
+
+def mann_whitney(a, b):
+    """two sided p value of the Mann-Whitney U test, exact for small tie free samples,
+    otherwise normal approximation with tie and continuity correction"""
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return math.nan
+
+    # average ranks over ties
+    pooled = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    ranks = [0.0] * len(pooled)
+    ties = 0.0
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        rank = 0.5 * (i + j) + 1.0
+        for k in range(i, j + 1):
+            ranks[k] = rank
+        t = j - i + 1
+        ties += t ** 3 - t
+        i = j + 1
+
+    r1 = sum(rank for rank, (_, group) in zip(ranks, pooled) if group == 0)
+    u1 = r1 - n1 * (n1 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+
+    if ties == 0.0 and n1 * n2 <= EXACT_LIMIT:
+        return mann_whitney_exact(u1, n1, n2)
+
+    n = n1 + n2
+    variance = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)))
+    if variance <= 0.0:
+        return 1.0
+
+    z = (abs(u1 - mean) - 0.5) / math.sqrt(variance)
+    return math.erfc(max(z, 0.0) / math.sqrt(2.0))
+
+
+def compare(args, current_path):
+    baseline_path = pick_baseline(args, current_path)
+    if not baseline_path:
+        return 0 if not args.baseline else 2
+
+    current = load_record(current_path)
+    baseline = load_record(baseline_path)
+
+    print(f"baseline {baseline['commit'][:12]}{' (dirty)' if baseline.get('dirty') else ''} {baseline['date']}")
+    print(f"current  {current['commit'][:12]}{' (dirty)' if current.get('dirty') else ''} {current['date']}")
+    print(f"machine  {current['machine']['fingerprint']} {current['machine']['cpu']}, {current['machine']['cores']} cores")
+
+    # never compare across builds, picking filters by build already
+    if build_key(baseline) != build_key(current):
+        print(f"error: build differs, {describe_build(build_key(baseline))} -> {describe_build(build_key(current))}, not comparable")
+        return 2
+
+    ids = sorted(set(current["benchmarks"]) & set(baseline["benchmarks"]))
+    width = max([len(i) for i in ids] + [9])
+
+    print()
+    print(f"{'benchmark':<{width}}  {'baseline':>12}  {'current':>12}  {'delta':>8}  {'p':>7}  verdict")
+
+    regressions = 0
+    improvements = 0
+    for benchmark in ids:
+        old = baseline["benchmarks"][benchmark]
+        new = current["benchmarks"][benchmark]
+
+        old_median = median(old["samples_ns"]) if old["samples_ns"] else old["median_ns"]
+        new_median = median(new["samples_ns"]) if new["samples_ns"] else new["median_ns"]
+        delta = (new_median - old_median) / old_median * 100.0 if old_median > 0 else math.nan
+        p = mann_whitney(old["samples_ns"], new["samples_ns"])
+
+        # significant and large enough to matter, either alone is noise or a rounding error
+        verdict = ""
+        if p < args.alpha and abs(delta) > args.threshold:
+            if delta > 0:
+                verdict = "SLOWER"
+                regressions += 1
+            else:
+                verdict = "faster"
+                improvements += 1
+
+        print(f"{benchmark:<{width}}  {old_median:>12.1f}  {new_median:>12.1f}  {delta:>+7.1f}%  {p:>7.4f}  {verdict}")
+
+    missing = sorted(set(baseline["benchmarks"]) - set(current["benchmarks"]))
+    added = sorted(set(current["benchmarks"]) - set(baseline["benchmarks"]))
+
+    print()
+    print(f"{len(ids)} compared, {regressions} slower, {improvements} faster, {len(added)} new, {len(missing)} missing"
+          f" (threshold {args.threshold}%, alpha {args.alpha})")
+
+    return 1 if regressions else 0
+
+
+def set_baseline(args):
+    commit, _ = current_commit()
+    target = resolve_commit(args.commit) if args.commit else commit
+    directory = machine_directory(args)
+
+    if not results_of(directory, target):
+        print(f"error: no stored result for {target[:12]} on this machine")
+        return 2
+
+    with open(os.path.join(directory, BASELINE_FILE), "w") as f:
+        f.write(target + "\n")
+
+    print(f"baseline of {directory} is {target[:12]}")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="benchmark results per commit and machine, compared against a baseline")
+    parser.add_argument("command", choices=["run", "compare", "check", "baseline"])
+    parser.add_argument("commit", nargs="?", help="commit to mark as baseline")
+    parser.add_argument("--bin-dir", default="build", help="directory holding the built samples")
+    parser.add_argument("--results", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "results"))
+    parser.add_argument("--baseline", help="commit to compare against, default the stored BASELINE or the newest other result")
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent slowdown that fails the comparison")
+    parser.add_argument("--alpha", type=float, default=0.01, help="significance level of the Mann-Whitney U test")
+    parser.add_argument("--samples", type=int, help="samples per harness case, default from each benchmark")
+    parser.add_argument("--only", nargs="*", help="run only these executables")
+    parser.add_argument("--verbose", action="store_true", help="show benchmark output")
+    args = parser.parse_args()
+
+    if args.command == "baseline":
+        return set_baseline(args)
+
+    if args.command in ("run", "check"):
+        current_path = run_suite(args)
+        if not current_path:
+            return 2
+        if args.command == "run":
+            return 0
+    else:
+        current_path = pick_current(args)
+        if not current_path:
+            return 2
+
+    return compare(args, current_path)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
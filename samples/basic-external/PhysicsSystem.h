@@ -5,7 +5,6 @@
 #pragma once
 
 #include "ecs/systems/PhysicsSystem.h"
-#include "builtin/collision/collider/BoxCollider.h"
 #include "common/Components.h"
 
 namespace BulletEngine {
@@ -18,7 +17,6 @@ public:
 
 protected:
     bool beforeIntegrate(World& world, Entity entity, RigidBodyComponent& rigidBody, float dt) override;
-    void afterIntegrate(World& world, Entity entity, RigidBodyComponent& rigidBody, float dt) override;
 };
 
 } // namespace systems
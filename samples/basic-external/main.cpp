@@ -32,8 +32,12 @@
 // BulletEngine
 #include "ecs/Ecs.h"
 #include "ecs/systems/RenderSystem.h"
+#include "ecs/systems/TransformSystem.h"
 #include "ecs/systems/InputSystem.h"
 #include "ecs/systems/ImGuiSystem.h"
+#include "ecs/systems/ProfilerPanel.h"
+#include "ecs/systems/DebugDrawSystem.h"
+#include "rendering/SceneInstanceRenderer.h"
 
 // common
 #include "common/Components.h"
@@ -48,6 +52,7 @@ using namespace BulletEngine;
 
 using RenderSystem = ecs::systems::RenderSystemBase;
 using ImGuiSystem = ecs::systems::ImGuiSystemBase;
+using DebugDrawSystem = ecs::systems::DebugDrawSystemBase;
 
 // imgui display functions
 void setupDebugDisplay(ImGuiSystem& imgui, BulletRender::scene::Camera& camera, float& dt)
@@ -70,6 +75,57 @@ void setupDebugDisplay(ImGuiSystem& imgui, BulletRender::scene::Camera& camera,
     });
 }
 
+void setupDebugDrawDisplay(ImGuiSystem& imgui, DebugDrawSystem& debugDraw, ecs::World& world)
+{
+    // projectiles launch with hidden colliders, the box toggle shows them
+    imgui.add([&debugDraw, &world, synced = size_t(0)]() mutable {
+        ImGui::Begin("Debug Draw");
+
+        bool boxes = debugDraw.isEnabled(rendering::DebugCategory::COLLIDER_BOX);
+        if (ImGui::Checkbox("Collider boxes", &boxes))
+        {
+            debugDraw.setEnabled(rendering::DebugCategory::COLLIDER_BOX, boxes);
+            synced = 0;
+        }
+
+        // projectiles fired since last frame, all of them after a toggle
+        const auto& fired = objects::Projectile::fired;
+        for (; synced < fired.size(); synced++)
+        {
+            if (auto* collider = world.get<ecs::ColliderComponent>(fired[synced]))
+            {
+                collider->isVisible = boxes;
+            }
+        }
+
+        bool ground = debugDraw.isEnabled(rendering::DebugCategory::COLLIDER_GROUND);
+        if (ImGui::Checkbox("Ground collider", &ground))
+        {
+            debugDraw.setEnabled(rendering::DebugCategory::COLLIDER_GROUND, ground);
+        }
+
+        ImGui::Text("Lines: %zu", debugDraw.getDraw().getLastFrameLines());
+
+        ImGui::End();
+    });
+}
+
+void setupBatchDisplay(ImGuiSystem& imgui, RenderSystem& renderSystem, rendering::SceneInstanceRenderer& instanceRenderer)
+{
+    imgui.add([&renderSystem, &instanceRenderer]() {
+        ImGui::Begin("Batches");
+
+        const auto& stats = renderSystem.getBatchStats();
+        ImGui::Text("Instances: %zu", stats.instances);
+        ImGui::Text("Batches: %zu", stats.batches);
+        ImGui::Text("State changes: %zu", stats.stateChanges());
+        ImGui::Text("Scene objects: %zu", instanceRenderer.getObjectCount());
+        ImGui::Text("Scene rebuilds: %zu", instanceRenderer.getRebuilds());
+
+        ImGui::End();
+    });
+}
+
 void setupProjectileDisplay(ImGuiSystem& imgui, ecs::World& world, BulletPhysics::ballistics::external::PhysicsWorld& physicsWorld)
 {
     imgui.add([&world, &physicsWorld]() {
@@ -88,7 +144,7 @@ void setupProjectileDisplay(ImGuiSystem& imgui, ecs::World& world, BulletPhysics
         if (lastProjectile != 0)
         {
             auto* transform = world.get<ecs::TransformComponent>(lastProjectile);
-            auto pos = transform->transform.getPosition();
+            const auto& pos = transform->position;
 
             ImGui::Text("Position:");
             ImGui::Text("   X: %.3f", pos.x);
@@ -158,14 +214,26 @@ int main()
     auto fog = std::make_shared<BulletRender::render::Fog>(true, 10.0f, 90.0f);
     BulletRender::render::Renderer::registerPostPass(fog);
 
+    // shared models and shaders, outlives the world holding handles
+    assets::AssetCache assetCache;
+    objects::Projectile::assets = &assetCache;
+
     // ecs
     ecs::World world;
 
+    // renderables are batched by model and shader, batches drawn through the scene
+    rendering::SceneInstanceRenderer instanceRenderer(scene);
+
     // systems
-    RenderSystem renderSystem(scene);
+    RenderSystem renderSystem(instanceRenderer);
+    ecs::systems::TransformSystemBase transformSystem;
     ecs::systems::CollisionSystem collisionSystem;
     ecs::systems::TrajectorySystem trajectorySystem(lines);
 
+    // collider wireframes share the trajectory line pass, ground is already shown by the grid pass, boxes are off until toggled
+    DebugDrawSystem debugDrawSystem(lines);
+    debugDrawSystem.setEnabled(rendering::DebugCategory::COLLIDERS, false);
+
     // physics
     BulletPhysics::ballistics::external::PhysicsWorld physicsWorld;
     BulletPhysics::math::MidpointIntegrator integrator;
@@ -184,6 +252,8 @@ int main()
     auto groundObject = world.create();
     auto& groundCollider = world.add<ecs::ColliderComponent>(groundObject);
     groundCollider.collider = std::make_shared<BulletPhysics::builtin::collision::collider::GroundCollider>(0.0f);
+    groundCollider.layer = ecs::CollisionLayer::GROUND;
+    groundCollider.mask = ecs::CollisionLayer::PROJECTILE;
 
     // input
     ecs::systems::InputSystem inputSystem;
@@ -201,6 +271,12 @@ int main()
     ImGuiSystem imguiSystem;
     float lastDt = 0.0f;
     setupDebugDisplay(imguiSystem, camera, lastDt);
+
+    // frame profiler
+    ecs::systems::ProfilerPanel profilerPanel;
+    imguiSystem.add([&profilerPanel]() { profilerPanel.render(); });
+    setupDebugDrawDisplay(imguiSystem, debugDrawSystem, world);
+    setupBatchDisplay(imguiSystem, renderSystem, instanceRenderer);
     setupProjectileDisplay(imguiSystem, world, physicsWorld);
 
     // loop
@@ -216,9 +292,16 @@ int main()
             physicsSystem.update(world, dt);
             collisionSystem.update(world);
             trajectorySystem.update(world);
+            transformSystem.update(world);
 
+            trajectorySystem.render(world, camera.position());
+            debugDrawSystem.render(world, camera.position());
+            assetCache.update();
             renderSystem.render(world);
             imguiSystem.render();
+
+            core::Profiler::instance().endFrame();
+            core::AllocationTracker::instance().endFrame();
         }
     );
 
@@ -8,7 +8,7 @@ namespace BulletEngine {
 namespace ecs {
 namespace systems {
 
-void TerminalCollisionSystem::onCollision(World& world, Entity entityA, Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold)
+void TerminalCollisionSystem::onCollisionBegin(World& world, Entity entityA, Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold)
 {
     Entity targetEntity = 0;
     Entity projectileEntity = 0;
@@ -92,6 +92,7 @@ void TerminalCollisionSystem::onCollision(World& world, Entity entityA, Entity e
             {
                 projectileBody.setVelocity({0.0, 0.0, 0.0});
                 rigidBodyComponent->isGrounded = true;
+                rigidBodyComponent->isSleeping = true;
 
                 auto* impactState = world.get<ImpactStateComponent>(projectileEntity);
                 if (impactState)
@@ -106,6 +107,7 @@ void TerminalCollisionSystem::onCollision(World& world, Entity entityA, Entity e
         // no material, fallback (stop projectile)
         projectileBody.setVelocity({0.0, 0.0, 0.0});
         rigidBodyComponent->isGrounded = true;
+        rigidBodyComponent->isSleeping = true;
     }
 }
 
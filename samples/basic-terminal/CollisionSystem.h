@@ -18,7 +18,7 @@ public:
     using CollisionSystemBase::CollisionSystemBase;
 
 protected:
-    void onCollision(World& world, Entity entityA, Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold) override;
+    void onCollisionBegin(World& world, Entity entityA, Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold) override;
 };
 
 } // namespace systems
@@ -17,16 +17,12 @@ public:
     bool hasImpacted = false;
 };
 
-struct EnergyTrajectoryPoint {
-    BulletPhysics::math::Vec3 position;
-    double energy;
-};
-
 class EnergyTrajectoryComponent : public Component {
 public:
-    std::vector<EnergyTrajectoryPoint> points;
+    // points are recorded by EnergyTrajectorySystem
     double initialEnergy = 0.0;
-    double minSegment = 0.005;
+    double tolerance = 0.005;      // max deviation of dropped samples, m
+    double energyTolerance = 0.02; // max energy change along one segment, fraction of initial
 };
 
 } // namespace ecs
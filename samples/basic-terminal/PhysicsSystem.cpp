@@ -33,37 +33,12 @@ void PhysicsSystem::afterIntegrate(World& world, Entity entity, RigidBodyCompone
         return;
     }
 
-    // update orientation based on velocity
+    // keep orientation of first impact, ricochets and penetrations no longer follow velocity
     auto* impactState = world.get<ImpactStateComponent>(entity);
-    bool impacted = impactState && impactState->hasImpacted;
-
     auto* transformComponent = world.get<TransformComponent>(entity);
-    if (transformComponent && !impacted)
+    if (transformComponent && impactState && impactState->hasImpacted)
     {
-        const auto& v = rigidBody.body->getVelocity();
-        double velLen2 = v.x*v.x + v.y*v.y + v.z*v.z;
-
-        if (velLen2 > 1e-6)
-        {
-            transformComponent->transform.rotateFromDirection({0.0f, 1.0f, 0.0f}, {static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)});
-        }
-    }
-
-    // update box collider orientation
-    auto* colliderComponent = world.get<ColliderComponent>(entity);
-    if (colliderComponent && colliderComponent->collider && transformComponent)
-    {
-        if (colliderComponent->collider->getShape() == BulletPhysics::builtin::collision::collider::CollisionShape::Box)
-        {
-            auto* boxCollider = static_cast<BulletPhysics::builtin::collision::collider::BoxCollider*>(colliderComponent->collider.get());
-
-            const auto& mat = transformComponent->transform.getMatrix();
-            BulletPhysics::math::Vec3 axisX{mat[0].x, mat[0].y, mat[0].z};
-            BulletPhysics::math::Vec3 axisY{mat[1].x, mat[1].y, mat[1].z};
-            BulletPhysics::math::Vec3 axisZ{mat[2].x, mat[2].y, mat[2].z};
-
-            boxCollider->setAxes(axisX, axisY, axisZ);
-        }
+        transformComponent->alignAxis = glm::vec3{0.0f};
     }
 }
 
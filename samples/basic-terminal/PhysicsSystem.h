@@ -5,7 +5,6 @@
 #pragma once
 
 #include "ecs/systems/PhysicsSystem.h"
-#include "builtin/collision/collider/BoxCollider.h"
 #include "common/Components.h"
 #include "Components.h"
 
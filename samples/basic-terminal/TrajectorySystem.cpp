@@ -4,6 +4,8 @@
 
 #include "TrajectorySystem.h"
 
+#include "core/Profiler.h"
+
 namespace BulletEngine {
 namespace ecs {
 namespace systems {
@@ -40,19 +42,21 @@ glm::vec3 EnergyTrajectorySystem::energyToColor(float ratio)
 
 void EnergyTrajectorySystem::update(World& world)
 {
+    BE_PROFILE_SCOPE("trajectory/record");
+
     for (auto entity : world.entities())
     {
-        auto* transformComponent = world.get<TransformComponent>(entity);
         auto* trajectoryComponent = world.get<EnergyTrajectoryComponent>(entity);
         auto* rigidBodyComponent = world.get<ProjectileRigidBodyComponent>(entity);
 
-        if (!transformComponent || !trajectoryComponent || !rigidBodyComponent)
+        if (!trajectoryComponent || !rigidBodyComponent)
         {
             continue;
         }
 
-        auto pos = transformComponent->transform.getPosition();
-        BulletPhysics::math::Vec3 p{pos.x, pos.y, pos.z};
+        // body position, render transform is only written once per frame
+        const auto& position = rigidBodyComponent->body->getPosition();
+        glm::vec3 p{static_cast<float>(position.x), static_cast<float>(position.y), static_cast<float>(position.z)};
 
         // calculate current kinetic energy
         auto vel = rigidBodyComponent->body->getVelocity();
@@ -61,50 +65,47 @@ void EnergyTrajectorySystem::update(World& world)
         double energy = 0.5 * mass * speed * speed;
 
         // record initial energy on first point
-        if (trajectoryComponent->points.empty())
+        if (!m_buffer.last(entity))
         {
             trajectoryComponent->initialEnergy = energy;
         }
 
-        // check distance to last point
-        double distToLast = 0.0;
-        if (!trajectoryComponent->points.empty())
+        // color is fixed at record time, segments blend their end colors
+        double initE = trajectoryComponent->initialEnergy;
+        if (initE < 1e-9) initE = 1.0;
+
+        // energyToColor moves one channel by 2 per unit of ratio
+        rendering::SimplifyTolerance tolerance;
+        tolerance.distance = static_cast<float>(trajectoryComponent->tolerance);
+        tolerance.color = static_cast<float>(2.0 * trajectoryComponent->energyTolerance);
+
+        m_buffer.record(entity, p, energyToColor(static_cast<float>(energy / initE)), tolerance);
+    }
+}
+
+void EnergyTrajectorySystem::render(World& world, const glm::vec3& eye)
+{
+    BE_PROFILE_SCOPE("trajectory/render");
+
+    // tracks of live entities are kept also without lines, ending the frame drops the others
+    for (auto entity : world.entities())
+    {
+        if (!world.has<EnergyTrajectoryComponent>(entity))
         {
-            const auto& last = trajectoryComponent->points.back().position;
-            double dx = p.x - last.x;
-            double dy = p.y - last.y;
-            double dz = p.z - last.z;
-            distToLast = std::sqrt(dx * dx + dy * dy + dz * dz);
+            continue;
         }
 
-        if (trajectoryComponent->points.empty() || distToLast >= trajectoryComponent->minSegment)
+        if (m_lines)
         {
-            trajectoryComponent->points.push_back({p, energy});
+            m_buffer.emit(entity, *m_lines, eye, m_lodAngle);
         }
-
-        // render segments with energy-based color
-        if (trajectoryComponent->points.size() >= 2 && m_lines)
+        else
         {
-            double initE = trajectoryComponent->initialEnergy;
-            if (initE < 1e-9) initE = 1.0;
-
-            for (size_t i = 0; i + 1 < trajectoryComponent->points.size(); ++i)
-            {
-                const auto& a = trajectoryComponent->points[i];
-                const auto& b = trajectoryComponent->points[i + 1];
-
-                // average energy of segment endpoints for smooth color
-                double avgEnergy = (a.energy + b.energy) * 0.5;
-                float ratio = static_cast<float>(avgEnergy / initE);
-
-                glm::vec3 color = energyToColor(ratio);
-                glm::vec3 pa{static_cast<float>(a.position.x), static_cast<float>(a.position.y), static_cast<float>(a.position.z)};
-                glm::vec3 pb{static_cast<float>(b.position.x), static_cast<float>(b.position.y), static_cast<float>(b.position.z)};
-
-                m_lines->addLine(pa, pb, color);
-            }
+            m_buffer.keep(entity);
         }
     }
+
+    m_buffer.endFrame();
 }
 
 } // namespace systems
@@ -6,6 +6,7 @@
 
 #include "ecs/Ecs.h"
 #include "ecs/Components.h"
+#include "rendering/TrajectoryBuffer.h"
 #include "render/passes/Lines.h"
 #include "common/Components.h"
 #include "Components.h"
@@ -20,15 +21,27 @@ namespace systems {
 
 class EnergyTrajectorySystem {
 public:
-    explicit EnergyTrajectorySystem(std::shared_ptr<BulletRender::render::Lines> lines) : m_lines(std::move(lines)) {}
+    static constexpr float DEFAULT_LOD_ANGLE = 0.002f;
 
+    explicit EnergyTrajectorySystem(std::shared_ptr<BulletRender::render::Lines> lines, size_t maxPoints = rendering::TrajectoryBuffer::DEFAULT_MAX_POINTS) : m_lines(lines ? std::make_shared<rendering::LinesAdapter>(std::move(lines)) : nullptr), m_buffer(maxPoints) {}
+    explicit EnergyTrajectorySystem(std::shared_ptr<rendering::LineSink> lines, size_t maxPoints = rendering::TrajectoryBuffer::DEFAULT_MAX_POINTS) : m_lines(std::move(lines)), m_buffer(maxPoints) {}
+
+    // record positions, cheap enough for every physics substep
     void update(World& world);
 
+    // emit recorded trajectories, once per rendered frame, detail falls off with distance to eye
+    void render(World& world, const glm::vec3& eye);
+
+    // angle in radians a segment must span to be drawn, 0 draws every kept point
+    void setLodAngle(float lodAngle) { m_lodAngle = lodAngle; }
+
 private:
     // red (full energy) -> orange -> yellow -> green (zero energy)
     static glm::vec3 energyToColor(float ratio);
 
-    std::shared_ptr<BulletRender::render::Lines> m_lines;
+    std::shared_ptr<rendering::LineSink> m_lines;
+    rendering::TrajectoryBuffer m_buffer;
+    float m_lodAngle = DEFAULT_LOD_ANGLE;
 };
 
 } // namespace systems
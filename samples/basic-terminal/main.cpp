@@ -32,8 +32,10 @@
 // BulletEngine
 #include "ecs/Ecs.h"
 #include "ecs/systems/RenderSystem.h"
+#include "ecs/systems/TransformSystem.h"
 #include "ecs/systems/InputSystem.h"
 #include "ecs/systems/ImGuiSystem.h"
+#include "ecs/systems/ProfilerPanel.h"
 
 // common
 #include "common/Components.h"
@@ -175,7 +177,7 @@ void createWall(ecs::World& world, const BulletPhysics::math::Vec3& position, co
     ecs::Entity entity = world.create();
 
     auto& transform = world.add<ecs::TransformComponent>(entity);
-    transform.transform.setPosition({position.x, position.y, position.z});
+    transform.position = {static_cast<float>(position.x), static_cast<float>(position.y), static_cast<float>(position.z)};
 
     auto& renderable = world.add<ecs::RenderableComponent>(entity);
     renderable.model = new BulletRender::scene::Box(size.x, size.y, size.z);
@@ -187,6 +189,10 @@ void createWall(ecs::World& world, const BulletPhysics::math::Vec3& position, co
     boxCollider->setPosition(position);
     boxCollider->setMaterial(material);
     colliderComp.collider = boxCollider;
+
+    // walls only interact with projectiles
+    colliderComp.layer = ecs::CollisionLayer::STATIC;
+    colliderComp.mask = ecs::CollisionLayer::PROJECTILE;
 }
 
 int main()
@@ -231,11 +237,16 @@ int main()
     auto fog = std::make_shared<BulletRender::render::Fog>(true, 10.0f, 90.0f);
     BulletRender::render::Renderer::registerPostPass(fog);
 
+    // shared models and shaders, outlives the world holding handles
+    assets::AssetCache assetCache;
+    objects::Projectile::assets = &assetCache;
+
     // ecs
     ecs::World world;
 
     // systems
     RenderSystem renderSystem(scene);
+    ecs::systems::TransformSystemBase transformSystem;
     ecs::systems::TerminalCollisionSystem collisionSystem;
     ecs::systems::EnergyTrajectorySystem trajectorySystem(lines);
 
@@ -256,6 +267,8 @@ int main()
     auto ground = std::make_shared<BulletPhysics::builtin::collision::collider::GroundCollider>(0.0f);
     ground->setMaterial(BulletPhysics::ballistics::terminal::materials::Soil());
     groundCollider.collider = ground;
+    groundCollider.layer = ecs::CollisionLayer::GROUND;
+    groundCollider.mask = ecs::CollisionLayer::PROJECTILE;
 
     // shared shader for walls
     auto wallShader = std::make_shared<BulletRender::render::Shader>(
@@ -314,6 +327,10 @@ int main()
     ImGuiSystem imguiSystem;
     float lastDt = 0.0f;
     setupDebugDisplay(imguiSystem, camera, lastDt);
+
+    // frame profiler
+    ecs::systems::ProfilerPanel profilerPanel;
+    imguiSystem.add([&profilerPanel]() { profilerPanel.render(); });
     setupProjectileDisplay(imguiSystem, world);
 
     // loop
@@ -331,13 +348,21 @@ int main()
             int steps = static_cast<int>(dt / PHYSICS_DT);
             for (int i = 0; i < steps; ++i)
             {
+                BE_PROFILE_SCOPE("substep");
                 physicsSystem.update(world, PHYSICS_DT);
                 collisionSystem.update(world);
                 trajectorySystem.update(world);
             }
 
+            transformSystem.update(world);
+
+            trajectorySystem.render(world, camera.position());
+            assetCache.update();
             renderSystem.render(world);
             imguiSystem.render();
+
+            core::Profiler::instance().endFrame();
+            core::AllocationTracker::instance().endFrame();
         }
     );
 
@@ -0,0 +1,176 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+// BulletPhysics
+#include "builtin/collision/collider/BoxCollider.h"
+#include "builtin/collision/collider/GroundCollider.h"
+#include "geography/CoordinateMapping.h"
+
+// BulletEngine
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "ecs/systems/CollisionSystem.h"
+#include "core/Profiler.h"
+#include "core/ThreadPool.h"
+
+using namespace BulletEngine;
+
+// exit file
+static constexpr std::string_view FILE_NAME = "collision.csv";
+
+// scene parameters
+static constexpr int PROJECTILE_COUNT = 20000;
+static constexpr int WALL_COUNT = 64;
+static constexpr double WALL_SPACING = 2.0;
+
+// measurement params
+static constexpr int WARMUP_UPDATES = 3;
+static constexpr int MEASURE_UPDATES = 20;
+
+// counts contacts and hashes delivery order
+class CountingCollisionSystem : public ecs::systems::CollisionSystemBase {
+public:
+    using CollisionSystemBase::CollisionSystemBase;
+
+    void reset()
+    {
+        contacts = 0;
+        orderHash = 1469598103934665603ull;
+    }
+
+    size_t contacts = 0;
+    uint64_t orderHash = 0;
+
+protected:
+    void onCollision(ecs::World&, ecs::Entity entityA, ecs::Entity entityB, const BulletPhysics::builtin::collision::Manifold&) override
+    {
+        contacts++;
+
+        // fnv-1a over entity sequence
+        orderHash = (orderHash ^ entityA) * 1099511628211ull;
+        orderHash = (orderHash ^ entityB) * 1099511628211ull;
+    }
+};
+
+static void buildRange(ecs::World& world)
+{
+    using namespace BulletPhysics::builtin::collision::collider;
+
+    // ground
+    auto ground = world.create();
+    auto& groundCollider = world.add<ecs::ColliderComponent>(ground);
+    groundCollider.collider = std::make_shared<GroundCollider>(0.0f);
+    groundCollider.layer = ecs::CollisionLayer::GROUND;
+    groundCollider.mask = ecs::CollisionLayer::PROJECTILE;
+
+    // row of walls
+    for (int i = 0; i < WALL_COUNT; ++i)
+    {
+        auto wall = world.create();
+        auto& collider = world.add<ecs::ColliderComponent>(wall);
+        auto box = std::make_shared<BoxCollider>(BulletPhysics::math::Vec3{0.05, 3.0, 1.5});
+        box->setPosition({5.0 + i * WALL_SPACING, 1.5, 0.0});
+        collider.collider = box;
+        collider.layer = ecs::CollisionLayer::STATIC;
+        collider.mask = ecs::CollisionLayer::PROJECTILE;
+    }
+
+    // projectiles spread along the walls, some of them touching
+    for (int i = 0; i < PROJECTILE_COUNT; ++i)
+    {
+        auto projectile = world.create();
+        auto& collider = world.add<ecs::ColliderComponent>(projectile);
+        auto box = std::make_shared<BoxCollider>(BulletPhysics::math::Vec3{0.00762, 0.0253, 0.00762});
+        double x = 5.0 + (i % (WALL_COUNT * 8)) * (WALL_SPACING / 8.0);
+        double y = 0.005 + (i % 97) * 0.03;
+        box->setPosition({x, y, 0.0});
+        collider.collider = box;
+        collider.layer = ecs::CollisionLayer::PROJECTILE;
+        collider.mask = ecs::CollisionLayer::ALL & ~ecs::CollisionLayer::PROJECTILE;
+    }
+}
+
+int main()
+{
+    // nothing drains the profiler here, full rings would turn every scope into a contended drop count
+    core::Profiler::instance().setEnabled(false);
+
+    BulletPhysics::geography::CoordinateMapping::set(BulletPhysics::geography::mappings::OpenGL());
+
+    ecs::World world;
+    buildRange(world);
+
+    // 1, 2, 4, ... up to all cores
+    std::vector<size_t> threadCounts;
+    size_t maxThreads = core::ThreadPool::defaultThreadCount();
+    for (size_t t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    std::cout << "colliders: " << world.entities().size() << ", threads: 1.." << maxThreads << "\n";
+
+    std::ofstream file(FILE_NAME.data());
+    file << "threads,rep,contacts,update_ns\n";
+
+    double baselineNs = 0.0;
+    uint64_t baselineHash = 0;
+
+    for (size_t threads : threadCounts)
+    {
+        core::ThreadPool pool(threads);
+        CountingCollisionSystem collisionSystem(&pool);
+
+        for (int i = 0; i < WARMUP_UPDATES; ++i)
+            collisionSystem.update(world);
+
+        std::vector<long long> samples;
+        samples.reserve(MEASURE_UPDATES);
+
+        for (int rep = 0; rep < MEASURE_UPDATES; ++rep)
+        {
+            collisionSystem.reset();
+
+            auto t0 = std::chrono::high_resolution_clock::now();
+            collisionSystem.update(world);
+            auto t1 = std::chrono::high_resolution_clock::now();
+
+            long long updateNs = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+            samples.push_back(updateNs);
+
+            file << threads << "," << rep << "," << collisionSystem.contacts << "," << updateNs << "\n";
+        }
+
+        std::sort(samples.begin(), samples.end());
+        double medianNs = static_cast<double>(samples[samples.size() / 2]);
+
+        if (threads == 1)
+        {
+            baselineNs = medianNs;
+            baselineHash = collisionSystem.orderHash;
+        }
+
+        double speedup = baselineNs / medianNs;
+        bool deterministic = collisionSystem.orderHash == baselineHash;
+
+        // colliders without bodies are never resting, every update must reach the narrowphase
+        if (collisionSystem.contacts == 0)
+        {
+            std::cout << "error: no contacts with " << threads << " threads, narrowphase did not run\n";
+            return 1;
+        }
+
+        std::cout << threads << " threads: median " << medianNs / 1e6 << " ms, speedup " << speedup << "x, efficiency " << speedup / threads << ", contacts " << collisionSystem.contacts << (deterministic ? "" : ", ORDER MISMATCH") << "\n";
+    }
+
+    std::cout << "done " << FILE_NAME << "\n";
+
+    return 0;
+}
@@ -0,0 +1,258 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// BulletEngine
+#include "core/AllocationTracker.h"
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "bench/Harness.h"
+
+using namespace BulletEngine;
+
+// exit files, ecs-<entities>.json and ecs-<entities>.csv
+static constexpr std::string_view FILE_NAME = "ecs";
+
+// scene sizes, one harness run each so only one world size is alive at a time
+static constexpr size_t ENTITY_COUNTS[] = {1000, 10000, 100000, 1000000};
+
+// mutations and destroys touch this many entities per sample
+static constexpr size_t BATCH = 1000;
+
+// mix of a range scene: 6 in 10 flying projectiles, 2 static walls, 2 grounded bodies
+enum class Kind { PROJECTILE, WALL, GROUNDED };
+
+static Kind kindOf(size_t index)
+{
+    size_t slot = index % 10;
+    return slot < 6 ? Kind::PROJECTILE : slot < 8 ? Kind::WALL : Kind::GROUNDED;
+}
+
+static ecs::Entity spawn(ecs::World& world, Kind kind)
+{
+    auto entity = world.create();
+
+    world.add<ecs::TransformComponent>(entity);
+    world.add<ecs::RenderableComponent>(entity);
+
+    if (kind != Kind::WALL)
+    {
+        auto& rigidBody = world.add<ecs::RigidBodyComponent>(entity);
+        rigidBody.isSleeping = kind == Kind::GROUNDED;
+    }
+
+    if (kind != Kind::GROUNDED)
+    {
+        auto& collider = world.add<ecs::ColliderComponent>(entity);
+        collider.layer = kind == Kind::PROJECTILE ? ecs::CollisionLayer::PROJECTILE : ecs::CollisionLayer::STATIC;
+    }
+
+    return entity;
+}
+
+static void populate(ecs::World& world, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        spawn(world, kindOf(i));
+}
+
+// loop of PhysicsSystemBase::update without the integration
+static size_t physicsPass(ecs::World& world)
+{
+    size_t awake = 0;
+    for (auto entity : world.entities())
+    {
+        auto* rigidBodyComponent = world.get<ecs::RigidBodyComponent>(entity);
+        if (!rigidBodyComponent || !rigidBodyComponent->body || rigidBodyComponent->isSleeping)
+            continue;
+
+        bench::doNotOptimize(rigidBodyComponent->body.get());
+        awake++;
+    }
+    return awake;
+}
+
+// loop of RenderSystemBase::extract without building instances
+static size_t renderPass(ecs::World& world)
+{
+    size_t drawn = 0;
+    for (auto entity : world.entities())
+    {
+        auto* transformComponent = world.get<ecs::TransformComponent>(entity);
+        if (!transformComponent)
+            continue;
+
+        auto* renderableComponent = world.get<ecs::RenderableComponent>(entity);
+        if (!renderableComponent)
+            continue;
+
+        bench::doNotOptimize(transformComponent);
+        drawn++;
+    }
+    return drawn;
+}
+
+// false if allocations are not counted, the memory numbers would be zero
+static bool addCases(bench::Harness& harness, size_t count)
+{
+    std::string entities = std::to_string(count);
+    size_t batch = std::min(count, BATCH);
+
+    // memory of a populated world, measured once through the counting operator new linked into this benchmark
+    auto& tracker = core::AllocationTracker::instance();
+    int64_t liveBefore = tracker.getLiveBytes();
+    uint64_t allocationsBefore = tracker.getAllocations();
+    auto measured = std::make_unique<ecs::World>();
+    populate(*measured, count);
+    double bytesPerEntity = static_cast<double>(tracker.getLiveBytes() - liveBefore) / static_cast<double>(count);
+    double allocationsPerEntity = static_cast<double>(tracker.getAllocations() - allocationsBefore) / static_cast<double>(count);
+    measured.reset();
+
+    if (tracker.getAllocations() == allocationsBefore)
+    {
+        std::cout << "error: allocations not counted, operator new is not replaced\n";
+        return false;
+    }
+
+    std::cout << entities << " entities: " << bytesPerEntity << " bytes/entity, " << allocationsPerEntity << " allocations/entity\n";
+
+    // world the read only cases share, lookups in shuffled order like scattered gameplay queries
+    auto world = std::make_shared<ecs::World>();
+    populate(*world, count);
+
+    auto order = std::make_shared<std::vector<ecs::Entity>>(world->entities());
+    std::shuffle(order->begin(), order->end(), std::mt19937(12345));
+
+    // mutations start from a fresh world every sample
+    auto scratch = std::make_shared<std::unique_ptr<ecs::World>>();
+
+    harness.add("create", {{"entities", entities}}, [scratch, count](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                for (size_t e = 0; e < count; ++e)
+                    (*scratch)->create();
+        })
+        .withSetup([scratch]() { *scratch = std::make_unique<ecs::World>(); })
+        .withIterations(1)
+        .withItems(static_cast<double>(count));
+
+    harness.add("populate", {{"entities", entities}}, [scratch, count](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                populate(**scratch, count);
+        })
+        .withSetup([scratch]() { *scratch = std::make_unique<ecs::World>(); })
+        .withIterations(1)
+        .withItems(static_cast<double>(count))
+        .withMetric("bytes_per_entity", bytesPerEntity)
+        .withMetric("allocations_per_entity", allocationsPerEntity);
+
+    harness.add("add", {{"entities", entities}}, [scratch](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                for (auto entity : (*scratch)->entities())
+                    (*scratch)->add<ecs::TransformComponent>(entity);
+        })
+        .withSetup([scratch, count]() {
+            *scratch = std::make_unique<ecs::World>();
+            for (size_t e = 0; e < count; ++e)
+                (*scratch)->create();
+        })
+        .withIterations(1)
+        .withItems(static_cast<double>(count));
+
+    // destroys a batch of random entities from a world of its own, setup respawns as many so it keeps its size
+    auto churn = std::make_shared<ecs::World>();
+    populate(*churn, count);
+    auto victims = std::make_shared<std::vector<ecs::Entity>>();
+    auto rng = std::make_shared<std::mt19937>(54321);
+
+    harness.add("destroy", {{"entities", entities}}, [churn, victims](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                for (auto entity : *victims)
+                    churn->destroy(entity);
+        })
+        .withSetup([churn, victims, rng, batch]() {
+            for (size_t i = 0; i < victims->size(); ++i)
+                spawn(*churn, kindOf(i));
+
+            const auto& alive = churn->entities();
+            victims->clear();
+            std::sample(alive.begin(), alive.end(), std::back_inserter(*victims), batch, *rng);
+        })
+        .withIterations(1)
+        .withItems(static_cast<double>(batch));
+
+    harness.add("get", {{"entities", entities}}, [world, order](uint64_t iterations) {
+            size_t index = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                bench::doNotOptimize(world->get<ecs::RigidBodyComponent>((*order)[index]));
+                index = index + 1 < order->size() ? index + 1 : 0;
+            }
+        });
+
+    harness.add("has", {{"entities", entities}}, [world, order](uint64_t iterations) {
+            size_t index = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                bench::doNotOptimize(world->has<ecs::ColliderComponent>((*order)[index]));
+                index = index + 1 < order->size() ? index + 1 : 0;
+            }
+        });
+
+    // full sweeps, per entity visited
+    harness.add("iterate-physics", {{"entities", entities}}, [world](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                bench::doNotOptimize(physicsPass(*world));
+        })
+        .withItems(static_cast<double>(count));
+
+    harness.add("iterate-render", {{"entities", entities}}, [world](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                bench::doNotOptimize(renderPass(*world));
+        })
+        .withItems(static_cast<double>(count));
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    size_t maxEntities = ENTITY_COUNTS[std::size(ENTITY_COUNTS) - 1];
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--max-entities") maxEntities = std::strtoull(argv[i + 1], nullptr, 10);
+    }
+
+    bench::Harness::Config defaults;
+    defaults.samples = 11;
+    defaults.output = FILE_NAME;
+
+    for (size_t count : ENTITY_COUNTS)
+    {
+        if (count > maxEntities)
+            break;
+
+        auto config = bench::Harness::parseArgs(argc, argv, defaults);
+        if (!config.output.empty())
+            config.output += "-" + std::to_string(count);
+
+        bench::Harness harness(config);
+        if (!addCases(harness, count))
+            return 1;
+
+        harness.run();
+    }
+
+    return 0;
+}
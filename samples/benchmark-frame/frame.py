@@ -0,0 +1,43 @@
+import pandas as pd
+import matplotlib.pyplot as plt
+
+WEIGHT = 600
+FONT_SIZE = 11
+TICK_SIZE = 11
+
+plt.rcParams.update({
+    "font.weight": WEIGHT,
+    "axes.labelweight": WEIGHT,
+    "axes.titleweight": WEIGHT,
+    "axes.labelsize": FONT_SIZE,
+    "xtick.labelsize": TICK_SIZE,
+    "ytick.labelsize": TICK_SIZE,
+})
+
+STAGES = ["physics", "collision", "trajectory", "transforms", "trajectory-render", "render"]
+
+frames = pd.read_csv("data/frame.csv")
+summary = pd.read_csv("data/frame-summary.csv")
+
+for _, row in summary.iterrows():
+    print(f"{row['system']:>18} | median {row['median_ns'] / 1e6:.3f} ms | 95% {row['ci_low_ns'] / 1e6:.3f}..{row['ci_high_ns'] / 1e6:.3f} ms | {row['allocations_per_frame']:.1f} allocations/frame")
+
+fig, (top, bottom) = plt.subplots(2, 1, figsize=(10, 7), sharex=True)
+
+# stacked stage cost per frame
+top.stackplot(frames["frame"], [frames[f"{stage}_ns"] / 1e6 for stage in STAGES], labels=STAGES, zorder=3)
+top.set_ylabel("Frame cost [ms]")
+top.grid(True, alpha=0.35, linewidth=1.0, zorder=0)
+top.legend(loc="upper right", fontsize=8)
+
+bottom.plot(frames["frame"], frames["total_allocations"], color="#F94144")
+bottom.set_xlabel("Frame")
+bottom.set_ylabel("Allocations")
+bottom.grid(True, alpha=0.35, linewidth=1.0)
+
+for ax in (top, bottom):
+    for tick in ax.get_xticklabels() + ax.get_yticklabels():
+        tick.set_fontweight(WEIGHT)
+
+plt.tight_layout()
+plt.show()
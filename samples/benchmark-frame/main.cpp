@@ -0,0 +1,356 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// linux
+#include <sys/resource.h>
+
+// BulletPhysics
+#include "math/Integrator.h"
+#include "builtin/collision/collider/BoxCollider.h"
+#include "builtin/collision/collider/GroundCollider.h"
+#include "ballistics/external/PhysicsWorld.h"
+#include "ballistics/external/environments/Atmosphere.h"
+#include "ballistics/external/environments/Humidity.h"
+#include "ballistics/external/forces/Gravity.h"
+#include "ballistics/external/forces/drag/Drag.h"
+#include "ballistics/terminal/Material.h"
+#include "geography/CoordinateMapping.h"
+
+// BulletEngine
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "ecs/systems/RenderSystem.h"
+#include "ecs/systems/TransformSystem.h"
+#include "core/AllocationTracker.h"
+#include "core/Profiler.h"
+#include "core/ThreadPool.h"
+#include "rendering/NullBackend.h"
+#include "assets/AssetCache.h"
+#include "bench/Statistics.h"
+#include "common/Components.h"
+#include "common/objects/Projectile.h"
+
+// terminal ballistics systems, shared with basic-terminal
+#include "basic-terminal/Components.h"
+#include "basic-terminal/CollisionSystem.h"
+#include "basic-terminal/PhysicsSystem.h"
+#include "basic-terminal/TrajectorySystem.h"
+
+using namespace BulletEngine;
+
+// exit files, frame.csv per frame and frame-summary.csv per system
+static constexpr std::string_view FILE_NAME = "frame";
+
+// simulation parameters, same steps as basic-terminal
+static constexpr float PHYSICS_DT = 0.001f;
+static constexpr float FRAME_DT = 1.0f / 60.0f;
+static constexpr double WALL_SPACING = 10.0;
+static constexpr double OUTLIER_THRESHOLD = 3.5;
+
+// profiler scopes are part of the measured frame when compiled in, drained every frame like the samples do
+#ifdef BULLET_ENGINE_PROFILE
+static constexpr bool PROFILED = true;
+#else
+static constexpr bool PROFILED = false;
+#endif
+
+// first frames fill buffers and caches, left out of the summary
+static constexpr size_t WARMUP_FRAMES = 30;
+
+// frame stages in order, each timed and counted as one allocation tag
+enum Stage { PHYSICS, COLLISION, TRAJECTORY, TRANSFORMS, TRAJECTORY_RENDER, RENDER, STAGE_COUNT };
+
+static constexpr const char* STAGE_NAMES[STAGE_COUNT] = {"physics", "collision", "trajectory", "transforms", "trajectory-render", "render"};
+static constexpr const char* STAGE_TAGS[STAGE_COUNT] = {"frame/physics", "frame/collision", "frame/trajectory", "frame/transforms", "frame/trajectory-render", "frame/render"};
+
+struct FrameCost {
+    long long ns[STAGE_COUNT] = {};
+    long long totalNs = 0;
+    uint64_t allocations[STAGE_COUNT] = {};
+    uint64_t bytes[STAGE_COUNT] = {};
+    uint64_t totalAllocations = 0;
+    size_t instances = 0;
+    size_t segments = 0;
+};
+
+// times a stage into the frame and tags its allocations
+class StageTimer {
+public:
+    StageTimer(FrameCost& cost, Stage stage, uint32_t tag) : m_cost(cost), m_stage(stage), m_scope(tag), m_start(std::chrono::steady_clock::now()) {}
+    ~StageTimer() { m_cost.ns[m_stage] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count(); }
+
+private:
+    FrameCost& m_cost;
+    Stage m_stage;
+    core::AllocationScope m_scope;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+static void buildRange(ecs::World& world, assets::AssetCache& assetCache, int walls)
+{
+    using namespace BulletPhysics::builtin::collision::collider;
+    using namespace BulletPhysics::ballistics::terminal;
+
+    auto groundObject = world.create();
+    auto& groundCollider = world.add<ecs::ColliderComponent>(groundObject);
+    auto ground = std::make_shared<GroundCollider>(0.0f);
+    ground->setMaterial(materials::Soil());
+    groundCollider.collider = ground;
+    groundCollider.layer = ecs::CollisionLayer::GROUND;
+    groundCollider.mask = ecs::CollisionLayer::PROJECTILE;
+
+    // rows of wood, concrete and steel across the whole fan
+    const Material wallMaterials[] = {materials::Wood(), materials::Concrete(), materials::Steel()};
+    const BulletPhysics::math::Vec3 size{0.05, 3.0, 40.0};
+
+    for (int i = 0; i < walls; ++i)
+    {
+        BulletPhysics::math::Vec3 position{20.0 + i * WALL_SPACING, 1.5, 0.0};
+        auto entity = world.create();
+
+        auto& transform = world.add<ecs::TransformComponent>(entity);
+        transform.position = {static_cast<float>(position.x), static_cast<float>(position.y), static_cast<float>(position.z)};
+
+        auto& renderable = world.add<ecs::RenderableComponent>(entity);
+        renderable.asset = assetCache.box(static_cast<float>(size.x), static_cast<float>(size.y), static_cast<float>(size.z));
+
+        auto& collider = world.add<ecs::ColliderComponent>(entity);
+        auto box = std::make_shared<BoxCollider>(size);
+        box->setPosition(position);
+        box->setMaterial(wallMaterials[i % 3]);
+        collider.collider = box;
+        collider.layer = ecs::CollisionLayer::STATIC;
+        collider.mask = ecs::CollisionLayer::PROJECTILE;
+    }
+}
+
+// fan of shots across the walls, as fired in basic-terminal
+static void launchAll(ecs::World& world, int projectiles)
+{
+    for (int i = 0; i < projectiles; ++i)
+    {
+        auto specs = BulletPhysics::projectile::ProjectileSpecs::create(0.01, 0.00762)
+            .withDragModel(BulletPhysics::ballistics::external::forces::drag::DragCurveModel::G7)
+            .withMuzzle(300.0 + (i % 16) * 25.0, BulletPhysics::projectile::Direction::RIGHT, 12.0);
+
+        double elevation = 0.5 + ((i / 16) % 16) * 0.25;
+        double azimuth = 90.0 + ((i % 16) - 8) * 0.5;
+
+        auto entity = objects::Projectile::launch(world, specs, {0.0, 1.5, 0.0}, elevation, azimuth);
+        world.add<ecs::EnergyTrajectoryComponent>(entity);
+        world.add<ecs::ImpactStateComponent>(entity);
+    }
+}
+
+static long long peakRssKb()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+int main(int argc, char** argv)
+{
+    int projectiles = 1000;
+    int walls = 32;
+    double duration = 5.0;
+    size_t threads = 1;
+    std::string output(FILE_NAME);
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--projectiles") projectiles = std::atoi(argv[i + 1]);
+        else if (arg == "--walls") walls = std::atoi(argv[i + 1]);
+        else if (arg == "--duration") duration = std::strtod(argv[i + 1], nullptr);
+        else if (arg == "--threads") threads = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (arg == "--out") output = argv[i + 1];
+    }
+
+    BulletPhysics::geography::CoordinateMapping::set(BulletPhysics::geography::mappings::OpenGL());
+
+    // null backends, model files are read but not parsed or uploaded
+    auto lines = std::make_shared<rendering::NullLines>();
+    rendering::NullInstanceRenderer instanceRenderer;
+
+    assets::AssetCache assetCache(false);
+    objects::Projectile::assets = &assetCache;
+
+    // ecs
+    ecs::World world;
+    buildRange(world, assetCache, walls);
+    launchAll(world, projectiles);
+
+    // systems, collision narrowphase on the pool when threads > 1
+    core::ThreadPool pool(threads);
+    ecs::systems::RenderSystemBase renderSystem(instanceRenderer);
+    ecs::systems::TransformSystemBase transformSystem;
+    ecs::systems::TerminalCollisionSystem collisionSystem(threads > 1 ? &pool : nullptr);
+    ecs::systems::EnergyTrajectorySystem trajectorySystem(lines);
+
+    // physics
+    BulletPhysics::ballistics::external::PhysicsWorld physicsWorld;
+    BulletPhysics::math::RK4Integrator integrator;
+    ecs::systems::PhysicsSystem physicsSystem(physicsWorld, integrator);
+
+    physicsWorld.addForce(std::make_unique<BulletPhysics::ballistics::external::forces::Gravity>());
+    physicsWorld.addEnvironment(std::make_unique<BulletPhysics::ballistics::external::environments::Atmosphere>(280.0f, 100000.0f));
+    physicsWorld.addEnvironment(std::make_unique<BulletPhysics::ballistics::external::environments::Humidity>(60));
+    physicsWorld.addForce(std::make_unique<BulletPhysics::ballistics::external::forces::Drag>());
+
+    // stage tags, allocations of nested engine scopes count for the stage around them
+    auto& tracker = core::AllocationTracker::instance();
+    uint32_t tags[STAGE_COUNT];
+    for (int s = 0; s < STAGE_COUNT; ++s)
+        tags[s] = tracker.registerTag(STAGE_TAGS[s]);
+
+    // setup allocations stay out of the first frame
+    tracker.endFrame();
+
+    const glm::vec3 eye{0.0f, 3.0f, 8.0f};
+    const int steps = static_cast<int>(FRAME_DT / PHYSICS_DT);
+    const size_t frames = static_cast<size_t>(duration / FRAME_DT);
+
+    std::cout << "projectiles: " << projectiles << ", walls: " << walls << ", threads: " << pool.size() << ", frames: " << frames << " (" << duration << " s simulated), profiler " << (PROFILED ? "on" : "compiled out") << "\n";
+
+    std::vector<FrameCost> costs(frames);
+    std::vector<core::AllocationTracker::TagStats> stats;
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        auto& cost = costs[frame];
+        auto frameStart = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < steps; ++i)
+        {
+            {
+                StageTimer timer(cost, PHYSICS, tags[PHYSICS]);
+                physicsSystem.update(world, PHYSICS_DT);
+            }
+            {
+                StageTimer timer(cost, COLLISION, tags[COLLISION]);
+                collisionSystem.update(world);
+            }
+            {
+                StageTimer timer(cost, TRAJECTORY, tags[TRAJECTORY]);
+                trajectorySystem.update(world);
+            }
+        }
+
+        {
+            StageTimer timer(cost, TRANSFORMS, tags[TRANSFORMS]);
+            transformSystem.update(world);
+        }
+        {
+            StageTimer timer(cost, TRAJECTORY_RENDER, tags[TRAJECTORY_RENDER]);
+            trajectorySystem.render(world, eye);
+        }
+        {
+            StageTimer timer(cost, RENDER, tags[RENDER]);
+            assetCache.update();
+            renderSystem.render(world);
+        }
+
+        cost.totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frameStart).count();
+        cost.instances = instanceRenderer.getLastFrameInstances();
+        cost.segments = lines->segments().size();
+
+        lines->endFrame();
+        instanceRenderer.endFrame();
+        core::Profiler::instance().endFrame();
+
+        // stats are in tag id order
+        tracker.endFrame();
+        tracker.stats(stats);
+        for (int s = 0; s < STAGE_COUNT; ++s)
+        {
+            cost.allocations[s] = stats[tags[s]].allocations;
+            cost.bytes[s] = stats[tags[s]].bytes;
+        }
+        for (const auto& tag : stats)
+            cost.totalAllocations += tag.selfAllocations;
+    }
+
+    long long rssKb = peakRssKb();
+
+    // every frame, for plots over time
+    std::ofstream file(output + ".csv");
+    file << "frame";
+    for (const char* name : STAGE_NAMES)
+        file << "," << name << "_ns";
+    file << ",total_ns";
+    for (const char* name : STAGE_NAMES)
+        file << "," << name << "_allocations";
+    file << ",total_allocations,instances,segments\n";
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        const auto& cost = costs[frame];
+        file << frame;
+        for (long long ns : cost.ns)
+            file << "," << ns;
+        file << "," << cost.totalNs;
+        for (uint64_t allocations : cost.allocations)
+            file << "," << allocations;
+        file << "," << cost.totalAllocations << "," << cost.instances << "," << cost.segments << "\n";
+    }
+
+    // per stage after warmup, same id and time columns as the benchmark harness
+    std::ofstream summary(output + "-summary.csv");
+    summary.precision(10);
+    summary << "id,benchmark,projectiles,walls,threads,system,samples,rejected,median_ns,mad_ns,ci_low_ns,ci_high_ns,mean_ns,min_ns,max_ns,allocations_per_frame,bytes_per_frame,peak_rss_kb\n";
+
+    size_t first = std::min(WARMUP_FRAMES, frames / 2);
+    std::string params = "projectiles=" + std::to_string(projectiles) + "/walls=" + std::to_string(walls) + "/threads=" + std::to_string(pool.size());
+
+    for (int s = 0; s <= STAGE_COUNT; ++s)
+    {
+        std::string system = s < STAGE_COUNT ? STAGE_NAMES[s] : "total";
+
+        std::vector<double> times;
+        double allocations = 0.0;
+        double bytes = 0.0;
+        for (size_t frame = first; frame < frames; ++frame)
+        {
+            const auto& cost = costs[frame];
+            times.push_back(static_cast<double>(s < STAGE_COUNT ? cost.ns[s] : cost.totalNs));
+
+            uint64_t frameBytes = 0;
+            for (int b = 0; b < STAGE_COUNT; ++b)
+                frameBytes += cost.bytes[b];
+
+            allocations += static_cast<double>(s < STAGE_COUNT ? cost.allocations[s] : cost.totalAllocations);
+            bytes += static_cast<double>(s < STAGE_COUNT ? cost.bytes[s] : frameBytes);
+        }
+
+        if (times.empty())
+            break;
+
+        auto time = bench::summarize(times, OUTLIER_THRESHOLD);
+        double measured = static_cast<double>(times.size());
+
+        summary << "frame/" << params << "/system=" << system << ",frame," << projectiles << "," << walls << "," << pool.size() << "," << system << "," << time.kept << "," << time.rejected << ","
+                << time.median << "," << time.mad << "," << time.ciLow << "," << time.ciHigh << "," << time.mean << "," << time.min << "," << time.max << ","
+                << allocations / measured << "," << bytes / measured << "," << rssKb << "\n";
+
+        std::cout << "  " << system << ": median " << time.median / 1e6 << " ms (95% " << time.ciLow / 1e6 << ".." << time.ciHigh / 1e6 << "), max " << time.max / 1e6 << " ms, "
+                  << allocations / measured << " allocations/frame\n";
+    }
+
+    std::cout << "peak rss: " << rssKb / 1024.0 << " MB, live heap: " << tracker.getLiveBytes() / (1024.0 * 1024.0) << " MB"
+              << (core::AllocationTracker::isCompiledIn() ? "" : " (allocation tracking compiled out)") << "\n";
+    std::cout << "done " << output << ".csv, " << output << "-summary.csv\n";
+
+    return 0;
+}
@@ -5,13 +5,14 @@
 // std
 #include <iostream>
 #include <fstream>
-#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <string>
 #include <vector>
 
-// linux
-#include <sched.h>
-#include <cstring>
-
 // BulletPhysics
 #include "math/Integrator.h"
 #include "math/Angles.h"
@@ -25,13 +26,23 @@
 #include "ballistics/external/environments/Humidity.h"
 #include "geography/CoordinateMapping.h"
 
+// BulletEngine
+#include "core/AllocationTracker.h"
+#include "core/ThreadPool.h"
+#include "bench/Harness.h"
+
 using namespace BulletPhysics;
 
-// exit file
-static constexpr std::string_view FILE_NAME = "performance.csv";
+// exit files, performance.json and performance.csv
+static constexpr std::string_view FILE_NAME = "performance";
+
+// sweep exit files, scaling-<bodies>.json and .csv per size, scaling.csv summary
+static constexpr std::string_view SWEEP_FILE_NAME = "scaling";
 
 // simulation parameters
-static constexpr int BODY_COUNT = 1000;
+static constexpr int BODY_COUNTS[] = {1, 10, 100, 1000};
+static constexpr size_t SWEEP_BODY_COUNTS[] = {100, 1000, 10000, 100000, 1000000};
+static constexpr size_t BATCH = 256;                // bodies per job of the batched path
 static constexpr double DT = 0.001;
 static constexpr double ELEVATION = 5.0;
 
@@ -54,93 +65,178 @@ static builtin::bodies::ProjectileRigidBody makeBody(double azimuth)
     return body;
 }
 
-struct Sample
+static void addEnvironment(ballistics::external::PhysicsWorld& physicsWorld)
 {
-    int step;
-    int active;
-    long long stepNs;
-};
-
-int main()
-{
-    geography::CoordinateMapping::set(geography::mappings::OpenGL());
-
-    // pin to CPU 0
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(0, &cpuset);
-    if (sched_setaffinity(0, sizeof(cpuset), &cpuset) != 0)
-        std::cerr << "warning: sched_setaffinity failed: " << std::strerror(errno) << "\n";     // use sudo
-
-    // raise priority
-    sched_param param{};
-    param.sched_priority = sched_get_priority_max(SCHED_FIFO);
-    if (sched_setscheduler(0, SCHED_FIFO, &param) != 0)
-        std::cerr << "warning: sched_setscheduler failed: " << std::strerror(errno) << "\n";
-
-    // physics world
-    ballistics::external::PhysicsWorld physicsWorld;
-
     physicsWorld.addForce(std::make_unique<ballistics::external::forces::Gravity>());
     physicsWorld.addEnvironment(std::make_unique<ballistics::external::environments::Atmosphere>(TEMPERATURE, PRESSURE));
     physicsWorld.addEnvironment(std::make_unique<ballistics::external::environments::Humidity>(REL_HUMIDITY));
     physicsWorld.addEnvironment(std::make_unique<ballistics::external::environments::Geographic>(math::deg2rad(LATITUDE), math::deg2rad(LONGITUDE)));
     physicsWorld.addForce(std::make_unique<ballistics::external::forces::Drag>());
     physicsWorld.addForce(std::make_unique<ballistics::external::forces::Coriolis>());
+}
 
-    // integrator
-    math::MidpointIntegrator integrator;
+static void launch(std::vector<builtin::bodies::ProjectileRigidBody>& bodies, size_t count)
+{
+    bodies.clear();
+    bodies.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        bodies.push_back(makeBody(360.0 * i / count));
+}
 
-    // create projectiles: same speed and elevation, spread azimuth evenly
-    std::vector<builtin::bodies::ProjectileRigidBody> bodies;
-    bodies.reserve(BODY_COUNT);
+// body counts against 1..all threads, stepping one body per job or a batch of consecutive bodies per job
+static int sweep(int argc, char** argv, size_t maxBodies)
+{
+    ballistics::external::PhysicsWorld physicsWorld;
+    addEnvironment(physicsWorld);
 
-    for (int i = 0; i < BODY_COUNT; ++i)
-    {
-        double azimuth = 360.0 * i / BODY_COUNT;
-        bodies.push_back(makeBody(azimuth));
-    }
+    // 1, 2, 4, ... up to all cores
+    std::vector<size_t> threadCounts;
+    size_t maxThreads = BulletEngine::core::ThreadPool::defaultThreadCount();
+    for (size_t t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
 
-    std::cout << "bodies: " << BODY_COUNT << "\n";
+    // workers must run on every core, and counters would only see the calling thread
+    BulletEngine::bench::Harness::Config defaults;
+    defaults.samples = 7;
+    defaults.maxWarmupSamples = 9;
+    defaults.counters = false;
+    defaults.output = SWEEP_FILE_NAME;
 
-    // simulate
-    std::vector<Sample> samples;
-    samples.reserve(16000);
+    std::ofstream summary(std::string(SWEEP_FILE_NAME) + ".csv");
+    summary << "bodies,path,threads,median_ns,ci_low_ns,ci_high_ns,body_steps_per_s,speedup,efficiency,bytes_per_body,footprint_mb\n";
 
-    int step = 0;
-    int active = BODY_COUNT;
+    std::cout << "threads: 1.." << maxThreads << ", batch: " << BATCH << "\n";
 
-    while (active == BODY_COUNT)
+    for (size_t count : SWEEP_BODY_COUNTS)
     {
-        auto t0 = std::chrono::high_resolution_clock::now();
+        if (count > maxBodies)
+            break;
+
+        // one size alive at a time, footprint from the allocation tracker when it is compiled in
+        auto bodies = std::make_shared<std::vector<builtin::bodies::ProjectileRigidBody>>();
+        auto& tracker = BulletEngine::core::AllocationTracker::instance();
+        int64_t liveBefore = tracker.getLiveBytes();
+        launch(*bodies, count);
+        double footprint = BulletEngine::core::AllocationTracker::isCompiledIn() ? static_cast<double>(tracker.getLiveBytes() - liveBefore) : static_cast<double>(sizeof(builtin::bodies::ProjectileRigidBody) * count);
+        double bytesPerBody = footprint / static_cast<double>(count);
 
-        for (auto& body : bodies)
-            integrator.step(body, &physicsWorld, DT);
+        auto config = BulletEngine::bench::Harness::parseArgs(argc, argv, defaults);
+        if (!config.output.empty())
+            config.output += "-" + std::to_string(count);
 
-        auto t1 = std::chrono::high_resolution_clock::now();
-        long long stepNs = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        BulletEngine::bench::Harness harness(config);
+        std::vector<std::unique_ptr<BulletEngine::core::ThreadPool>> pools;
 
-        // count active (above ground)
-        active = 0;
-        for (const auto& body : bodies)
+        for (size_t threads : threadCounts)
         {
-            if (body.getPosition().y > 0.0)
-                ++active;
+            pools.push_back(std::make_unique<BulletEngine::core::ThreadPool>(threads));
+            auto* pool = pools.back().get();
+
+            // integrators keep no shared state between bodies, one per worker anyway
+            auto integrators = std::make_shared<std::vector<math::MidpointIntegrator>>(threads);
+
+            for (std::string path : {"single", "batched"})
+            {
+                size_t grain = path == "single" ? 1 : BATCH;
+
+                harness.add("sweep", {{"bodies", std::to_string(count)}, {"path", path}, {"threads", std::to_string(threads)}}, [bodies, integrators, pool, grain, &physicsWorld](uint64_t iterations) {
+                        for (uint64_t i = 0; i < iterations; ++i)
+                        {
+                            pool->parallelFor(bodies->size(), grain, [&](size_t begin, size_t end, size_t worker) {
+                                auto& integrator = (*integrators)[worker];
+                                for (size_t b = begin; b < end; ++b)
+                                    integrator.step((*bodies)[b], &physicsWorld, DT);
+                            });
+                        }
+                    })
+                    .withSetup([bodies, count]() { launch(*bodies, count); })
+                    .withItems(static_cast<double>(count))
+                    .withMetric("bytes_per_body", bytesPerBody);
+            }
         }
 
-        samples.push_back({step, active, stepNs});
-        ++step;
+        harness.run();
+
+        // speedup and efficiency against one thread on the same path
+        for (const auto& result : harness.getResults())
+        {
+            const auto& params = result.benchmark->params;
+            const std::string& path = params[1].second;
+            size_t threads = std::strtoull(params[2].second.c_str(), nullptr, 10);
+
+            auto serial = std::find_if(harness.getResults().begin(), harness.getResults().end(), [&](const auto& other) {
+                return other.benchmark->params[1].second == path && other.benchmark->params[2].second == "1";
+            });
+
+            // filtered out baseline leaves speedup empty
+            double speedup = serial != harness.getResults().end() ? serial->time.median / result.time.median : std::nan("");
+            double efficiency = speedup / static_cast<double>(threads);
+            double throughput = 1e9 / result.time.median;
+
+            summary << count << "," << path << "," << threads << "," << result.time.median << "," << result.time.ciLow << "," << result.time.ciHigh << ","
+                    << throughput << "," << speedup << "," << efficiency << "," << bytesPerBody << "," << footprint / (1024.0 * 1024.0) << "\n";
+
+            std::cout << count << " bodies, " << path << ", " << threads << " threads: " << throughput / 1e6 << " M body steps/s, speedup " << speedup << "x, efficiency " << efficiency
+                      << ", " << footprint / (1024.0 * 1024.0) << " MB\n";
+        }
+    }
+
+    std::cout << "done " << SWEEP_FILE_NAME << ".csv\n";
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    geography::CoordinateMapping::set(geography::mappings::OpenGL());
+
+    std::string mode = "steps";
+    size_t maxBodies = SWEEP_BODY_COUNTS[std::size(SWEEP_BODY_COUNTS) - 1];
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--mode") mode = argv[i + 1];
+        else if (arg == "--max-bodies") maxBodies = std::strtoull(argv[i + 1], nullptr, 10);
     }
 
-    // write csv
+    if (mode == "sweep")
+        return sweep(argc, argv, maxBodies);
+
+    // pinned to cpu 0 at realtime priority unless told otherwise
+    BulletEngine::bench::Harness::Config defaults;
+    defaults.output = FILE_NAME;
+    defaults.cpu = 0;
+    defaults.realtime = true;
+    BulletEngine::bench::Harness harness(BulletEngine::bench::Harness::parseArgs(argc, argv, defaults));
+
+    // physics world
+    ballistics::external::PhysicsWorld physicsWorld;
+
+    addEnvironment(physicsWorld);
 
-    std::ofstream file(FILE_NAME.data());
-    file << "step,active,step_ns\n";
+    // integrator
+    math::MidpointIntegrator integrator;
 
-    for (const auto& sample : samples)
-        file << sample.step << "," << sample.active << "," << sample.stepNs << "\n";
+    // projectiles with same speed and elevation, azimuth spread evenly, relaunched for every sample
+    for (int count : BODY_COUNTS)
+    {
+        auto bodies = std::make_shared<std::vector<builtin::bodies::ProjectileRigidBody>>();
+
+        harness.add("step", {{"bodies", std::to_string(count)}}, [bodies, &physicsWorld, &integrator](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    for (auto& body : *bodies)
+                        integrator.step(body, &physicsWorld, DT);
+                }
+            })
+            .withSetup([bodies, count]() { launch(*bodies, count); })
+            .withItems(count);
+    }
 
-    std::cout << "done " << FILE_NAME << "\n";
+    // ns per body step
+    harness.run();
 
     return 0;
 }
@@ -1,12 +1,13 @@
+import os
+
+import numpy as np
 import pandas as pd
 import matplotlib.pyplot as plt
-from mpl_toolkits.axes_grid1.inset_locator import inset_axes, mark_inset
 
 WEIGHT = 600
 FONT_SIZE = 11
 TICK_SIZE = 11
-LEGEND_SIZE = 11
-INSET_TICK_SIZE = 10
+VALUE_SIZE = 11
 
 plt.rcParams.update({
     "font.weight": WEIGHT,
@@ -15,101 +16,76 @@ plt.rcParams.update({
     "axes.labelsize": FONT_SIZE,
     "xtick.labelsize": TICK_SIZE,
     "ytick.labelsize": TICK_SIZE,
-    "legend.fontsize": LEGEND_SIZE,
 })
 
-files = {
-    "1":    "data/1.csv",
-    "10":   "data/10.csv",
-    "100":  "data/100.csv",
-    "1000": "data/1000.csv",
-}
+
+def load_legacy():
+    # data/<bodies>.csv of the old per-step loop, one row per step of all active bodies
+    rows = []
+    for bodies in (1, 10, 100, 1000):
+        path = f"data/{bodies}.csv"
+        if not os.path.exists(path):
+            continue
+        steps = pd.read_csv(path)
+        per_body = np.sort((steps["step_ns"] / steps["active"]).to_numpy())
+        n = len(per_body)
+        # 95% order statistic interval of the median, as the harness reports it
+        half = 1.96 * np.sqrt(n) / 2
+        low = per_body[max(int(np.floor(n / 2 - half)), 0)]
+        high = per_body[min(int(np.ceil(n / 2 + half)), n - 1)]
+        rows.append({"bodies": bodies, "median_ns": np.median(per_body), "ci_low_ns": low, "ci_high_ns": high})
+    return pd.DataFrame(rows)
+
+
+# harness output if present, else the checked in results of the old loop
+if os.path.exists("data/performance.csv"):
+    df = pd.read_csv("data/performance.csv")
+else:
+    df = load_legacy()
+df = df.sort_values("bodies")
 
 colors = {
-    "1":    "#F94144",
-    "10":   "#f9c74f",
-    "100":  "#90be6d",
-    "1000": "#577590",
+    1:    "#F94144",
+    10:   "#f9c74f",
+    100:  "#90be6d",
+    1000: "#577590",
 }
 
-draw_order = ["1000", "100", "10", "1"]
-zorder = {"1000": 1, "100": 2, "10": 3, "1": 4}
-
-MED_WINDOW = 5
-MEAN_WINDOW = 15
+for _, row in df.iterrows():
+    print(f"{row['bodies']:>4} projectiles | median {row['median_ns']:.1f} ns | 95% {row['ci_low_ns']:.1f}..{row['ci_high_ns']:.1f} ns per body step")
 
 plt.figure(figsize=(8.6, 5.2))
 ax = plt.gca()
 
-series = {}
-
-for label in draw_order:
-    df = pd.read_csv(files[label]).sort_values("step")
-    df["step_ms"] = df["step_ns"] / 1_000_000.0
-
-    mean_ms = df["step_ms"].mean()
-    median_ms = df["step_ms"].median()
-    print(f"{label:>4} projectiles | mean {mean_ms:.4f} ms | median {median_ms:.4f} ms")
-
-    y = df["step_ms"]
-    y = y.rolling(window=MED_WINDOW, center=False, min_periods=1).median()
-    y = y.rolling(window=MEAN_WINDOW, center=False, min_periods=1).mean()
-
-    series[label] = (df["step"], y)
-
-    ax.plot(
-        df["step"], y,
-        label=label,
-        color=colors[label],
-        linewidth=3.2,
-        zorder=zorder[label],
-    )
-
-ax.set_xlabel("Step")
-ax.set_ylabel("Step time [ms]")
+labels = [str(b) for b in df["bodies"]]
+bars = ax.bar(
+    labels,
+    df["median_ns"],
+    yerr=[df["median_ns"] - df["ci_low_ns"], df["ci_high_ns"] - df["median_ns"]],
+    capsize=6,
+    color=[colors.get(b, "#577590") for b in df["bodies"]],
+    zorder=3,
+)
 
-ax.ticklabel_format(axis="y", style="plain", useOffset=False)
+ax.set_xlabel("Projectiles")
+ax.set_ylabel("Median time per body step [ns]")
 
 for tick in ax.get_xticklabels() + ax.get_yticklabels():
     tick.set_fontweight(WEIGHT)
 
 ax.grid(True, axis="y", alpha=0.35, linewidth=1.0, zorder=0)
 
-legend = ax.legend(
-    loc="lower center",
-    bbox_to_anchor=(0.5, -0.22),
-    ncol=4,
-    frameon=True
-)
-for text in legend.get_texts():
-    text.set_fontweight(WEIGHT)
-
-# zoom-in inset
-axins = inset_axes(ax, width="36%", height="36%", loc="upper right", borderpad=1.2)
-
-for label in draw_order:
-    x, y = series[label]
-    axins.plot(
-        x, y,
-        color=colors[label],
-        linewidth=2.2,
-        zorder=zorder[label],
+for b in bars:
+    h = b.get_height()
+    ax.text(
+        b.get_x() + b.get_width() / 2,
+        h,
+        f"{h:.0f}",
+        ha="center",
+        va="bottom",
+        fontweight=WEIGHT,
+        fontsize=VALUE_SIZE,
     )
 
-x1, x2 = 1500, 2000
-y1, y2 = 0.000, 0.100
-
-axins.set_xlim(x1, x2)
-axins.set_ylim(y1, y2)
-
-axins.ticklabel_format(axis="y", style="plain", useOffset=False)
-axins.grid(True, axis="y", alpha=0.25, linewidth=0.8)
-
-for tick in axins.get_xticklabels() + axins.get_yticklabels():
-    tick.set_fontweight(WEIGHT)
-    tick.set_fontsize(INSET_TICK_SIZE)
-
-mark_inset(ax, axins, loc1=2, loc2=4, fc="none", ec="0.45", lw=1.0)
-
 plt.tight_layout()
-plt.show()
\ No newline at end of file
+plt.show()
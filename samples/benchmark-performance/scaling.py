@@ -0,0 +1,50 @@
+import pandas as pd
+import matplotlib.pyplot as plt
+
+WEIGHT = 600
+FONT_SIZE = 11
+TICK_SIZE = 11
+
+plt.rcParams.update({
+    "font.weight": WEIGHT,
+    "axes.labelweight": WEIGHT,
+    "axes.titleweight": WEIGHT,
+    "axes.labelsize": FONT_SIZE,
+    "xtick.labelsize": TICK_SIZE,
+    "ytick.labelsize": TICK_SIZE,
+})
+
+df = pd.read_csv("data/scaling.csv").sort_values(["path", "bodies", "threads"])
+
+for _, row in df.iterrows():
+    print(f"{row['bodies']:>8} bodies | {row['path']:>7} | {row['threads']:>3} threads | {row['body_steps_per_s'] / 1e6:8.2f} M steps/s | efficiency {row['efficiency']:.2f} | {row['footprint_mb']:.1f} MB")
+
+fig, (left, right) = plt.subplots(1, 2, figsize=(13, 5.2))
+
+# throughput against body count, knee where the working set leaves the cache
+for (path, threads), group in df.groupby(["path", "threads"]):
+    style = "-" if path == "batched" else "--"
+    left.plot(group["bodies"], group["body_steps_per_s"] / 1e6, style, marker="o", label=f"{path}, {threads} threads")
+
+left.set_xscale("log")
+left.set_xlabel("Bodies")
+left.set_ylabel("Throughput [M body steps/s]")
+left.grid(True, alpha=0.35, linewidth=1.0)
+left.legend(fontsize=8)
+
+# parallel efficiency of the batched path, where adding threads stops paying off
+for bodies, group in df[df["path"] == "batched"].groupby("bodies"):
+    right.plot(group["threads"], group["efficiency"], marker="o", label=f"{bodies} bodies")
+
+right.axhline(1.0, color="gray", linewidth=1.0)
+right.set_xlabel("Threads")
+right.set_ylabel("Parallel efficiency")
+right.grid(True, alpha=0.35, linewidth=1.0)
+right.legend(fontsize=8)
+
+for ax in (left, right):
+    for tick in ax.get_xticklabels() + ax.get_yticklabels():
+        tick.set_fontweight(WEIGHT)
+
+plt.tight_layout()
+plt.show()
@@ -0,0 +1,173 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+// BulletPhysics
+#include "builtin/collision/collider/BoxCollider.h"
+#include "builtin/collision/collider/GroundCollider.h"
+#include "ballistics/terminal/Material.h"
+#include "geography/CoordinateMapping.h"
+
+// BulletEngine
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "ecs/systems/CollisionSystem.h"
+#include "core/AllocationTracker.h"
+#include "core/Profiler.h"
+
+using namespace BulletEngine;
+
+// exit file
+static constexpr std::string_view FILE_NAME = "raycast.csv";
+
+// scene parameters
+static constexpr int WALL_ROWS = 40;
+static constexpr int WALL_COLUMNS = 50;
+static constexpr int PROJECTILE_COUNT = 10000;
+
+// measurement params
+static constexpr int TOTAL_RAYS = 1 << 18;
+static constexpr int REPS = 9;
+static const std::vector<size_t> BATCH_SIZES = {1, 8, 64, 1024, 16384};
+
+static void buildRange(ecs::World& world)
+{
+    using namespace BulletPhysics::builtin::collision::collider;
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> jitter(-0.5, 0.5);
+
+    // ground
+    auto ground = world.create();
+    auto& groundCollider = world.add<ecs::ColliderComponent>(ground);
+    auto groundShape = std::make_shared<GroundCollider>(0.0f);
+    groundShape->setMaterial(BulletPhysics::ballistics::terminal::materials::Soil());
+    groundCollider.collider = groundShape;
+    groundCollider.layer = ecs::CollisionLayer::GROUND;
+    groundCollider.mask = ecs::CollisionLayer::PROJECTILE;
+
+    // grid of wall panels
+    for (int row = 0; row < WALL_ROWS; ++row)
+    {
+        for (int column = 0; column < WALL_COLUMNS; ++column)
+        {
+            auto wall = world.create();
+            auto& collider = world.add<ecs::ColliderComponent>(wall);
+            auto box = std::make_shared<BoxCollider>(BulletPhysics::math::Vec3{0.05, 3.0, 1.5});
+            box->setPosition({10.0 + row * 10.0 + jitter(rng), 1.5, (column - WALL_COLUMNS / 2) * 4.0 + jitter(rng)});
+            box->setMaterial(BulletPhysics::ballistics::terminal::materials::Wood());
+            collider.collider = box;
+            collider.layer = ecs::CollisionLayer::STATIC;
+            collider.mask = ecs::CollisionLayer::PROJECTILE;
+        }
+    }
+
+    // projectiles in flight, masked like the samples so they only pair with walls and ground
+    std::uniform_real_distribution<double> x(0.0, WALL_ROWS * 10.0);
+    std::uniform_real_distribution<double> y(0.5, 5.0);
+    std::uniform_real_distribution<double> z(-WALL_COLUMNS * 2.0, WALL_COLUMNS * 2.0);
+
+    for (int i = 0; i < PROJECTILE_COUNT; ++i)
+    {
+        auto projectile = world.create();
+        auto& collider = world.add<ecs::ColliderComponent>(projectile);
+        auto box = std::make_shared<BoxCollider>(BulletPhysics::math::Vec3{0.00762, 0.0253, 0.00762});
+        box->setPosition({x(rng), y(rng), z(rng)});
+        collider.collider = box;
+        collider.layer = ecs::CollisionLayer::PROJECTILE;
+        collider.mask = ecs::CollisionLayer::ALL & ~ecs::CollisionLayer::PROJECTILE;
+    }
+}
+
+int main()
+{
+    // nothing drains the profiler here, full rings would turn every scope into a contended drop count
+    core::Profiler::instance().setEnabled(false);
+
+    BulletPhysics::geography::CoordinateMapping::set(BulletPhysics::geography::mappings::OpenGL());
+
+    ecs::World world;
+    buildRange(world);
+
+    ecs::systems::CollisionSystemBase collisionSystem;
+    collisionSystem.setQueriesEnabled(true);
+    collisionSystem.update(world);
+
+    // shooters along firing line, aiming downrange
+    std::mt19937 rng(54321);
+    std::uniform_real_distribution<double> lateral(-WALL_COLUMNS * 2.0, WALL_COLUMNS * 2.0);
+    std::uniform_real_distribution<double> spread(-0.2, 0.2);
+    std::uniform_real_distribution<double> drop(-0.05, 0.01);
+
+    std::vector<collision::Ray> rays(TOTAL_RAYS);
+    for (auto& ray : rays)
+    {
+        ray.origin = {0.0, 1.5, lateral(rng)};
+        ray.direction = {1.0, drop(rng), spread(rng)};
+        ray.maxDistance = 1000.0;
+        ray.mask = ecs::CollisionLayer::STATIC | ecs::CollisionLayer::GROUND;
+    }
+
+    std::vector<collision::RayHit> hits(TOTAL_RAYS);
+
+    // warm up
+    collisionSystem.raycastBatch({rays.data(), 1}, {hits.data(), 1});
+
+    std::cout << "colliders: " << world.entities().size() << ", rays: " << TOTAL_RAYS << "\n";
+
+    std::ofstream file(FILE_NAME.data());
+    file << "batch,rep,rays_per_s\n";
+
+    // queries must not allocate, counted through the operator new linked into this benchmark
+    auto& tracker = core::AllocationTracker::instance();
+    if (tracker.getAllocations() == 0)
+    {
+        std::cout << "error: allocations not counted, operator new is not replaced\n";
+        return 1;
+    }
+
+    for (size_t batch : BATCH_SIZES)
+    {
+        std::vector<double> rates;
+        uint64_t allocations = 0;
+
+        for (int rep = 0; rep < REPS; ++rep)
+        {
+            uint64_t allocationsBefore = tracker.getAllocations();
+
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (size_t offset = 0; offset < rays.size(); offset += batch)
+            {
+                size_t count = std::min(batch, rays.size() - offset);
+                collisionSystem.raycastBatch({rays.data() + offset, count}, {hits.data() + offset, count});
+            }
+            auto t1 = std::chrono::high_resolution_clock::now();
+
+            allocations += tracker.getAllocations() - allocationsBefore;
+
+            double seconds = std::chrono::duration<double>(t1 - t0).count();
+            double rate = static_cast<double>(rays.size()) / seconds;
+            rates.push_back(rate);
+
+            file << batch << "," << rep << "," << rate << "\n";
+        }
+
+        std::sort(rates.begin(), rates.end());
+
+        size_t hitCount = std::count_if(hits.begin(), hits.end(), [](const collision::RayHit& hit) { return hit.hit(); });
+
+        std::cout << "batch " << batch << ": " << rates[rates.size() / 2] / 1e6 << " Mrays/s, hits " << hitCount << ", allocations " << allocations << "\n";
+    }
+
+    std::cout << "done " << FILE_NAME << "\n";
+
+    return 0;
+}
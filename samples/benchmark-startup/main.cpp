@@ -0,0 +1,158 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <filesystem>
+
+// linux
+#include <fcntl.h>
+#include <unistd.h>
+
+// BulletRender
+#include "app/Window.h"
+
+// BulletEngine
+#include "assets/AssetCache.h"
+#include "assets/MeshData.h"
+#include "assets/MeshCache.h"
+
+using namespace BulletEngine;
+
+// exit file
+static constexpr std::string_view FILE_NAME = "startup.csv";
+
+// measurement params
+static constexpr int REPS = 9;
+static const std::string MODELS_DIR = "assets/models";
+
+// ask the kernel to drop cached pages of a file, clean pages only so no root needed
+static void evict(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+template<class F>
+static double medianMs(bool cold, const std::vector<std::string>& files, F&& load)
+{
+    std::vector<double> times;
+
+    for (int rep = 0; rep < REPS; ++rep)
+    {
+        if (cold)
+        {
+            for (const auto& file : files)
+                evict(file);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        load();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char** argv)
+{
+    // models from command line, or every obj shipped with the samples
+    std::vector<std::string> models;
+    for (int i = 1; i < argc; ++i)
+    {
+        models.push_back(argv[i]);
+    }
+
+    if (models.empty() && std::filesystem::is_directory(MODELS_DIR))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(MODELS_DIR))
+        {
+            if (entry.path().extension() == ".obj")
+                models.push_back(entry.path().string());
+        }
+        std::sort(models.begin(), models.end());
+    }
+
+    if (models.empty())
+    {
+        std::cerr << "no models, pass obj paths as arguments\n";
+        return 1;
+    }
+
+    // Model(path) uploads, so the runtime path needs a gl context
+    BulletRender::app::WindowConfig windowCfg{800, 600, "Startup Benchmark", true, true};
+    if (!BulletRender::app::Window::init(windowCfg))
+    {
+        std::cerr << "no window, the model path needs a gl context\n";
+        return 1;
+    }
+
+    std::ofstream file(FILE_NAME.data());
+    file << "model,triangles,obj_bytes,mesh_bytes,cold_model_ms,warm_model_ms,cold_mesh_ms,warm_mesh_ms\n";
+
+    for (const auto& model : models)
+    {
+        std::string cachePath = assets::meshCachePath(model);
+
+        // convert once, benchmark below measures the cached path
+        assets::MeshData mesh;
+        std::filesystem::remove(cachePath);
+        if (!assets::loadMesh(model, mesh))
+        {
+            std::cerr << "skip " << model << ": conversion failed\n";
+            continue;
+        }
+
+        size_t triangles = mesh.indices.size() / 3;
+        bool ok = true;
+
+        // what a model request costs at runtime, loader read plus Model(path) in update
+        auto runtime = [&] {
+            assets::AssetCache assetCache;
+            auto handle = assetCache.model(model);
+            assetCache.finish();
+            ok &= handle->isReady();
+        };
+
+        // mesh cache alone, models can not be built from its buffers yet
+        auto cached = [&] { ok &= assets::loadMesh(model, mesh); };
+
+        // cached path hashes the obj too, so both files are evicted for cold runs
+        double coldModel = medianMs(true, {model}, runtime);
+        double warmModel = medianMs(false, {model}, runtime);
+        double coldMesh = medianMs(true, {model, cachePath}, cached);
+        double warmMesh = medianMs(false, {model, cachePath}, cached);
+
+        if (!ok)
+        {
+            std::cerr << "skip " << model << ": load failed\n";
+            continue;
+        }
+
+        auto objBytes = std::filesystem::file_size(model);
+        auto meshBytes = std::filesystem::file_size(cachePath);
+
+        file << model << "," << triangles << "," << objBytes << "," << meshBytes << "," << coldModel << "," << warmModel << "," << coldMesh << "," << warmMesh << "\n";
+
+        std::cout << model << " (" << triangles << " tris): model cold " << coldModel << " ms, warm " << warmModel << " ms | mesh cache only cold " << coldMesh << " ms, warm " << warmMesh << " ms\n";
+    }
+
+    BulletRender::app::Window::shutdown();
+
+    std::cout << "done " << FILE_NAME << "\n";
+    return 0;
+}
@@ -38,9 +38,9 @@ public:
     TrajectoryComponent() = default;
     explicit TrajectoryComponent(const BulletPhysics::math::Vec3& color) : color(color) {}
 
-    std::vector<BulletPhysics::math::Vec3> points;
+    // points are recorded by TrajectorySystem
     BulletPhysics::math::Vec3 color{1.0, 1.0, 1.0};
-    double minSegment = 0.02;
+    double tolerance = 0.01;       // max deviation of dropped samples, m
 };
 
 } // namespace ecs
@@ -0,0 +1,33 @@
+/*
+ * Test.h
+ */
+
+#pragma once
+
+#include <iostream>
+
+namespace BulletEngine {
+namespace test {
+
+// failed expectations of the test so far
+inline int g_failures = 0;
+
+// logs a failed condition, the test keeps running
+inline void expect(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "FAIL: " << what << "\n";
+        g_failures++;
+    }
+}
+
+// prints the verdict, returns exit code of the test
+inline int report()
+{
+    std::cout << (g_failures == 0 ? "PASS" : "FAIL") << "\n";
+    return g_failures == 0 ? 0 : 1;
+}
+
+} // namespace test
+} // namespace BulletEngine
@@ -8,6 +8,7 @@ namespace BulletEngine {
 namespace objects {
 
 std::vector<ecs::Entity> Projectile::fired;
+assets::AssetCache* Projectile::assets = nullptr;
 
 ecs::Entity Projectile::launch(ecs::World& world, const BulletPhysics::projectile::ProjectileSpecs& specs, const BulletPhysics::math::Vec3& position, double elevationDeg, double azimuthDeg, bool showCollider)
 {
@@ -15,7 +16,7 @@ ecs::Entity Projectile::launch(ecs::World& world, const BulletPhysics::projectil
 
     setupTransform(world, entity, specs.diameter);
     setupRigidBody(world, entity, specs, position, elevationDeg, azimuthDeg);
-    setupTrajectory(world, entity, position);
+    setupTrajectory(world, entity);
     setupRenderable(world, entity);
     setupCollider(world, entity, specs.diameter, showCollider);
 
@@ -28,7 +29,10 @@ void Projectile::setupTransform(ecs::World& world, ecs::Entity entity, double di
     auto& transform = world.add<ecs::TransformComponent>(entity);
 
     float modelScale = static_cast<float>(diameter / MODEL_DIAMETER);
-    transform.transform.setScale({modelScale, modelScale, modelScale});
+    transform.scale = {modelScale, modelScale, modelScale};
+
+    // model points along +y, nose follows velocity
+    transform.alignAxis = {0.0f, 1.0f, 0.0f};
 }
 
 void Projectile::setupRigidBody(ecs::World& world, ecs::Entity entity, const BulletPhysics::projectile::ProjectileSpecs& specs, const BulletPhysics::math::Vec3& position, double elevationDeg, double azimuthDeg)
@@ -38,20 +42,16 @@ void Projectile::setupRigidBody(ecs::World& world, ecs::Entity entity, const Bul
     rigidBody.getProjectileBody().setAngles(elevationDeg, azimuthDeg);
 }
 
-void Projectile::setupTrajectory(ecs::World& world, ecs::Entity entity, const BulletPhysics::math::Vec3& position)
+void Projectile::setupTrajectory(ecs::World& world, ecs::Entity entity)
 {
-    auto& trajectory = world.add<ecs::TrajectoryComponent>(entity);
-    trajectory.points.push_back(position);
+    world.add<ecs::TrajectoryComponent>(entity);
 }
 
 void Projectile::setupRenderable(ecs::World& world, ecs::Entity entity)
 {
-    auto model = std::make_unique<BulletRender::scene::Model>(MODEL_PATH);
-    auto shader = std::make_shared<BulletRender::render::Shader>(VERTEX_SHADER_PATH, FRAGMENT_SHADER_PATH);
-
     auto& renderable = world.add<ecs::RenderableComponent>(entity);
-    renderable.model = model.release();
-    renderable.material.setShader(shader);
+    renderable.asset = assets->model(MODEL_PATH);
+    renderable.shader = assets->shader(VERTEX_SHADER_PATH, FRAGMENT_SHADER_PATH);
     renderable.material.setColor({COLOR_R, COLOR_G, COLOR_B});
 }
 
@@ -64,15 +64,12 @@ void Projectile::setupCollider(ecs::World& world, ecs::Entity entity, double dia
     auto& collider = world.add<ecs::ColliderComponent>(entity);
     collider.collider = std::make_shared<BulletPhysics::builtin::collision::collider::BoxCollider>(BulletPhysics::math::Vec3{d, length, d});
 
-    if (showCollider)
-    {
-        auto shader = std::make_shared<BulletRender::render::Shader>(VERTEX_SHADER_PATH, FRAGMENT_SHADER_PATH);
+    // projectiles never test against each other
+    collider.layer = ecs::CollisionLayer::PROJECTILE;
+    collider.mask = ecs::CollisionLayer::ALL & ~ecs::CollisionLayer::PROJECTILE;
 
-        collider.isVisible = true;
-        collider.model = new BulletRender::scene::Box(MODEL_DIAMETER, MODEL_LENGTH, MODEL_DIAMETER);
-        collider.material.setShader(shader);
-        collider.material.setColor({0.0f, 1.0f, 0.0f});
-    }
+    // wireframe through the debug draw system, no model or shader per collider
+    collider.isVisible = showCollider;
 }
 
 } // namespace objects
@@ -6,6 +6,7 @@
 
 #include "ecs/Ecs.h"
 #include "ecs/Components.h"
+#include "assets/AssetCache.h"
 #include "scene/Model.h"
 #include "render/Shader.h"
 #include "builtin/collision/collider/BoxCollider.h"
@@ -38,10 +39,13 @@ public:
 
     static std::vector<ecs::Entity> fired;
 
+    // models and shaders are shared through this cache, must be set before launch
+    static assets::AssetCache* assets;
+
 private:
     static void setupTransform(ecs::World& world, ecs::Entity entity, double diameter);
     static void setupRigidBody(ecs::World& world, ecs::Entity entity, const BulletPhysics::projectile::ProjectileSpecs& specs, const BulletPhysics::math::Vec3& position, double elevationDeg, double azimuthDeg);
-    static void setupTrajectory(ecs::World& world, ecs::Entity entity, const BulletPhysics::math::Vec3& position);
+    static void setupTrajectory(ecs::World& world, ecs::Entity entity);
     static void setupRenderable(ecs::World& world, ecs::Entity entity);
     static void setupCollider(ecs::World& world, ecs::Entity entity, double diameter, bool showCollider);
 };
@@ -8,7 +8,7 @@ namespace BulletEngine {
 namespace ecs {
 namespace systems {
 
-void CollisionSystem::onCollision(World& world, Entity entityA, Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold)
+void CollisionSystem::onCollisionBegin(World& world, Entity entityA, Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold)
 {
     // determine which is ground and which is projectile
     Entity groundEntity = 0;
@@ -45,6 +45,20 @@ void CollisionSystem::onCollision(World& world, Entity entityA, Entity entityB,
         // stop projectile and mark as grounded
         rigidBodyComponent->getProjectileBody().setVelocity({0.0, 0.0, 0.0});
         rigidBodyComponent->isGrounded = true;
+        rigidBodyComponent->isSleeping = true;
+    }
+}
+
+void CollisionSystem::onTerrainHit(World& world, Entity entity, Entity terrainEntity, const collision::TerrainHit& hit)
+{
+    auto* rigidBodyComponent = world.get<ProjectileRigidBodyComponent>(entity);
+    if (rigidBodyComponent && !rigidBodyComponent->isGrounded)
+    {
+        // stop projectile at impact point
+        rigidBodyComponent->getProjectileBody().setPosition(hit.position);
+        rigidBodyComponent->getProjectileBody().setVelocity({0.0, 0.0, 0.0});
+        rigidBodyComponent->isGrounded = true;
+        rigidBodyComponent->isSleeping = true;
     }
 }
 
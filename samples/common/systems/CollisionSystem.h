@@ -16,7 +16,8 @@ public:
     using CollisionSystemBase::CollisionSystemBase;
 
 protected:
-    void onCollision(World& world, Entity entityA, Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold) override;
+    void onCollisionBegin(World& world, Entity entityA, Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold) override;
+    void onTerrainHit(World& world, Entity entity, Entity terrainEntity, const collision::TerrainHit& hit) override;
 };
 
 } // namespace systems
@@ -4,12 +4,16 @@
 
 #include "TrajectorySystem.h"
 
+#include "core/Profiler.h"
+
 namespace BulletEngine {
 namespace ecs {
 namespace systems {
 
 void TrajectorySystem::update(World& world)
 {
+    BE_PROFILE_SCOPE("trajectory/record");
+
     for (auto entity : world.entities())
     {
         auto* transformComponent = world.get<TransformComponent>(entity);
@@ -19,40 +23,46 @@ void TrajectorySystem::update(World& world)
             continue;
         }
 
-        auto pos = transformComponent->transform.getPosition();
-        BulletPhysics::math::Vec3 p{pos.x, pos.y, pos.z};
-
-        // calculate distance to last point
-        double distToLast = 0.0;
-        if (!trajectoryComponent->points.empty())
+        // body position if there is one, render transform is only written once per frame
+        glm::vec3 p = transformComponent->position;
+        auto* rigidBodyComponent = world.get<RigidBodyComponent>(entity);
+        if (rigidBodyComponent && rigidBodyComponent->body)
         {
-            const auto& last = trajectoryComponent->points.back();
-            double dx = p.x - last.x;
-            double dy = p.y - last.y;
-            double dz = p.z - last.z;
-            distToLast = std::sqrt(dx*dx + dy*dy + dz*dz);
+            const auto& position = rigidBodyComponent->body->getPosition();
+            p = {static_cast<float>(position.x), static_cast<float>(position.y), static_cast<float>(position.z)};
         }
+        glm::vec3 color{static_cast<float>(trajectoryComponent->color.x), static_cast<float>(trajectoryComponent->color.y), static_cast<float>(trajectoryComponent->color.z)};
+
+        rendering::SimplifyTolerance tolerance;
+        tolerance.distance = static_cast<float>(trajectoryComponent->tolerance);
+
+        m_buffer.record(entity, p, color, tolerance);
+    }
+}
+
+void TrajectorySystem::render(World& world, const glm::vec3& eye)
+{
+    BE_PROFILE_SCOPE("trajectory/render");
 
-        if (trajectoryComponent->points.empty() || distToLast >= trajectoryComponent->minSegment)
+    // tracks of live entities are kept also without lines, ending the frame drops the others
+    for (auto entity : world.entities())
+    {
+        if (!world.has<TrajectoryComponent>(entity))
         {
-            trajectoryComponent->points.push_back(p);
+            continue;
         }
 
-        if (trajectoryComponent->points.size() >= 2 && m_lines)
+        if (m_lines)
         {
-            // convert Vec3(double) points to glm::vec3(float) for rendering
-            std::vector<glm::vec3> renderPoints;
-            renderPoints.reserve(trajectoryComponent->points.size());
-            for (const auto& pt : trajectoryComponent->points)
-            {
-                renderPoints.push_back({static_cast<float>(pt.x), static_cast<float>(pt.y), static_cast<float>(pt.z)});
-            }
-
-            glm::vec3 renderColor{static_cast<float>(trajectoryComponent->color.x), static_cast<float>(trajectoryComponent->color.y), static_cast<float>(trajectoryComponent->color.z)};
-
-            m_lines->addPolyline({renderPoints.data(), renderPoints.data() + renderPoints.size()}, renderColor);
+            m_buffer.emit(entity, *m_lines, eye, m_lodAngle);
+        }
+        else
+        {
+            m_buffer.keep(entity);
         }
     }
+
+    m_buffer.endFrame();
 }
 
 } // namespace systems
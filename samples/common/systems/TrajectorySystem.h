@@ -6,6 +6,7 @@
 
 #include "ecs/Ecs.h"
 #include "ecs/Components.h"
+#include "rendering/TrajectoryBuffer.h"
 #include "render/passes/Lines.h"
 #include "common/Components.h"
 
@@ -17,12 +18,26 @@ namespace systems {
 
 class TrajectorySystem {
 public:
-    explicit TrajectorySystem(std::shared_ptr<BulletRender::render::Lines> lines) : m_lines(std::move(lines)) {}
+    static constexpr float DEFAULT_LOD_ANGLE = 0.002f;
 
+    explicit TrajectorySystem(std::shared_ptr<BulletRender::render::Lines> lines, size_t maxPoints = rendering::TrajectoryBuffer::DEFAULT_MAX_POINTS) : m_lines(lines ? std::make_shared<rendering::LinesAdapter>(std::move(lines)) : nullptr), m_buffer(maxPoints) {}
+    explicit TrajectorySystem(std::shared_ptr<rendering::LineSink> lines, size_t maxPoints = rendering::TrajectoryBuffer::DEFAULT_MAX_POINTS) : m_lines(std::move(lines)), m_buffer(maxPoints) {}
+
+    // record positions, cheap enough for every physics substep
     void update(World& world);
 
+    // emit recorded trajectories, once per rendered frame, detail falls off with distance to eye
+    void render(World& world, const glm::vec3& eye);
+
+    // angle in radians a segment must span to be drawn, 0 draws every kept point
+    void setLodAngle(float lodAngle) { m_lodAngle = lodAngle; }
+
+    const rendering::TrajectoryBuffer& getBuffer() const { return m_buffer; }
+
 private:
-    std::shared_ptr<BulletRender::render::Lines> m_lines;
+    std::shared_ptr<rendering::LineSink> m_lines;
+    rendering::TrajectoryBuffer m_buffer;
+    float m_lodAngle = DEFAULT_LOD_ANGLE;
 };
 
 } // namespace systems
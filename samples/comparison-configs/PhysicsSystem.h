@@ -7,7 +7,6 @@
 #include "ecs/Ecs.h"
 #include "ecs/systems/PhysicsSystem.h"
 #include "common/Components.h"
-#include "builtin/collision/collider/BoxCollider.h"
 
 namespace BulletEngine {
 
@@ -19,7 +18,6 @@ public:
 
 protected:
     bool beforeIntegrate(ecs::World& world, ecs::Entity entity, ecs::RigidBodyComponent& rigidBody, float dt) override;
-    void afterIntegrate(ecs::World& world, ecs::Entity entity, ecs::RigidBodyComponent& rigidBody, float dt) override;
 
 private:
     ecs::Entity* m_targetId;
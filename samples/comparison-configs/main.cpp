@@ -35,8 +35,10 @@
 // BulletEngine
 #include "ecs/Ecs.h"
 #include "ecs/systems/RenderSystem.h"
+#include "ecs/systems/TransformSystem.h"
 #include "ecs/systems/InputSystem.h"
 #include "ecs/systems/ImGuiSystem.h"
+#include "ecs/systems/ProfilerPanel.h"
 
 // common
 #include "common/Components.h"
@@ -188,12 +190,17 @@ int main()
     auto fog = std::make_shared<BulletRender::render::Fog>(true, 10.0f, 900.0f);
     BulletRender::render::Renderer::registerPostPass(fog);
 
+    // shared models and shaders, outlives the world holding handles
+    assets::AssetCache assetCache;
+    objects::Projectile::assets = &assetCache;
+
     // ecs
     ecs::World world;
 
     // systems
     RenderSystem renderSystem(scene);
     ImGuiSystem imguiSystem;
+    ecs::systems::TransformSystemBase transformSystem;
     ecs::systems::CollisionSystem collisionSystem;
     ecs::systems::TrajectorySystem trajectorySystem(lines);
 
@@ -249,8 +256,10 @@ int main()
 
     // ground
     auto groundObject = world.create();
-    world.add<ecs::ColliderComponent>(groundObject).collider =
-        std::make_shared<BulletPhysics::builtin::collision::collider::GroundCollider>(0.0f);
+    auto& groundCollider = world.add<ecs::ColliderComponent>(groundObject);
+    groundCollider.collider = std::make_shared<BulletPhysics::builtin::collision::collider::GroundCollider>(0.0f);
+    groundCollider.layer = ecs::CollisionLayer::GROUND;
+    groundCollider.mask = ecs::CollisionLayer::PROJECTILE;
 
     // input
     ecs::systems::InputSystem inputSystem;
@@ -265,6 +274,10 @@ int main()
     float lastDt = 0.0f;
     setupDebugDisplay(imguiSystem, camera, lastDt);
 
+    // frame profiler
+    ecs::systems::ProfilerPanel profilerPanel;
+    imguiSystem.add([&profilerPanel]() { profilerPanel.render(); });
+
     // loop
     BulletRender::app::Loop loop(scene);
     loop.run([&](float dt) {
@@ -289,9 +302,15 @@ int main()
 
         collisionSystem.update(world);
         trajectorySystem.update(world);
+        transformSystem.update(world);
 
+        trajectorySystem.render(world, camera.position());
+        assetCache.update();
         renderSystem.render(world);
         imguiSystem.render();
+
+        core::Profiler::instance().endFrame();
+        core::AllocationTracker::instance().endFrame();
     });
 
     BulletRender::app::Window::shutdown();
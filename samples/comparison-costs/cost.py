@@ -1,3 +1,5 @@
+import os
+
 import numpy as np
 import pandas as pd
 import matplotlib.pyplot as plt
@@ -17,10 +19,10 @@ plt.rcParams.update({
     "legend.fontsize": LEGEND_SIZE,
 })
 
-files = {
-    "Euler": "data/euler.csv",
-    "Midpoint": "data/midpoint.csv",
-    "RK4": "data/rk4.csv",
+integrators = {
+    "euler": "Euler",
+    "midpoint": "Midpoint",
+    "rk4": "RK4",
 }
 
 order = ["gravity", "+drag", "+coriolis", "+spin"]
@@ -39,14 +41,19 @@ colors = {
     "+spin":     "#577590",
 }
 
-rows = []
-for integ, path in files.items():
-    df = pd.read_csv(path)
-    means = df.groupby("config")["avg_step_ns"].mean().reindex(order)
-    rows.append(means.rename(integ))
-
-M = pd.DataFrame(rows)
-M = M.reindex(list(files.keys()))
+# median step time of each integrator and configuration
+# harness output if present, else the checked in per integrator results of the old loop
+if os.path.exists("data/costs.csv"):
+    df = pd.read_csv("data/costs.csv")
+else:
+    df = pd.concat([
+        pd.read_csv(f"data/{key}.csv").assign(integrator=key)
+        for key in integrators
+    ])
+    df = df.groupby(["integrator", "config"], as_index=False)["avg_step_ns"].median().rename(columns={"avg_step_ns": "median_ns"})
+M = df.pivot(index="integrator", columns="config", values="median_ns")
+M = M.reindex(index=list(integrators.keys()), columns=order)
+M.index = [integrators[i] for i in M.index]
 
 # grouped bars
 x = np.arange(len(M.index))
@@ -70,7 +77,7 @@ for i, cfg in enumerate(order):
 
 ax.set_xticks(x)
 ax.set_xticklabels(M.index.tolist())
-ax.set_ylabel("Average step time [ns]")
+ax.set_ylabel("Median step time [ns]")
 
 for tick in ax.get_xticklabels() + ax.get_yticklabels():
     tick.set_fontweight(WEIGHT)
@@ -3,10 +3,8 @@
  */
 
 // std
-#include <iostream>
-#include <fstream>
-#include <chrono>
-#include <random>
+#include <memory>
+#include <vector>
 
 // BulletPhysics
 #include "math/Integrator.h"
@@ -22,15 +20,17 @@
 #include "ballistics/external/environments/Humidity.h"
 #include "geography/CoordinateMapping.h"
 
+// BulletEngine
+#include "bench/Harness.h"
+
 using namespace BulletPhysics;
 
 // time step
 static constexpr double DT = 0.001;
 
-// measurement params
-static constexpr int WARMUP_STEPS = 2000;
+// measurement params, steps per sample fixed so every sample covers the same stretch of flight
 static constexpr int MEASURE_STEPS = 8000;
-static constexpr int REPS = 9;
+static constexpr size_t SAMPLES = 9;
 
 // configuration
 static constexpr double TEMPERATURE = 280.0;        // K
@@ -51,43 +51,7 @@ static builtin::bodies::ProjectileRigidBody makeBody()
     return body;
 }
 
-static void thrashCache()
-{
-    static std::vector<std::uint8_t> buf(64 * 1024 * 1024, 1);  // 64 MB
-    volatile std::uint64_t sum = 0;
-    for (size_t i = 0; i < buf.size(); i += 64)
-        sum += buf[i];
-    (void)sum;
-}
-
-static void runConfig(const char* config, ballistics::external::PhysicsWorld& world, math::IIntegrator& integrator, int rep, std::ostream& out)
-{
-    thrashCache();
-
-    // warmup
-    {
-        auto body = makeBody();
-        for (int i = 0; i < WARMUP_STEPS; ++i)
-            integrator.step(body, &world, DT);
-    }
-
-    thrashCache();
-
-    // measure
-    auto body = makeBody();
-
-    auto t0 = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < MEASURE_STEPS; ++i)
-        integrator.step(body, &world, DT);
-    auto t1 = std::chrono::high_resolution_clock::now();
-
-    long long total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
-    double avg_step_ns = double(total_ns) / double(MEASURE_STEPS);
-
-    out << config << "," << rep << "," << MEASURE_STEPS << "," << avg_step_ns << "\n";
-}
-
-int main()
+int main(int argc, char** argv)
 {
     geography::CoordinateMapping::set(geography::mappings::OpenGL());
 
@@ -152,24 +116,29 @@ int main()
         {"rk4", &rk4},
     };
 
-    std::mt19937 rng(12345);
+    BulletEngine::bench::Harness::Config defaults;
+    defaults.samples = SAMPLES;
+    defaults.output = "costs";
+    BulletEngine::bench::Harness harness(BulletEngine::bench::Harness::parseArgs(argc, argv, defaults));
 
+    // fresh body and cold caches for every sample, time per step
     for (auto& integrator : integrators)
     {
-        std::string filename = std::string(integrator.name) + ".csv";
-        std::ofstream file(filename);
-        file << "config,rep,steps,avg_step_ns\n";
-
-        for (int rep = 0; rep < REPS; ++rep)
+        for (auto& c : configs)
         {
-            std::shuffle(configs.begin(), configs.end(), rng);
-
-            for (auto& c : configs)
-                runConfig(c.name, *c.world, *integrator.integrator, rep, file);
+            auto body = std::make_shared<std::unique_ptr<builtin::bodies::ProjectileRigidBody>>();
+
+            harness.add("step", {{"integrator", integrator.name}, {"config", c.name}}, [body, world = c.world, method = integrator.integrator](uint64_t iterations) {
+                    for (uint64_t i = 0; i < iterations; ++i)
+                        method->step(**body, world, DT);
+                })
+                .withSetup([body]() { *body = std::make_unique<builtin::bodies::ProjectileRigidBody>(makeBody()); })
+                .withIterations(MEASURE_STEPS)
+                .withColdCache();
         }
-
-        std::cout << "done " << filename << "\n";
     }
 
+    harness.run();
+
     return 0;
 }
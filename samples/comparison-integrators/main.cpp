@@ -8,10 +8,8 @@
 #include <iomanip>
 #include <cmath>
 #include <vector>
-#include <chrono>
 #include <algorithm>
-#include <random>
-#include <cstdint>
+#include <memory>
 
 // BulletPhysics
 #include "math/Integrator.h"
@@ -22,11 +20,14 @@
 #include "ballistics/external/PhysicsContext.h"
 #include "geography/CoordinateMapping.h"
 
+// BulletEngine
+#include "bench/Harness.h"
+
 using namespace BulletPhysics;
 
-// exit files
+// exit files, timing.json and timing.csv from the harness
 static constexpr std::string_view TRAJECTORY_FILE_NAME = "trajectory.csv";
-static constexpr std::string_view TIMING_FILE_NAME = "timing.csv";
+static constexpr std::string_view TIMING_NAME = "timing";
 
 // simulation parameters
 static constexpr double MASS = 1.0;
@@ -38,10 +39,6 @@ static constexpr double G = 9.80665;
 static constexpr double K = 2.0;
 static constexpr double DT = 0.25;
 
-// measurement controls
-static constexpr int REPS = 15;
-static constexpr int WARMUP_STEPS = 64;
-
 // linear drag: F = -k * v
 class LinearDrag : public ballistics::external::forces::IForce
 {
@@ -70,21 +67,6 @@ static math::Vec3 analytical(double t)
     return {x, y, 0.0};
 }
 
-struct SimResult
-{
-    std::vector<math::Vec3> points;
-    std::vector<long long> stepTimesNs;
-};
-
-static void thrashCache()
-{
-    static std::vector<std::uint8_t> buf(64 * 1024 * 1024, 1);  // 64 MB
-    volatile std::uint64_t sum = 0;
-    for (size_t i = 0; i < buf.size(); i += 64)
-        sum += buf[i];
-    (void)sum;
-}
-
 static void init(ballistics::external::PhysicsWorld& world, builtin::bodies::RigidBody& body)
 {
     world = ballistics::external::PhysicsWorld{};
@@ -98,21 +80,13 @@ static void init(ballistics::external::PhysicsWorld& world, builtin::bodies::Rig
     body.setVelocity({INIT_VX, INIT_VY, 0.0});
 }
 
-static SimResult simulate(math::IIntegrator& integrator, bool measure)
+static std::vector<math::Vec3> simulate(math::IIntegrator& integrator)
 {
     ballistics::external::PhysicsWorld world;
     builtin::bodies::RigidBody body;
     init(world, body);
 
-    // warmup
-    for (int i = 0; i < WARMUP_STEPS; ++i)
-        integrator.step(body, &world, DT);
-
-    // reset
-    init(world, body);
-
     std::vector<math::Vec3> points;
-    std::vector<long long> times;
 
     while (true)
     {
@@ -122,36 +96,13 @@ static SimResult simulate(math::IIntegrator& integrator, bool measure)
         if (pos.y <= 0.0 && points.size() > 1)
             break;
 
-        if (measure)
-        {
-            auto t0 = std::chrono::high_resolution_clock::now();
-            integrator.step(body, &world, DT);
-            auto t1 = std::chrono::high_resolution_clock::now();
-            times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
-        }
-        else
-        {
-            integrator.step(body, &world, DT);
-        }
+        integrator.step(body, &world, DT);
     }
 
-    return {points, times};
+    return points;
 }
 
-static double average(const std::vector<long long>& samples)
-{
-    if (samples.empty())
-        return 0.0;
-
-    long double sum = 0.0;
-
-    for (auto sample : samples)
-        sum += (long double)sample;
-
-    return (double)(sum / (long double)samples.size());
-}
-
-int main()
+int main(int argc, char** argv)
 {
     geography::CoordinateMapping::set(geography::mappings::OpenGL());
 
@@ -159,41 +110,10 @@ int main()
     math::MidpointIntegrator midpoint;
     math::RK4Integrator rk4;
 
-    struct Entry {
-        const char* name;
-        math::IIntegrator* integrator;
-        std::vector<double> avgs;
-    };
-
-    std::vector<Entry> entries = {
-        {"euler", &euler, {}},
-        {"midpoint", &midpoint, {}},
-        {"rk4", &rk4, {}},
-    };
-
     // reference runs
-    thrashCache();
-    auto eulerRef = simulate(euler, false);
-
-    thrashCache();
-    auto midpointRef = simulate(midpoint, false);
-
-    thrashCache();
-    auto rk4Ref = simulate(rk4, false);
-
-    std::mt19937 rng(12345);
-
-    for (int rep = 0; rep < REPS; ++rep)
-    {
-        std::shuffle(entries.begin(), entries.end(), rng);
-
-        for (auto& entry : entries)
-        {
-            thrashCache();
-            auto res = simulate(*entry.integrator, true);
-            entry.avgs.push_back(average(res.stepTimesNs));
-        }
-    }
+    auto eulerRef = simulate(euler);
+    auto midpointRef = simulate(midpoint);
+    auto rk4Ref = simulate(rk4);
 
     // trajectory
     {
@@ -201,33 +121,51 @@ int main()
         file << std::fixed << std::setprecision(8);
         file << "euler_x,euler_y,midpoint_x,midpoint_y,rk4_x,rk4_y,analytical_x,analytical_y\n";
 
-        size_t steps = std::min({eulerRef.points.size(), midpointRef.points.size(), rk4Ref.points.size()});
+        size_t steps = std::min({eulerRef.size(), midpointRef.size(), rk4Ref.size()});
         for (size_t i = 0; i < steps; ++i)
         {
             double t = i * DT;
             auto an = analytical(t);
 
-            file << eulerRef.points[i].x    << "," << eulerRef.points[i].y    << ","
-                 << midpointRef.points[i].x << "," << midpointRef.points[i].y << ","
-                 << rk4Ref.points[i].x      << "," << rk4Ref.points[i].y      << ","
+            file << eulerRef[i].x    << "," << eulerRef[i].y    << ","
+                 << midpointRef[i].x << "," << midpointRef[i].y << ","
+                 << rk4Ref[i].x      << "," << rk4Ref[i].y      << ","
                  << an.x << "," << an.y << "\n";
         }
 
         std::cout << "done " << TRAJECTORY_FILE_NAME << "\n";
     }
 
-    // timing
+    // timing, every sample starts from the initial state
     {
-        std::ofstream file(TIMING_FILE_NAME.data());
-        file << "integrator,rep,avg_step_ns\n";
+        BulletEngine::bench::Harness::Config defaults;
+        defaults.output = TIMING_NAME;
+        BulletEngine::bench::Harness harness(BulletEngine::bench::Harness::parseArgs(argc, argv, defaults));
+
+        struct Entry {
+            const char* name;
+            math::IIntegrator* integrator;
+        };
 
-        for (const auto& entry : entries)
+        Entry entries[] = {
+            {"euler", &euler},
+            {"midpoint", &midpoint},
+            {"rk4", &rk4},
+        };
+
+        for (auto& entry : entries)
         {
-            for (int i = 0; i < (int)entry.avgs.size(); ++i)
-                file << entry.name << "," << i << "," << entry.avgs[i] << "\n";
+            auto world = std::make_shared<ballistics::external::PhysicsWorld>();
+            auto body = std::make_shared<builtin::bodies::RigidBody>();
+
+            harness.add("step", {{"integrator", entry.name}}, [world, body, method = entry.integrator](uint64_t iterations) {
+                    for (uint64_t i = 0; i < iterations; ++i)
+                        method->step(*body, world.get(), DT);
+                })
+                .withSetup([world, body]() { init(*world, *body); });
         }
 
-        std::cout << "done " << TIMING_FILE_NAME << "\n";
+        harness.run();
     }
 
     return 0;
@@ -1,3 +1,5 @@
+import os
+
 import pandas as pd
 import matplotlib.pyplot as plt
 
@@ -15,7 +17,11 @@ plt.rcParams.update({
     "ytick.labelsize": TICK_SIZE,
 })
 
-df = pd.read_csv("data/time.csv")
+# harness output if present, else the checked in results of the old loop
+if os.path.exists("data/timing.csv"):
+    df = pd.read_csv("data/timing.csv")
+else:
+    df = pd.read_csv("data/time.csv").groupby("integrator", as_index=False)["avg_step_ns"].median().rename(columns={"avg_step_ns": "median_ns"})
 
 colors = {
     "euler":      "#f9c74f",
@@ -31,9 +37,8 @@ pretty = {
     "rk4":      "RK4",
 }
 
-means_ns = (
-    df.groupby("integrator", as_index=True)["avg_step_ns"]
-      .mean()
+medians_ns = (
+    df.set_index("integrator")["median_ns"]
       .reindex(order)
 )
 
@@ -41,13 +46,13 @@ plt.figure(figsize=(8.6, 5.2))
 ax = plt.gca()
 
 bars = ax.bar(
-    [pretty[i] for i in means_ns.index],
-    means_ns.values.tolist(),
-    color=[colors[i] for i in means_ns.index],
+    [pretty[i] for i in medians_ns.index],
+    medians_ns.values.tolist(),
+    color=[colors[i] for i in medians_ns.index],
     zorder=3,
 )
 
-ax.set_ylabel("Average step time [ns]")
+ax.set_ylabel("Median step time [ns]")
 
 for tick in ax.get_xticklabels() + ax.get_yticklabels():
     tick.set_fontweight(WEIGHT)
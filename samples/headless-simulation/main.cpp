@@ -0,0 +1,235 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <map>
+
+// BulletPhysics
+#include "math/Integrator.h"
+#include "builtin/collision/collider/BoxCollider.h"
+#include "builtin/collision/collider/GroundCollider.h"
+#include "ballistics/external/PhysicsWorld.h"
+#include "ballistics/external/environments/Atmosphere.h"
+#include "ballistics/external/forces/Gravity.h"
+#include "ballistics/external/forces/drag/Drag.h"
+#include "ballistics/terminal/Material.h"
+#include "geography/CoordinateMapping.h"
+
+// BulletEngine
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "ecs/systems/PhysicsSystem.h"
+#include "ecs/systems/RenderSystem.h"
+#include "ecs/systems/TransformSystem.h"
+#include "core/HeadlessLoop.h"
+#include "core/Profiler.h"
+#include "rendering/NullBackend.h"
+#include "assets/AssetCache.h"
+#include "common/Components.h"
+#include "common/systems/CollisionSystem.h"
+#include "common/systems/TrajectorySystem.h"
+#include "common/objects/Projectile.h"
+
+using namespace BulletEngine;
+
+// simulation parameters
+static constexpr float PHYSICS_DT = 0.001f;
+static constexpr float FRAME_DT = 1.0f / 60.0f;
+static constexpr int WALL_COUNT = 8;
+
+// systems expected to run allocation free once caches are warm
+static constexpr const char* BUDGETED_SYSTEMS[] = {"physics", "collision", "transforms", "render"};
+
+// grounded projectiles stop, same as the windowed samples
+class PhysicsSystem : public ecs::systems::PhysicsSystemBase {
+public:
+    using PhysicsSystemBase::PhysicsSystemBase;
+
+protected:
+    bool beforeIntegrate(ecs::World& world, ecs::Entity entity, ecs::RigidBodyComponent&, float) override
+    {
+        auto* projectileComponent = world.get<ecs::ProjectileRigidBodyComponent>(entity);
+        return !projectileComponent || !projectileComponent->isGrounded;
+    }
+};
+
+static void buildRange(ecs::World& world)
+{
+    using namespace BulletPhysics::builtin::collision::collider;
+
+    auto ground = world.create();
+    auto& groundCollider = world.add<ecs::ColliderComponent>(ground);
+    groundCollider.collider = std::make_shared<GroundCollider>(0.0f);
+    groundCollider.layer = ecs::CollisionLayer::GROUND;
+    groundCollider.mask = ecs::CollisionLayer::PROJECTILE;
+
+    for (int i = 0; i < WALL_COUNT; ++i)
+    {
+        auto wall = world.create();
+        auto& collider = world.add<ecs::ColliderComponent>(wall);
+
+        auto box = std::make_shared<BoxCollider>(BulletPhysics::math::Vec3{0.2, 3.0, 40.0});
+        box->setPosition({50.0 + i * 25.0, 1.5, 0.0});
+        box->setMaterial(BulletPhysics::ballistics::terminal::materials::Wood());
+
+        collider.collider = box;
+        collider.layer = ecs::CollisionLayer::STATIC;
+        collider.mask = ecs::CollisionLayer::PROJECTILE;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    core::HeadlessLoop::Config loopConfig;
+    loopConfig.dt = FRAME_DT;
+    loopConfig.maxFrames = 600;
+    int projectiles = 256;
+    std::string tracePath;
+    long long budgetGrace = -1;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--frames") loopConfig.maxFrames = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (arg == "--rate") loopConfig.rate = std::strtod(argv[i + 1], nullptr);
+        else if (arg == "--projectiles") projectiles = std::atoi(argv[i + 1]);
+        else if (arg == "--trace") tracePath = argv[i + 1];
+        else if (arg == "--budgets") budgetGrace = std::atoll(argv[i + 1]);
+    }
+
+    // zero allocation budgets after the given warm up frames, misses are counted instead of asserting
+    std::map<std::string, size_t> budgetMisses;
+    if (budgetGrace >= 0)
+    {
+        auto& tracker = core::AllocationTracker::instance();
+        for (const char* system : BUDGETED_SYSTEMS)
+        {
+            core::AllocationTracker::Budget budget;
+            budget.maxAllocations = 0;
+            budget.graceFrames = static_cast<uint64_t>(budgetGrace);
+            tracker.setBudget(system, budget);
+        }
+
+        tracker.setViolationHandler([&budgetMisses](const core::AllocationTracker::Violation& violation) {
+            if (budgetMisses[violation.tag]++ == 0)
+                std::cout << "frame " << violation.frame << ": " << violation.tag << " made " << violation.allocations << " allocations, budget " << violation.budget.maxAllocations << "\n";
+        });
+
+        if (!core::AllocationTracker::isCompiledIn())
+            std::cout << "allocation tracking compiled out, build with TRACK_ALLOCATIONS=ON\n";
+    }
+
+    // keep the whole run unless BE_TRACE_MB already set a budget
+    if (!tracePath.empty() && !core::Profiler::instance().isTracing())
+    {
+        core::TraceRecorder::Config traceConfig;
+        traceConfig.budgetBytes = 64 << 20;
+        core::Profiler::instance().configureTrace(traceConfig);
+    }
+
+    BulletPhysics::geography::CoordinateMapping::set(BulletPhysics::geography::mappings::OpenGL());
+
+    // null backends record what a window would show
+    auto lines = std::make_shared<rendering::NullLines>();
+    rendering::NullInstanceRenderer instanceRenderer;
+
+    // model files are read but not parsed or uploaded
+    assets::AssetCache assetCache(false);
+    objects::Projectile::assets = &assetCache;
+
+    // ecs
+    ecs::World world;
+    buildRange(world);
+
+    // systems
+    ecs::systems::RenderSystemBase renderSystem(instanceRenderer);
+    ecs::systems::TransformSystemBase transformSystem;
+    ecs::systems::CollisionSystem collisionSystem;
+    ecs::systems::TrajectorySystem trajectorySystem(lines);
+
+    // physics
+    BulletPhysics::ballistics::external::PhysicsWorld physicsWorld;
+    BulletPhysics::math::MidpointIntegrator integrator;
+    PhysicsSystem physicsSystem(physicsWorld, integrator);
+
+    physicsWorld.addForce(std::make_unique<BulletPhysics::ballistics::external::forces::Gravity>());
+    physicsWorld.addEnvironment(std::make_unique<BulletPhysics::ballistics::external::environments::Atmosphere>(280.0, 100000.0));
+    physicsWorld.addForce(std::make_unique<BulletPhysics::ballistics::external::forces::Drag>());
+
+    // fan of shots across the walls
+    for (int i = 0; i < projectiles; ++i)
+    {
+        auto specs = BulletPhysics::projectile::ProjectileSpecs::create(0.01, 0.00762)
+            .withDragModel(BulletPhysics::ballistics::external::forces::drag::DragCurveModel::G7)
+            .withMuzzle(300.0 + (i % 16) * 25.0, BulletPhysics::projectile::Direction::RIGHT, 12.0);
+
+        double elevation = 0.5 + (i / 16) * 0.25;
+        double azimuth = 90.0 + ((i % 16) - 8) * 0.5;
+        objects::Projectile::launch(world, specs, {0.0, 1.5, 0.0}, elevation, azimuth);
+    }
+
+    const glm::vec3 eye{0.0f, 3.0f, 8.0f};
+    const int steps = static_cast<int>(FRAME_DT / PHYSICS_DT);
+
+    core::HeadlessLoop loop(loopConfig);
+    loop.run([&](float) {
+        for (int i = 0; i < steps; ++i)
+        {
+            BE_PROFILE_SCOPE("substep");
+            physicsSystem.update(world, PHYSICS_DT);
+            collisionSystem.update(world);
+            trajectorySystem.update(world);
+        }
+
+        transformSystem.update(world);
+
+        trajectorySystem.render(world, eye);
+        assetCache.update();
+        renderSystem.render(world);
+
+        lines->endFrame();
+        instanceRenderer.endFrame();
+    });
+
+    // report
+    double frames = static_cast<double>(loop.getFrames());
+    std::cout << "projectiles: " << projectiles << ", frames: " << loop.getFrames() << ", simulated: " << frames * FRAME_DT << " s\n";
+    std::cout << "wall time: " << loop.getElapsed() << " s, " << frames / loop.getElapsed() << " frames/s\n";
+    std::cout << "last frame: " << instanceRenderer.getLastFrameInstances() << " instances in " << instanceRenderer.getLastFrameBatches() << " batches, " << lines->getLastFrameSegments() << " line segments\n";
+    std::cout << "trajectory points: " << trajectorySystem.getBuffer().size() << "\n";
+
+    // per scope times over the last frames, empty if profiling is compiled out
+    std::vector<core::Profiler::ScopeStats> stats;
+    core::Profiler::instance().stats(stats);
+    for (const auto& scope : stats)
+    {
+        std::cout << "  " << scope.name << ": mean " << scope.mean << " ms, p99 " << scope.p99 << " ms, " << scope.calls << " calls/frame\n";
+    }
+
+    // allocations per tag since start, empty if tracking is compiled out
+    if (budgetGrace >= 0)
+    {
+        std::vector<core::AllocationTracker::TagStats> allocations;
+        core::AllocationTracker::instance().stats(allocations);
+        for (const auto& tag : allocations)
+        {
+            std::cout << "  " << tag.name << ": " << tag.totalAllocations << " allocations, peak " << tag.peakAllocations << "/frame";
+            if (tag.hasBudget)
+                std::cout << ", budget missed in " << tag.violations << " frames";
+            std::cout << "\n";
+        }
+    }
+
+    if (!tracePath.empty())
+    {
+        bool written = core::Profiler::instance().dumpTrace(tracePath);
+        std::cout << (written ? "trace written to " : "failed to write trace ") << tracePath << "\n";
+    }
+
+    return 0;
+}
@@ -5,8 +5,7 @@
 // std
 #include <iostream>
 #include <cstdlib>
-#include <atomic>
-#include <new>
+#include <cstring>
 #include <vector>
 
 // BulletPhysics
@@ -24,66 +23,12 @@
 #include "ballistics/external/environments/Wind.h"
 #include "geography/CoordinateMapping.h"
 
-using namespace BulletPhysics;
-
-// allocation tracker
-static std::atomic<bool> g_tracking{false};
-static std::atomic<std::size_t> g_allocCount{0};
-static std::atomic<std::size_t> g_allocBytes{0};
-static std::atomic<std::size_t> g_freeCount{0};
-
-void* operator new(std::size_t size)
-{
-    if (g_tracking.load(std::memory_order_relaxed))
-    {
-        g_allocCount.fetch_add(1, std::memory_order_relaxed);
-        g_allocBytes.fetch_add(size, std::memory_order_relaxed);
-    }
-
-    void* ptr = std::malloc(size);
-    if (!ptr)
-        throw std::bad_alloc();
-
-    return ptr;
-}
-
-void operator delete(void* ptr) noexcept
-{
-    if (ptr && g_tracking.load(std::memory_order_relaxed))
-    {
-        g_freeCount.fetch_add(1, std::memory_order_relaxed);
-    }
-
-    std::free(ptr);
-}
-
-void operator delete(void* ptr, std::size_t) noexcept
-{
-    if (ptr && g_tracking.load(std::memory_order_relaxed))
-    {
-        g_freeCount.fetch_add(1, std::memory_order_relaxed);
-    }
-
-    std::free(ptr);
-}
-
-static void resetCounters()
-{
-    g_allocCount.store(0, std::memory_order_relaxed);
-    g_allocBytes.store(0, std::memory_order_relaxed);
-    g_freeCount.store(0, std::memory_order_relaxed);
-}
-
-static void startTracking()
-{
-    resetCounters();
-    g_tracking.store(true, std::memory_order_seq_cst);
-}
+// BulletEngine
+#include "core/AllocationTracker.h"
 
-static void stopTracking()
-{
-    g_tracking.store(false, std::memory_order_seq_cst);
-}
+using namespace BulletPhysics;
+using BulletEngine::core::AllocationTracker;
+using BulletEngine::core::AllocationScope;
 
 // simulation parameters
 static constexpr double DT = 0.001;
@@ -107,11 +52,13 @@ struct TestResult
     const char* integrator;
     std::size_t allocations;
     std::size_t bytes;
-    std::size_t frees;
+    long long liveBytes;
 };
 
 static TestResult runTest(const char* name, math::IIntegrator& integrator, ballistics::external::PhysicsWorld& world)
 {
+    auto& tracker = AllocationTracker::instance();
+
     // setup phase (allocations allowed)
     std::vector<builtin::bodies::ProjectileRigidBody> bodies;
     bodies.reserve(BODY_COUNT);
@@ -120,25 +67,37 @@ static TestResult runTest(const char* name, math::IIntegrator& integrator, balli
         bodies.push_back(makeBody());
     }
 
-    // hot loop (allocations tracked)
-    startTracking();
+    // setup counts go to a frame of their own
+    tracker.endFrame();
+    long long liveBefore = tracker.getLiveBytes();
 
-    for (int step = 0; step < HOT_STEPS; ++step)
+    // hot loop (allocations tracked), one frame under the integrator tag
     {
-        for (auto& body : bodies)
+        AllocationScope scope(tracker.registerTag(name));
+
+        for (int step = 0; step < HOT_STEPS; ++step)
         {
-            integrator.step(body, &world, DT);
+            for (auto& body : bodies)
+            {
+                integrator.step(body, &world, DT);
+            }
         }
     }
 
-    stopTracking();
+    long long liveAfter = tracker.getLiveBytes();
+    tracker.endFrame();
 
-    return {
-        name,
-        g_allocCount.load(),
-        g_allocBytes.load(),
-        g_freeCount.load()
-    };
+    std::vector<AllocationTracker::TagStats> stats;
+    tracker.stats(stats);
+    for (const auto& tag : stats)
+    {
+        if (std::strcmp(tag.name, name) == 0)
+        {
+            return {name, tag.allocations, tag.bytes, liveAfter - liveBefore};
+        }
+    }
+
+    return {name, 0, 0, 0};
 }
 
 int main()
@@ -174,6 +133,25 @@ int main()
         {"rk4", &rk4},
     };
 
+    // integrator steps must not allocate, counted through the operator new linked into this test
+    auto& tracker = AllocationTracker::instance();
+    if (tracker.getAllocations() == 0)
+    {
+        std::cout << "FAIL: allocations not counted, operator new is not replaced\n";
+        return 1;
+    }
+
+    AllocationTracker::Budget budget;
+    budget.maxAllocations = 0;
+
+    std::vector<AllocationTracker::Violation> violations;
+    tracker.setViolationHandler([&violations](const AllocationTracker::Violation& violation) { violations.push_back(violation); });
+
+    for (auto& test : tests)
+    {
+        tracker.setBudget(test.name, budget);
+    }
+
     // run tests
     std::vector<TestResult> results;
     results.reserve(tests.size());
@@ -188,8 +166,13 @@ int main()
 
     for (const auto& result : results)
     {
-        std::cout << result.integrator << ": " << result.allocations << " allocations, " << result.bytes << " bytes, " << result.frees << " frees\n";
+        std::cout << result.integrator << ": " << result.allocations << " allocations, " << result.bytes << " bytes, " << result.liveBytes << " bytes still live\n";
+    }
+
+    for (const auto& violation : violations)
+    {
+        std::cout << "budget exceeded: " << violation.tag << "\n";
     }
 
-    return 0;
+    return violations.empty() ? 0 : 1;
 }
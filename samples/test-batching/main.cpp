@@ -0,0 +1,149 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// BulletEngine
+#include "rendering/InstanceBatcher.h"
+#include "core/AllocationTracker.h"
+#include "common/Test.h"
+
+using namespace BulletEngine;
+using test::expect;
+
+// scene parameters
+static constexpr int MODEL_COUNT = 3;
+static constexpr int SHADER_COUNT = 2;
+static constexpr int INSTANCE_COUNT = 3000;
+static constexpr int FRAMES = 10;
+
+// batcher only compares model and shader addresses, so no gl context is needed
+alignas(16) static char g_models[MODEL_COUNT][16];
+alignas(16) static char g_shaders[SHADER_COUNT][16];
+
+static BulletRender::scene::Model* model(int index)
+{
+    return reinterpret_cast<BulletRender::scene::Model*>(g_models[index]);
+}
+
+static std::shared_ptr<BulletRender::render::Shader> shader(int index)
+{
+    // non-owning
+    return std::shared_ptr<BulletRender::render::Shader>(std::shared_ptr<void>(), reinterpret_cast<BulletRender::render::Shader*>(g_shaders[index]));
+}
+
+// counts what a backend receives
+class CountingRenderer : public rendering::InstanceRenderer {
+public:
+    void draw(const rendering::InstanceBatch& batch) override
+    {
+        batches++;
+        instances += batch.transforms.size();
+
+        if (batch.transforms.size() != batch.colors.size())
+        {
+            mismatched = true;
+        }
+    }
+
+    std::size_t batches = 0;
+    std::size_t instances = 0;
+    bool mismatched = false;
+};
+
+static void fillFrame(rendering::InstanceBatcher& batcher, const std::vector<std::shared_ptr<BulletRender::render::Shader>>& shaders, int frame)
+{
+    batcher.begin();
+
+    // interleaved so that unbatched submission switches state on every object
+    for (int i = 0; i < INSTANCE_COUNT; ++i)
+    {
+        glm::mat4 transform(1.0f);
+        transform[3] = glm::vec4(float(i), float(frame), 0.0f, 1.0f);
+
+        batcher.add(model(i % MODEL_COUNT), model(i % MODEL_COUNT), shaders[i % SHADER_COUNT], transform, glm::vec3(float(i % MODEL_COUNT)));
+    }
+
+    batcher.end();
+}
+
+int main()
+{
+    std::vector<std::shared_ptr<BulletRender::render::Shader>> shaders;
+    for (int i = 0; i < SHADER_COUNT; ++i)
+    {
+        shaders.push_back(shader(i));
+    }
+
+    rendering::InstanceBatcher batcher;
+    CountingRenderer renderer;
+
+    // first frame creates the batches
+    fillFrame(batcher, shaders, 0);
+    batcher.submit(renderer);
+
+    // warm frames must not allocate, counted through the operator new linked into this test
+    auto& tracker = core::AllocationTracker::instance();
+    expect(tracker.getAllocations() > 0, "allocations are counted");
+    uint64_t warmAllocations = 0;
+    for (int frame = 1; frame < FRAMES; ++frame)
+    {
+        uint64_t allocationsBefore = tracker.getAllocations();
+
+        fillFrame(batcher, shaders, frame);
+        batcher.submit(renderer);
+
+        warmAllocations += tracker.getAllocations() - allocationsBefore;
+    }
+
+    const auto& stats = batcher.stats();
+
+    // model and shader cycle with coprime periods, so every pair is present
+    const std::size_t pairs = MODEL_COUNT * SHADER_COUNT;
+
+    expect(stats.instances == INSTANCE_COUNT, "instance count");
+    expect(stats.batches == pairs, "one batch per (model, shader)");
+    expect(stats.shaderChanges == SHADER_COUNT, "one bind per shader");
+    expect(stats.modelChanges == pairs, "one model bind per batch");
+    expect(renderer.batches == pairs * FRAMES, "renderer batches");
+    expect(renderer.instances == std::size_t(INSTANCE_COUNT) * FRAMES, "renderer instances");
+    expect(!renderer.mismatched, "transform and color arrays of equal length");
+    expect(warmAllocations == 0, "no allocations after first frame");
+
+    // batches hold the instances of their pair only
+    for (const auto* batch : batcher.batches())
+    {
+        int modelIndex = int(reinterpret_cast<char*>(batch->model) - g_models[0]) / 16;
+        for (std::size_t i = 0; i < batch->transforms.size(); ++i)
+        {
+            int instance = int(batch->transforms[i][3].x);
+            expect(instance % MODEL_COUNT == modelIndex, "instance sorted into its model batch");
+            expect(batch->colors[i].x == float(modelIndex), "color follows transform");
+        }
+    }
+
+    // report
+    std::cout << "instances: " << stats.instances << ", frames: " << FRAMES << "\n\n";
+    std::cout << "submission order: " << INSTANCE_COUNT << " objects, " << 2 * INSTANCE_COUNT << " state changes\n";
+    std::cout << "batch order: " << stats.batches << " batches, " << stats.stateChanges() << " state changes\n";
+    std::cout << "warm frame allocations: " << warmAllocations << "\n\n";
+
+    // batches left empty for a frame are dropped at the next begin
+    batcher.begin();
+    batcher.add(model(0), model(0), shaders[0], glm::mat4(1.0f), glm::vec3(0.0f));
+    batcher.end();
+    expect(batcher.storedBatches() == pairs, "empty batches kept through the frame");
+
+    batcher.begin();
+    batcher.end();
+    expect(batcher.storedBatches() == 1, "batches empty last frame dropped");
+    expect(batcher.batches().empty(), "no batches drawn in an empty frame");
+
+    return test::report();
+}
@@ -3,9 +3,8 @@
  */
 
 // std
-#include <iostream>
-#include <fstream>
 #include <cmath>
+#include <sstream>
 #include <vector>
 
 // BulletPhysics
@@ -16,10 +15,13 @@
 #include "ballistics/external/forces/Force.h"
 #include "geography/CoordinateMapping.h"
 
+// BulletEngine
+#include "bench/Harness.h"
+
 using namespace BulletPhysics;
 
-// exit file
-static constexpr std::string_view FILE_NAME = "convergence.csv";
+// exit files, convergence.json and convergence.csv
+static constexpr std::string_view FILE_NAME = "convergence";
 
 // simulation parameters
 static constexpr double MASS = 1.0;
@@ -100,27 +102,51 @@ static double error(const math::Vec3& result, const math::Vec3& reference)
     return std::sqrt(dx * dx + dy * dy + dz * dz);
 }
 
-int main()
+int main(int argc, char** argv)
 {
     geography::CoordinateMapping::set(geography::mappings::OpenGL());
 
     math::Vec3 reference = analytical(DT);
 
-    std::ofstream file((FILE_NAME.data()));
-    file << "dt,method,error\n";
+    BulletEngine::bench::Harness::Config defaults;
+    defaults.output = FILE_NAME;
+    BulletEngine::bench::Harness harness(BulletEngine::bench::Harness::parseArgs(argc, argv, defaults));
+
+    math::EulerIntegrator euler;
+    math::MidpointIntegrator midpoint;
+    math::RK4Integrator rk4;
+
+    struct Entry {
+        const char* name;
+        math::IIntegrator* integrator;
+    };
 
+    Entry entries[] = {
+        {"euler", &euler},
+        {"midpoint", &midpoint},
+        {"rk4", &rk4},
+    };
+
+    // error at the end of the interval next to the cost of one step
     for (double dt : DTS)
     {
-        math::EulerIntegrator euler;
-        math::MidpointIntegrator midpoint;
-        math::RK4Integrator rk4;
-
-        file << dt << ",euler," << error(simulate(euler, dt), reference) << "\n";
-        file << dt << ",midpoint," << error(simulate(midpoint, dt), reference) << "\n";
-        file << dt << ",rk4," << error(simulate(rk4, dt), reference) << "\n";
+        std::ostringstream label;
+        label << dt;
+
+        for (auto& entry : entries)
+        {
+            double steps = std::ceil(DT / dt);
+
+            harness.add("integrate", {{"dt", label.str()}, {"method", entry.name}}, [dt, method = entry.integrator](uint64_t iterations) {
+                    for (uint64_t i = 0; i < iterations; ++i)
+                        BulletEngine::bench::doNotOptimize(simulate(*method, dt));
+                })
+                .withItems(steps)
+                .withMetric("error", error(simulate(*entry.integrator, dt), reference));
+        }
     }
 
-    std::cout << "done " << FILE_NAME <<"\n";
+    harness.run();
 
     return 0;
 }
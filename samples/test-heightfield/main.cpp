@@ -0,0 +1,139 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// BulletEngine
+#include "collision/Heightfield.h"
+#include "common/Test.h"
+
+using namespace BulletEngine;
+using test::expect;
+
+// terrain parameters, edges do not fall on tile boundaries
+static constexpr uint32_t WIDTH = 300;
+static constexpr uint32_t DEPTH = 200;
+static constexpr uint32_t TILE_CELLS = 64;
+static constexpr float CELL_SIZE = 2.0f;         // m
+static constexpr float ORIGIN_X = -100.0f;
+static constexpr float ORIGIN_Z = 50.0f;
+static constexpr int RAYS = 1000;
+static constexpr double EPSILON = 1e-3;
+
+static const std::string FILE_NAME = "test-heightfield.behf";
+static const std::string BROKEN_NAME = "test-heightfield-broken.behf";
+
+static float height(uint32_t x, uint32_t z)
+{
+    return 20.0f * std::sin(0.05f * static_cast<float>(x)) * std::cos(0.03f * static_cast<float>(z)) + 0.1f * static_cast<float>(x);
+}
+
+static std::vector<char> readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// writes a copy of the valid file with the header changed, true if load rejects it
+static bool rejects(const std::vector<char>& bytes, void (*corrupt)(collision::HeightfieldHeader&), size_t truncate = 0)
+{
+    std::vector<char> copy(bytes.begin(), bytes.end() - static_cast<std::ptrdiff_t>(truncate));
+    corrupt(*reinterpret_cast<collision::HeightfieldHeader*>(copy.data()));
+
+    {
+        std::ofstream file(BROKEN_NAME, std::ios::binary);
+        file.write(copy.data(), static_cast<std::streamsize>(copy.size()));
+    }
+
+    bool rejected = collision::Heightfield::load(BROKEN_NAME) == nullptr;
+    std::remove(BROKEN_NAME.c_str());
+    return rejected;
+}
+
+int main()
+{
+    std::vector<float> heights(static_cast<size_t>(WIDTH) * DEPTH);
+    for (uint32_t z = 0; z < DEPTH; z++)
+    {
+        for (uint32_t x = 0; x < WIDTH; x++)
+        {
+            heights[static_cast<size_t>(z) * WIDTH + x] = height(x, z);
+        }
+    }
+
+    expect(collision::Heightfield::write(FILE_NAME, heights.data(), WIDTH, DEPTH, CELL_SIZE, ORIGIN_X, ORIGIN_Z, TILE_CELLS), "write");
+
+    auto terrain = collision::Heightfield::load(FILE_NAME);
+    expect(terrain != nullptr, "load written file");
+    if (!terrain)
+    {
+        return test::report();
+    }
+
+    // samples come back exactly, outside the raster there is no terrain
+    bool samplesMatch = true;
+    for (uint32_t z = 0; z < DEPTH; z += 7)
+    {
+        for (uint32_t x = 0; x < WIDTH; x += 5)
+        {
+            auto h = terrain->heightAt(ORIGIN_X + x * CELL_SIZE, ORIGIN_Z + z * CELL_SIZE);
+            samplesMatch &= h && std::abs(*h - height(x, z)) < EPSILON;
+        }
+    }
+    expect(samplesMatch, "heights at samples");
+    expect(!terrain->heightAt(ORIGIN_X - 1.0, ORIGIN_Z), "no height before origin");
+    expect(!terrain->heightAt(ORIGIN_X + WIDTH * CELL_SIZE, ORIGIN_Z), "no height past the edge");
+
+    // rays straight down land on the surface
+    int hits = 0;
+    bool onSurface = true;
+    for (int i = 0; i < RAYS; i++)
+    {
+        double x = ORIGIN_X + (WIDTH - 1) * CELL_SIZE * ((i * 37) % RAYS) / RAYS;
+        double z = ORIGIN_Z + (DEPTH - 1) * CELL_SIZE * ((i * 61) % RAYS) / RAYS;
+
+        auto hit = terrain->raycast({x, 200.0, z}, {0.0, -1.0, 0.0}, 400.0);
+        auto h = terrain->heightAt(x, z);
+        if (hit && h)
+        {
+            hits++;
+            onSurface &= std::abs(hit->position.y - *h) < EPSILON && hit->normal.y > 0.0;
+        }
+    }
+    expect(hits == RAYS, "every ray down hits");
+    expect(onSurface, "hits on the surface, normals up");
+
+    // ray above the terrain misses
+    expect(!terrain->raycast({ORIGIN_X, 200.0, ORIGIN_Z}, {1.0, 0.0, 1.0}, 1000.0), "level ray above terrain misses");
+
+    // malformed files are rejected
+    auto bytes = readFile(FILE_NAME);
+    expect(!rejects(bytes, [](collision::HeightfieldHeader&) {}), "copy of valid file loads");
+    expect(rejects(bytes, [](collision::HeightfieldHeader& header) { header.tilesX++; }), "tilesX not matching width");
+    expect(rejects(bytes, [](collision::HeightfieldHeader& header) { header.tilesZ--; }), "tilesZ not matching depth");
+    expect(rejects(bytes, [](collision::HeightfieldHeader& header) { header.width = 1u << 31; }), "width beyond the tiles");
+    expect(rejects(bytes, [](collision::HeightfieldHeader& header) { header.tileCells = 3; }), "tile size not a power of two");
+    expect(rejects(bytes, [](collision::HeightfieldHeader& header) { header.dataOffset += 4; }), "unaligned data offset");
+    expect(rejects(bytes, [](collision::HeightfieldHeader& header) { header.dataOffset = sizeof(collision::HeightfieldHeader); }), "data over the tile table");
+    expect(rejects(bytes, [](collision::HeightfieldHeader&) {}, sizeof(float)), "truncated file");
+    expect(rejects(bytes, [](collision::HeightfieldHeader& header) { header.cellSize = 0.0f; }), "zero cell size");
+
+    std::remove(FILE_NAME.c_str());
+
+    // report
+    const auto& header = terrain->getHeader();
+    std::cout << "terrain: " << header.width << "x" << header.depth << " samples, " << header.tilesX << "x" << header.tilesZ << " tiles, "
+              << terrain->getTouchedTiles() << " tiles touched by " << RAYS << " rays\n\n";
+
+    return test::report();
+}
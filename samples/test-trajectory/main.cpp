@@ -0,0 +1,196 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// BulletEngine
+#include "rendering/TrajectoryBuffer.h"
+#include "rendering/NullBackend.h"
+#include "common/Test.h"
+
+using namespace BulletEngine;
+using test::expect;
+
+// test parameters
+static constexpr double RANGE = 1000.0;             // m
+static constexpr double SAMPLE_SPACING = 0.75;      // m
+static constexpr double MUZZLE_VELOCITY = 750.0;    // m/s
+static constexpr float TOLERANCE = 0.01f;           // m
+static constexpr size_t MAX_FLIGHT_POINTS = 16;     // kept points of the flight at tolerance
+static constexpr size_t HELIX_SAMPLES = 20000;
+static constexpr int DRIFT_ZIGZAG = 100;
+static constexpr size_t CAPPED_POINTS = 1000;
+static constexpr size_t CAPPED_TRACKS = 64;
+static constexpr float EPSILON = 1e-4f;             // float rounding of the distance check
+
+static float distanceToSegment(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b)
+{
+    glm::vec3 ab = b - a;
+    float lengthSq = glm::dot(ab, ab);
+    float t = lengthSq > 0.0f ? std::clamp(glm::dot(p - a, ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+    return glm::length(p - (a + ab * t));
+}
+
+// flat fire at 750 m/s under gravity, samples at fixed spacing along the range
+static std::vector<glm::vec3> flight()
+{
+    std::vector<glm::vec3> samples;
+    for (double x = 0.0; x <= RANGE; x += SAMPLE_SPACING)
+    {
+        double t = x / MUZZLE_VELOCITY;
+        samples.push_back({static_cast<float>(x), static_cast<float>(1.5 - 0.5 * 9.81 * t * t), 0.0f});
+    }
+    return samples;
+}
+
+// tight curve, keeps many points
+static std::vector<glm::vec3> helix()
+{
+    std::vector<glm::vec3> samples;
+    for (size_t i = 0; i < HELIX_SAMPLES; i++)
+    {
+        float t = static_cast<float>(i) * 0.01f;
+        samples.push_back({std::cos(t) * 5.0f, t * 0.2f, std::sin(t) * 5.0f});
+    }
+    return samples;
+}
+
+// zigzag within tolerance of a line, then a slow drift that tilts the candidate segment
+// samples of the zigzag dropped from the check would end up just beyond tolerance
+static std::vector<glm::vec3> drift()
+{
+    std::vector<glm::vec3> samples;
+    for (int i = 0; i < DRIFT_ZIGZAG; i++)
+    {
+        samples.push_back({static_cast<float>(i), i % 2 != 0 ? 0.95f * TOLERANCE : 0.0f, 0.0f});
+    }
+    for (int i = DRIFT_ZIGZAG; i <= 2 * DRIFT_ZIGZAG; i++)
+    {
+        samples.push_back({static_cast<float>(i), -0.4f * TOLERANCE * static_cast<float>(i - DRIFT_ZIGZAG) / DRIFT_ZIGZAG, 0.0f});
+    }
+    return samples;
+}
+
+// kept points of a single colored track, read back as emitted at full detail
+static std::vector<glm::vec3> kept(rendering::TrajectoryBuffer& buffer, ecs::Entity entity)
+{
+    rendering::NullLines lines;
+    buffer.emit(entity, lines);
+
+    std::vector<glm::vec3> points;
+    for (const auto& segment : lines.segments())
+    {
+        if (points.empty())
+        {
+            points.push_back(segment.a);
+        }
+        points.push_back(segment.b);
+    }
+    return points;
+}
+
+// every sample lies within tolerance of the kept segment spanning it, returns the largest distance
+static float maxDeviation(const std::vector<glm::vec3>& samples, const std::vector<glm::vec3>& points)
+{
+    float deviation = 0.0f;
+    size_t segment = 0;
+
+    for (const auto& sample : samples)
+    {
+        deviation = std::max(deviation, distanceToSegment(sample, points[segment], points[segment + 1]));
+
+        // kept points are samples, reaching the end of a segment moves on to the next
+        if (sample == points[segment + 1] && segment + 2 < points.size())
+        {
+            segment++;
+        }
+    }
+    return deviation;
+}
+
+int main()
+{
+    rendering::SimplifyTolerance tolerance;
+    tolerance.distance = TOLERANCE;
+
+    const glm::vec3 color{1.0f, 0.5f, 0.0f};
+
+    // smooth flight keeps few points, every sample stays within tolerance
+    auto flightSamples = flight();
+
+    rendering::TrajectoryBuffer buffer;
+
+    using Clock = std::chrono::steady_clock;
+    auto t0 = Clock::now();
+    for (const auto& sample : flightSamples)
+    {
+        buffer.record(1, sample, color, tolerance);
+    }
+    auto t1 = Clock::now();
+
+    auto flightPoints = kept(buffer, 1);
+    float flightDeviation = maxDeviation(flightSamples, flightPoints);
+
+    expect(flightPoints.size() >= 2 && flightPoints.front() == flightSamples.front() && flightPoints.back() == flightSamples.back(), "flight ends kept");
+    expect(flightDeviation <= TOLERANCE + EPSILON, "flight samples within tolerance");
+    expect(flightPoints.size() <= MAX_FLIGHT_POINTS, "flight point count");
+    expect(buffer.size() == flightPoints.size(), "buffer holds kept points only");
+
+    // curve far beyond the check window still holds the bound
+    auto helixSamples = helix();
+    for (const auto& sample : helixSamples)
+    {
+        buffer.record(2, sample, color, tolerance);
+    }
+
+    auto helixPoints = kept(buffer, 2);
+    float helixDeviation = maxDeviation(helixSamples, helixPoints);
+
+    expect(helixDeviation <= TOLERANCE + EPSILON, "helix samples within tolerance");
+    expect(helixPoints.size() < helixSamples.size() / 4, "helix simplified");
+
+    // every sample is checked against every candidate segment, also once the check window merged it
+    auto driftSamples = drift();
+    for (const auto& sample : driftSamples)
+    {
+        buffer.record(3, sample, color, tolerance);
+    }
+
+    auto driftPoints = kept(buffer, 3);
+    float driftDeviation = maxDeviation(driftSamples, driftPoints);
+
+    expect(driftDeviation <= TOLERANCE + EPSILON, "drift samples within tolerance");
+
+    // full buffer trims the longest track, short ones keep every point
+    rendering::TrajectoryBuffer capped(CAPPED_POINTS);
+    for (size_t i = 0; i < 4 * CAPPED_POINTS; i++)
+    {
+        glm::vec3 point{static_cast<float>(i), 0.0f, 0.0f};
+        capped.append(1, point, color);
+        if (i % 100 == 0)
+        {
+            capped.append(2 + (i / 100) % CAPPED_TRACKS, point, color);
+        }
+    }
+
+    size_t shortPoints = capped.size() - kept(capped, 1).size();
+
+    expect(capped.size() == CAPPED_POINTS, "capped buffer size");
+    expect(shortPoints == 4 * CAPPED_POINTS / 100, "short tracks kept");
+    expect(kept(capped, 1).back() == glm::vec3(4 * CAPPED_POINTS - 1, 0.0f, 0.0f), "longest track keeps newest point");
+
+    // report
+    std::cout << "flight: " << flightSamples.size() << " samples, " << flightPoints.size() << " points, max deviation " << flightDeviation * 1000.0f << " mm, "
+              << std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(flightSamples.size()) << " ns/sample\n";
+    std::cout << "helix: " << helixSamples.size() << " samples, " << helixPoints.size() << " points, max deviation " << helixDeviation * 1000.0f << " mm\n";
+    std::cout << "drift: " << driftSamples.size() << " samples, " << driftPoints.size() << " points, max deviation " << driftDeviation * 1000.0f << " mm\n\n";
+
+    return test::report();
+}
@@ -0,0 +1,142 @@
+/*
+ * main.cpp
+ */
+
+// std
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// BulletEngine
+#include "core/TransformArray.h"
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "ecs/systems/TransformSystem.h"
+#include "common/Test.h"
+
+using namespace BulletEngine;
+using test::expect;
+
+// test parameters
+static constexpr uint32_t TRANSFORM_COUNT = 100000;
+static constexpr int FRAMES = 50;
+static constexpr float EPSILON = 1e-4f;
+
+static bool near(float a, float b)
+{
+    return std::abs(a - b) < EPSILON;
+}
+
+// deterministic velocity of transform i in frame f
+static glm::vec3 velocity(uint32_t i, int f)
+{
+    float a = 0.001f * static_cast<float>(i) + 0.01f * static_cast<float>(f);
+    return {std::cos(a) * 300.0f, std::sin(a * 0.7f) * 50.0f - 10.0f, std::sin(a) * 20.0f};
+}
+
+int main()
+{
+    core::TransformArray transforms;
+
+    std::vector<uint32_t> slots(TRANSFORM_COUNT);
+    for (auto& slot : slots)
+    {
+        slot = transforms.allocate();
+    }
+
+    expect(reinterpret_cast<uintptr_t>(transforms.matrices()) % core::TransformArray::ALIGNMENT == 0, "matrix array aligned");
+    expect(transforms.compose().size() == TRANSFORM_COUNT, "new slots are dirty");
+    expect(transforms.compose().empty(), "compose clears dirty mask");
+
+    // model axis +y follows velocity, scale and position land in the matrix
+    const glm::vec3 forward{0.0f, 1.0f, 0.0f};
+    for (uint32_t i = 0; i < TRANSFORM_COUNT; i++)
+    {
+        transforms.setPosition(slots[i], {static_cast<float>(i), 1.0f, -2.0f});
+        transforms.setScale(slots[i], {0.5f, 2.0f, 0.5f});
+        transforms.setDirection(slots[i], forward, velocity(i, 0));
+    }
+    transforms.compose();
+
+    for (uint32_t i = 0; i < TRANSFORM_COUNT; i += 97)
+    {
+        const auto& m = transforms.matrix(slots[i]);
+        glm::vec3 v = velocity(i, 0);
+        v = v / glm::length(v);
+
+        glm::vec3 axes[3];
+        transforms.axes(slots[i], axes);
+
+        expect(near(axes[1].x, v.x) && near(axes[1].y, v.y) && near(axes[1].z, v.z), "model axis along velocity");
+        expect(near(glm::length(axes[0]), 1.0f) && near(glm::length(axes[2]), 1.0f), "unit axes");
+        expect(near(glm::dot(axes[0], axes[1]), 0.0f) && near(glm::dot(axes[1], axes[2]), 0.0f), "orthogonal axes");
+        expect(near(m[1][0], 2.0f * v.x) && near(m[0][0], 0.5f * axes[0].x), "scaled columns");
+        expect(m[3][0] == static_cast<float>(i) && m[3][1] == 1.0f && m[3][2] == -2.0f && m[3][3] == 1.0f, "translation column");
+    }
+
+    // opposite direction takes the half turn branch
+    transforms.setDirection(slots[0], forward, {0.0f, -3.0f, 0.0f});
+    transforms.compose();
+    expect(near(transforms.matrix(slots[0])[1][1], -2.0f), "half turn");
+
+    // unchanged values do not dirty, only touched slots are composed
+    transforms.setPosition(slots[5], {5.0f, 1.0f, -2.0f});
+    expect(!transforms.isDirty(slots[5]), "same value keeps slot clean");
+    transforms.setPosition(slots[7], {0.0f, 0.0f, 0.0f});
+    transforms.setPosition(slots[TRANSFORM_COUNT - 1], {0.0f, 0.0f, 0.0f});
+    const auto& composed = transforms.compose();
+    expect(composed.size() == 2 && composed[0] == slots[7] && composed[1] == slots[TRANSFORM_COUNT - 1], "only dirty slots reported");
+
+    // released slots are reused
+    transforms.release(slots[3]);
+    expect(transforms.allocate() == slots[3], "slot reused");
+
+    // body stops following velocity once its align axis is cleared, as on impact, and keeps the last aligned rotation
+    {
+        ecs::World world;
+        ecs::systems::TransformSystemBase transformSystem;
+
+        auto entity = world.create();
+        world.add<ecs::TransformComponent>(entity).alignAxis = forward;
+        world.add<ecs::RigidBodyComponent>(entity).body->setVelocity({300.0, 0.0, 0.0});
+        transformSystem.update(world);
+
+        world.get<ecs::TransformComponent>(entity)->alignAxis = glm::vec3{0.0f};
+        world.get<ecs::RigidBodyComponent>(entity)->body->setVelocity({0.0, -50.0, 10.0});
+        transformSystem.update(world);
+
+        glm::vec3 axes[3];
+        transformSystem.getTransforms().axes(transformSystem.getSlot(entity), axes);
+        expect(near(axes[1].x, 1.0f) && near(axes[1].y, 0.0f) && near(axes[1].z, 0.0f), "cleared align axis keeps last aligned rotation");
+    }
+
+    // timing, every transform moves every frame
+    using Clock = std::chrono::steady_clock;
+    double gatherMs = 0.0;
+    double composeMs = 0.0;
+
+    for (int f = 1; f <= FRAMES; f++)
+    {
+        auto t0 = Clock::now();
+        for (uint32_t i = 0; i < TRANSFORM_COUNT; i++)
+        {
+            transforms.setPosition(slots[i], {static_cast<float>(i), static_cast<float>(f), 0.0f});
+            transforms.setDirection(slots[i], forward, velocity(i, f));
+        }
+        auto t1 = Clock::now();
+        transforms.compose();
+        auto t2 = Clock::now();
+
+        gatherMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        composeMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+
+    // report
+    std::cout << "transforms: " << TRANSFORM_COUNT << ", frames: " << FRAMES << "\n";
+    std::cout << "set: " << gatherMs / FRAMES << " ms/frame, compose: " << composeMs / FRAMES << " ms/frame, "
+              << composeMs * 1e6 / FRAMES / TRANSFORM_COUNT << " ns/matrix\n\n";
+
+    return test::report();
+}
@@ -0,0 +1,312 @@
+/*
+ * main.cpp
+ */
+
+// BulletRender, window only
+#ifndef BULLET_ENGINE_HEADLESS
+#include "app/Window.h"
+#include "app/Loop.h"
+#include "render/passes/Grid.h"
+#include "render/passes/Lines.h"
+#include "render/Renderer.h"
+#include "scene/Scene.h"
+#include "scene/Camera.h"
+#include "scene/Light.h"
+#endif
+
+// std
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+
+// BulletPhysics
+#include "math/Integrator.h"
+#include "builtin/collision/collider/GroundCollider.h"
+#include "ballistics/external/PhysicsWorld.h"
+#include "ballistics/external/environments/Atmosphere.h"
+#include "ballistics/external/forces/Gravity.h"
+#include "ballistics/external/forces/drag/Drag.h"
+#include "geography/CoordinateMapping.h"
+
+// BulletEngine
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "ecs/systems/PhysicsSystem.h"
+#include "ecs/systems/RenderSystem.h"
+#include "ecs/systems/TransformSystem.h"
+#include "core/SimulationThread.h"
+#include "core/Histogram.h"
+#include "core/Profiler.h"
+#include "rendering/FrameSnapshot.h"
+#include "rendering/NullBackend.h"
+#include "assets/AssetCache.h"
+#include "common/Components.h"
+#include "common/systems/CollisionSystem.h"
+#include "common/systems/TrajectorySystem.h"
+#include "common/objects/Projectile.h"
+
+#ifndef BULLET_ENGINE_HEADLESS
+#include "ecs/systems/InputSystem.h"
+#include "rendering/SceneInstanceRenderer.h"
+#endif
+
+using namespace BulletEngine;
+
+// simulation parameters
+static constexpr double PHYSICS_DT = 0.001;
+static constexpr int STEPS_PER_PUBLISH = 4;
+static constexpr int FIRE_EVERY_FRAMES = 10;
+
+// input crossing from render to simulation thread
+struct InputEvent {
+    enum class Type { FIRE } type = Type::FIRE;
+    double azimuth = 90.0;
+};
+
+using Simulation = core::SimulationThread<rendering::FrameSnapshot, InputEvent>;
+
+// grounded projectiles stop, same as the windowed samples
+class PhysicsSystem : public ecs::systems::PhysicsSystemBase {
+public:
+    using PhysicsSystemBase::PhysicsSystemBase;
+
+protected:
+    bool beforeIntegrate(ecs::World& world, ecs::Entity entity, ecs::RigidBodyComponent&, float) override
+    {
+        auto* projectileComponent = world.get<ecs::ProjectileRigidBodyComponent>(entity);
+        return !projectileComponent || !projectileComponent->isGrounded;
+    }
+};
+
+#ifndef BULLET_ENGINE_HEADLESS
+// render thread of the windowed run, draws the latest snapshot, space fires
+static int runWindowed(Simulation& simulation, assets::AssetCache& assetCache, const glm::vec3& eye)
+{
+    BulletRender::app::WindowConfig windowCfg{800, 600, "Threaded Simulation", true, true};
+    if (!BulletRender::app::Window::init(windowCfg))
+    {
+        return -1;
+    }
+
+    BulletRender::render::RenderConfig renderCfg{{0.05f, 0.05f, 0.08f, 1.0f}};
+    BulletRender::render::Renderer::init(renderCfg);
+
+    auto grid = std::make_shared<BulletRender::render::Grid>();
+    BulletRender::render::Renderer::registerPrePass(grid);
+
+    auto lines = std::make_shared<BulletRender::render::Lines>(2.0f);
+    BulletRender::render::Renderer::registerPrePass(lines);
+    rendering::LinesAdapter lineSink(lines);
+
+    BulletRender::scene::Scene scene;
+
+    BulletRender::scene::FlyCamera camera(eye);
+    scene.setCamera(&camera);
+
+    BulletRender::scene::DirectionalLight light;
+    scene.setLight(&light);
+
+    // models and shaders requested by the simulation thread are built here in assetCache.update
+    rendering::SceneInstanceRenderer instanceRenderer(scene);
+    ecs::systems::RenderSystemBase renderSystem(instanceRenderer);
+
+    // render thread is the only producer of input events
+    ecs::systems::InputSystem inputSystem;
+    inputSystem.bind(BulletRender::utils::InputKey::SPACE, [&simulation]() {
+        simulation.post({InputEvent::Type::FIRE, 90.0});
+    });
+    inputSystem.bind(BulletRender::utils::InputKey::ESCAPE, []() {
+        BulletRender::app::Window::setShouldClose(true);
+    });
+
+    BulletRender::app::Loop loop(scene);
+    loop.run(
+        [&](float dt) {
+            camera.update(BulletRender::app::Window::get(), dt);
+
+            BulletRender::utils::Input::instance().update(BulletRender::app::Window::get());
+
+            simulation.acquire();
+            const auto& snapshot = simulation.latest();
+
+            rendering::SnapshotLines::replay(snapshot, lineSink);
+            assetCache.update();
+            renderSystem.render(snapshot);
+
+            core::Profiler::instance().endFrame();
+            core::AllocationTracker::instance().endFrame();
+        }
+    );
+
+    BulletRender::app::Window::shutdown();
+    return 0;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    // render side load, stall simulates slow frames, window draws through gl instead
+    double seconds = 5.0;
+    double frameMs = 16.0;
+    double stallMs = 0.0;
+    bool windowed = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--window") windowed = true;
+        else if (arg == "--seconds" && i + 1 < argc) seconds = std::strtod(argv[++i], nullptr);
+        else if (arg == "--frame-ms" && i + 1 < argc) frameMs = std::strtod(argv[++i], nullptr);
+        else if (arg == "--stall-ms" && i + 1 < argc) stallMs = std::strtod(argv[++i], nullptr);
+    }
+
+#ifdef BULLET_ENGINE_HEADLESS
+    if (windowed)
+    {
+        std::cerr << "--window is not available in a HEADLESS build\n";
+        return 1;
+    }
+#endif
+
+    BulletPhysics::geography::CoordinateMapping::set(BulletPhysics::geography::mappings::OpenGL());
+
+    // render thread backends of the headless run
+    rendering::NullLines lines;
+    rendering::NullInstanceRenderer instanceRenderer;
+    ecs::systems::RenderSystemBase renderSystem(instanceRenderer);
+
+    // uploads only with a gl context
+    assets::AssetCache assetCache(windowed);
+    objects::Projectile::assets = &assetCache;
+
+    // simulation thread state, only touched from callbacks below
+    ecs::World world;
+    auto snapshotLines = std::make_shared<rendering::SnapshotLines>();
+
+    ecs::systems::TransformSystemBase transformSystem;
+    ecs::systems::CollisionSystem collisionSystem;
+    ecs::systems::TrajectorySystem trajectorySystem(snapshotLines);
+
+    BulletPhysics::ballistics::external::PhysicsWorld physicsWorld;
+    BulletPhysics::math::MidpointIntegrator integrator;
+    PhysicsSystem physicsSystem(physicsWorld, integrator);
+
+    physicsWorld.addForce(std::make_unique<BulletPhysics::ballistics::external::forces::Gravity>());
+    physicsWorld.addEnvironment(std::make_unique<BulletPhysics::ballistics::external::environments::Atmosphere>(280.0, 100000.0));
+    physicsWorld.addForce(std::make_unique<BulletPhysics::ballistics::external::forces::Drag>());
+
+    auto ground = world.create();
+    auto& groundCollider = world.add<ecs::ColliderComponent>(ground);
+    groundCollider.collider = std::make_shared<BulletPhysics::builtin::collision::collider::GroundCollider>(0.0f);
+    groundCollider.layer = ecs::CollisionLayer::GROUND;
+    groundCollider.mask = ecs::CollisionLayer::PROJECTILE;
+
+    const glm::vec3 eye{0.0f, 3.0f, 8.0f};
+    double simTime = 0.0;
+    uint64_t simSteps = 0;
+
+    Simulation::Config simConfig;
+    simConfig.stepDt = PHYSICS_DT;
+    simConfig.stepsPerPublish = STEPS_PER_PUBLISH;
+
+    Simulation::Callbacks callbacks;
+    callbacks.onEvent = [&](const InputEvent& event) {
+        auto specs = BulletPhysics::projectile::ProjectileSpecs::create(0.01, 0.00762)
+            .withDragModel(BulletPhysics::ballistics::external::forces::drag::DragCurveModel::G7)
+            .withMuzzle(400.0, BulletPhysics::projectile::Direction::RIGHT, 12.0);
+        objects::Projectile::launch(world, specs, {0.0, 1.5, 0.0}, 2.0, event.azimuth);
+    };
+    callbacks.step = [&](double dt) {
+        physicsSystem.update(world, static_cast<float>(dt));
+        collisionSystem.update(world);
+        trajectorySystem.update(world);
+        simTime += dt;
+        simSteps++;
+    };
+    callbacks.publish = [&](rendering::FrameSnapshot& snapshot) {
+        snapshot.clear();
+        snapshot.step = simSteps;
+        snapshot.simTime = simTime;
+
+        // presentation state only for published steps
+        transformSystem.update(world);
+
+        ecs::systems::RenderSystemBase::extract(world, snapshot.instances);
+
+        snapshotLines->setTarget(&snapshot);
+        trajectorySystem.render(world, eye);
+        snapshotLines->setTarget(nullptr);
+    };
+
+    Simulation simulation(simConfig, callbacks);
+    simulation.start();
+
+#ifndef BULLET_ENGINE_HEADLESS
+    if (windowed)
+    {
+        int result = runWindowed(simulation, assetCache, eye);
+        simulation.stop();
+        return result;
+    }
+#endif
+
+    // render loop, consumes latest complete snapshot
+    core::Histogram frameTimes;
+    uint64_t frames = 0;
+    uint64_t freshFrames = 0;
+    uint64_t lastStep = 0;
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto previous = start;
+
+    while (std::chrono::duration<double>(Clock::now() - start).count() < seconds)
+    {
+        if (frames % FIRE_EVERY_FRAMES == 0)
+        {
+            simulation.post({InputEvent::Type::FIRE, 85.0 + static_cast<double>(frames / FIRE_EVERY_FRAMES % 10)});
+        }
+
+        if (simulation.acquire())
+        {
+            freshFrames++;
+        }
+
+        const auto& snapshot = simulation.latest();
+        lastStep = snapshot.step;
+
+        rendering::SnapshotLines::replay(snapshot, lines);
+        assetCache.update();
+        renderSystem.render(snapshot);
+
+        lines.endFrame();
+        instanceRenderer.endFrame();
+        core::Profiler::instance().endFrame();
+        core::AllocationTracker::instance().endFrame();
+
+        // frame budget, every tenth frame stalls
+        double work = frameMs + (frames % 10 == 9 ? stallMs : 0.0);
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(work));
+
+        auto now = Clock::now();
+        frameTimes.record(std::chrono::duration<double>(now - previous).count());
+        previous = now;
+        frames++;
+    }
+
+    simulation.stop();
+
+    // report
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "wall: " << wall << " s, simulated: " << simTime << " s, steps: " << simulation.getSteps() << ", dropped: " << simulation.getDroppedSteps() << "\n";
+    std::cout << "frames: " << frames << ", with new snapshot: " << freshFrames << ", last snapshot step: " << lastStep << "\n";
+    std::cout << "last frame: " << instanceRenderer.getLastFrameInstances() << " instances, " << lines.getLastFrameSegments() << " line segments\n\n";
+
+    frameTimes.print(std::cout, "frame time");
+    simulation.getStepTimes().print(std::cout, "sim step time");
+    simulation.getPublishIntervals().print(std::cout, "snapshot interval");
+
+    return 0;
+}
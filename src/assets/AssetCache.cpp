@@ -0,0 +1,347 @@
+/*
+ * AssetCache.cpp
+ */
+
+#include "AssetCache.h"
+
+#include "core/Profiler.h"
+
+#include <iostream>
+
+// linux
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace BulletEngine {
+namespace assets {
+
+// headless builds have no gl context to upload into
+#ifdef BULLET_ENGINE_HEADLESS
+static constexpr bool CAN_UPLOAD = false;
+#else
+static constexpr bool CAN_UPLOAD = true;
+#endif
+
+// read buffer of the loader thread
+static constexpr size_t READ_CHUNK = 64 * 1024;
+
+// reads the whole file so Model(path) finds it in the page cache, false if it is missing or empty
+static bool warmFile(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    static thread_local std::vector<char> buffer(READ_CHUNK);
+    size_t total = 0;
+    ssize_t count = 0;
+    while ((count = ::read(fd, buffer.data(), buffer.size())) > 0)
+    {
+        total += static_cast<size_t>(count);
+    }
+
+    ::close(fd);
+    return count == 0 && total > 0;
+}
+
+AssetCache::AssetCache(bool upload) : m_upload(upload && CAN_UPLOAD), m_retired(std::make_shared<Retired>()), m_loader(&AssetCache::loaderMain, this) {}
+
+AssetCache::~AssetCache()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_loader.join();
+
+    // handles dropped from now on delete their assets in place
+    std::vector<ModelAsset*> retired;
+    {
+        std::lock_guard lock(m_retired->mutex);
+        m_retired->closed = true;
+        retired.swap(m_retired->models);
+        m_retired->shaders.clear();
+    }
+
+    for (auto* asset : retired)
+    {
+        delete asset;
+    }
+}
+
+ModelHandle AssetCache::makeAsset(const std::string& key)
+{
+    // handles may outlive the cache, the deleter only holds the retired list
+    std::weak_ptr<Retired> retired = m_retired;
+    return ModelHandle(new ModelAsset(key), [retired](ModelAsset* asset) { retire(retired, asset); });
+}
+
+void AssetCache::retire(const std::weak_ptr<Retired>& retired, ModelAsset* asset)
+{
+    if (auto list = retired.lock())
+    {
+        std::lock_guard lock(list->mutex);
+        if (!list->closed)
+        {
+            list->models.push_back(asset);
+            return;
+        }
+    }
+
+    // cache is gone, no render thread to defer to
+    delete asset;
+}
+
+void AssetCache::retire(const std::weak_ptr<Retired>& retired, ShaderAsset* asset)
+{
+    // only the gl shader waits for update, scene objects may still hold it then
+    if (auto list = retired.lock())
+    {
+        std::lock_guard lock(list->mutex);
+        if (!list->closed && asset->m_shader)
+        {
+            list->shaders.push_back(std::move(asset->m_shader));
+        }
+    }
+
+    delete asset;
+}
+
+ModelHandle AssetCache::model(const std::string& path)
+{
+    std::lock_guard cacheLock(m_cacheMutex);
+
+    if (auto existing = m_models[path].lock())
+    {
+        return existing;
+    }
+
+    auto asset = makeAsset(path);
+    asset->m_placeholder = m_placeholder;
+    m_models[path] = asset;
+
+    m_pending.fetch_add(1, std::memory_order_acq_rel);
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back({asset, path});
+    }
+    m_wake.notify_one();
+
+    return asset;
+}
+
+ModelHandle AssetCache::box(float width, float height, float depth)
+{
+    std::string key = "box:" + std::to_string(width) + ":" + std::to_string(height) + ":" + std::to_string(depth);
+    std::lock_guard cacheLock(m_cacheMutex);
+
+    if (auto existing = m_models[key].lock())
+    {
+        return existing;
+    }
+
+    auto asset = makeAsset(key);
+    asset->m_placeholder = m_placeholder;
+    m_models[key] = asset;
+
+    // nothing to build without upload
+    if (m_upload)
+    {
+        m_boxJobs.push_back({asset, width, height, depth});
+    }
+    else
+    {
+        asset->m_ready.store(true, std::memory_order_release);
+    }
+    return asset;
+}
+
+ShaderHandle AssetCache::shader(const std::string& vertexPath, const std::string& fragmentPath)
+{
+    if (!m_upload)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard cacheLock(m_cacheMutex);
+
+    auto& entry = m_shaders[vertexPath + "|" + fragmentPath];
+    if (auto existing = entry.lock())
+    {
+        return existing;
+    }
+
+    std::weak_ptr<Retired> retired = m_retired;
+    ShaderHandle shader(new ShaderAsset(vertexPath, fragmentPath), [retired](ShaderAsset* asset) { retire(retired, asset); });
+    entry = shader;
+    m_shaderJobs.push_back(shader);
+    return shader;
+}
+
+void AssetCache::setPlaceholder(std::shared_ptr<BulletRender::scene::Model> placeholder)
+{
+    std::lock_guard cacheLock(m_cacheMutex);
+    if (m_placeholder)
+    {
+        m_replacedPlaceholders.push_back(std::move(m_placeholder));
+    }
+    m_placeholder = std::move(placeholder);
+}
+
+void AssetCache::update()
+{
+    BE_PROFILE_SCOPE("assets");
+
+    std::vector<Result> results;
+    {
+        std::lock_guard lock(m_mutex);
+        results.swap(m_results);
+    }
+
+    std::vector<ModelAsset*> retired;
+    std::vector<std::shared_ptr<BulletRender::render::Shader>> retiredShaders;
+    {
+        std::lock_guard lock(m_retired->mutex);
+        retired.swap(m_retired->models);
+        retiredShaders.swap(m_retired->shaders);
+    }
+
+    for (auto* asset : retired)
+    {
+        delete asset;
+    }
+    retiredShaders.clear();
+
+    // gl objects requested since last update, maybe from another thread
+    std::vector<BoxJob> boxJobs;
+    std::vector<std::weak_ptr<ShaderAsset>> shaderJobs;
+    {
+        std::lock_guard cacheLock(m_cacheMutex);
+        boxJobs.swap(m_boxJobs);
+        shaderJobs.swap(m_shaderJobs);
+    }
+
+    for (const auto& job : boxJobs)
+    {
+        if (auto asset = job.asset.lock())
+        {
+            asset->m_model = std::make_unique<BulletRender::scene::Box>(job.width, job.height, job.depth);
+            asset->m_placeholder.reset();
+            asset->m_ready.store(true, std::memory_order_release);
+        }
+    }
+
+    for (const auto& job : shaderJobs)
+    {
+        if (auto asset = job.lock())
+        {
+            asset->m_shader = std::make_shared<BulletRender::render::Shader>(asset->m_vertexPath, asset->m_fragmentPath);
+            asset->m_ready.store(true, std::memory_order_release);
+        }
+    }
+
+    for (auto& result : results)
+    {
+        auto asset = result.asset.lock();
+        if (!asset)
+        {
+            continue;
+        }
+
+        if (result.ok)
+        {
+            // file is in the page cache, parse and upload are one step in BulletRender
+            if (m_upload)
+            {
+                BE_PROFILE_SCOPE("assets/upload");
+                asset->m_model = std::make_unique<BulletRender::scene::Model>(asset->m_path);
+            }
+            asset->m_placeholder.reset();
+            asset->m_ready.store(true, std::memory_order_release);
+        }
+        else
+        {
+            asset->m_failed.store(true, std::memory_order_release);
+            std::cerr << "AssetCache: failed to load " << asset->m_path << std::endl;
+        }
+    }
+
+    m_pending.fetch_sub(results.size(), std::memory_order_acq_rel);
+
+    // drop entries whose last handle is gone
+    std::lock_guard cacheLock(m_cacheMutex);
+    std::erase_if(m_models, [](const auto& entry) { return entry.second.expired(); });
+    std::erase_if(m_shaders, [](const auto& entry) { return entry.second.expired(); });
+}
+
+size_t AssetCache::modelCount() const
+{
+    std::lock_guard cacheLock(m_cacheMutex);
+    return m_models.size();
+}
+
+size_t AssetCache::shaderCount() const
+{
+    std::lock_guard cacheLock(m_cacheMutex);
+    return m_shaders.size();
+}
+
+void AssetCache::finish()
+{
+    while (pendingCount() > 0)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_done.wait(lock, [&] { return !m_results.empty(); });
+        }
+        update();
+    }
+}
+
+void AssetCache::loaderMain()
+{
+#ifdef BULLET_ENGINE_PROFILE
+    core::Profiler::instance().setThreadName("asset loader");
+#endif
+
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || !m_jobs.empty(); });
+
+            if (m_stopping)
+            {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        Result result;
+        result.asset = job.asset;
+
+        // skip reading if every handle was dropped while queued
+        if (!job.asset.expired())
+        {
+            BE_PROFILE_SCOPE("assets/load");
+            result.ok = warmFile(job.path);
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_results.push_back(std::move(result));
+        }
+        m_done.notify_all();
+    }
+}
+
+} // namespace assets
+} // namespace BulletEngine
@@ -0,0 +1,160 @@
+/*
+ * AssetCache.h
+ */
+
+#pragma once
+
+#include "scene/Model.h"
+#include "render/Shader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace BulletEngine {
+namespace assets {
+
+// shared model, resolves to placeholder until loaded
+class ModelAsset {
+public:
+    explicit ModelAsset(std::string path) : m_path(std::move(path)) {}
+
+    // model or placeholder, may be nullptr if there is no placeholder
+    BulletRender::scene::Model* get() const { return m_model ? m_model.get() : m_placeholder.get(); }
+
+    // loaded, without a model when the cache does not upload
+    bool isReady() const { return m_ready.load(std::memory_order_acquire); }
+    bool isFailed() const { return m_failed.load(std::memory_order_acquire); }
+    const std::string& getPath() const { return m_path; }
+
+private:
+    friend class AssetCache;
+
+    std::string m_path;
+    std::unique_ptr<BulletRender::scene::Model> m_model;
+    std::shared_ptr<BulletRender::scene::Model> m_placeholder;
+    std::atomic<bool> m_ready{false};
+    std::atomic<bool> m_failed{false};
+};
+
+// shared shader, built by the cache on the render thread
+class ShaderAsset {
+public:
+    ShaderAsset(std::string vertexPath, std::string fragmentPath) : m_vertexPath(std::move(vertexPath)), m_fragmentPath(std::move(fragmentPath)) {}
+
+    // nullptr until built, render thread only
+    const std::shared_ptr<BulletRender::render::Shader>& get() const { return m_shader; }
+
+    bool isReady() const { return m_ready.load(std::memory_order_acquire); }
+    const std::string& getVertexPath() const { return m_vertexPath; }
+    const std::string& getFragmentPath() const { return m_fragmentPath; }
+
+private:
+    friend class AssetCache;
+
+    std::string m_vertexPath;
+    std::string m_fragmentPath;
+    std::shared_ptr<BulletRender::render::Shader> m_shader;
+    std::atomic<bool> m_ready{false};
+};
+
+using ModelHandle = std::shared_ptr<ModelAsset>;
+using ShaderHandle = std::shared_ptr<ShaderAsset>;
+
+// deduplicates models and shaders by path, assets are freed when their last handle drops
+// obj files are read into the page cache on a loader thread, Model(path) parses and uploads them in update on the calling thread
+// BulletRender models can only be built from a path, so the parse itself can not move off the render thread
+// handles may be requested and dropped on a simulation thread, every gl object is created and freed in update
+class AssetCache {
+public:
+    // without upload obj files are only read and shaders are not built, for runs without gl context, always off in HEADLESS builds
+    explicit AssetCache(bool upload = true);
+    ~AssetCache();
+
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    // returns immediately, handle shows placeholder until update finishes it
+    ModelHandle model(const std::string& path);
+
+    // built in next update
+    ModelHandle box(float width, float height, float depth);
+    ShaderHandle shader(const std::string& vertexPath, const std::string& fragmentPath);
+
+    // shown while a model loads, nullptr hides it, replaced placeholders live as long as the cache
+    void setPlaceholder(std::shared_ptr<BulletRender::scene::Model> placeholder);
+
+    // build queued boxes and shaders, upload finished meshes and forget dropped assets, call once per frame from render thread
+    void update();
+
+    // block until all requested models are ready or failed
+    void finish();
+
+    size_t pendingCount() const { return m_pending.load(std::memory_order_acquire); }
+    size_t modelCount() const;
+    size_t shaderCount() const;
+
+private:
+    struct Job {
+        std::weak_ptr<ModelAsset> asset;
+        std::string path;
+    };
+
+    struct Result {
+        std::weak_ptr<ModelAsset> asset;
+        bool ok = false;
+    };
+
+    struct BoxJob {
+        std::weak_ptr<ModelAsset> asset;
+        float width;
+        float height;
+        float depth;
+    };
+
+    // assets whose last handle dropped, shared with handle deleters so handles may outlive the cache
+    struct Retired {
+        std::mutex mutex;
+        std::vector<ModelAsset*> models;
+        std::vector<std::shared_ptr<BulletRender::render::Shader>> shaders;
+        bool closed = false;
+    };
+
+    void loaderMain();
+
+    // deleters of handles
+    ModelHandle makeAsset(const std::string& key);
+    static void retire(const std::weak_ptr<Retired>& retired, ModelAsset* asset);
+    static void retire(const std::weak_ptr<Retired>& retired, ShaderAsset* asset);
+
+    bool m_upload;
+    std::shared_ptr<Retired> m_retired;
+
+    // guards maps, build queues and placeholder, requests and update may run on different threads
+    mutable std::mutex m_cacheMutex;
+    std::unordered_map<std::string, std::weak_ptr<ModelAsset>> m_models;
+    std::unordered_map<std::string, std::weak_ptr<ShaderAsset>> m_shaders;
+    std::vector<BoxJob> m_boxJobs;
+    std::vector<std::weak_ptr<ShaderAsset>> m_shaderJobs;
+    std::shared_ptr<BulletRender::scene::Model> m_placeholder;
+    std::vector<std::shared_ptr<BulletRender::scene::Model>> m_replacedPlaceholders;   // hidden scene objects may still point at them
+
+    // loader thread
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::deque<Job> m_jobs;
+    std::vector<Result> m_results;
+    std::atomic<size_t> m_pending{0};
+    bool m_stopping = false;
+    std::thread m_loader;
+};
+
+} // namespace assets
+} // namespace BulletEngine
@@ -0,0 +1,242 @@
+/*
+ * MeshCache.cpp
+ */
+
+#include "MeshCache.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// linux
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace BulletEngine {
+namespace assets {
+
+static constexpr char MAGIC[4] = {'B', 'E', 'M', 'S'};
+static constexpr uint32_t VERSION = 1;
+static constexpr uint64_t ALIGN = 16;
+
+static uint64_t alignUp(uint64_t value)
+{
+    return (value + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+// map whole file read only, size 0 files are not mapped
+static void* mapFile(const std::string& path, size_t& size)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    return mapping == MAP_FAILED ? nullptr : mapping;
+}
+
+MappedMesh::~MappedMesh()
+{
+    if (m_mapping)
+    {
+        munmap(m_mapping, m_mappingSize);
+    }
+}
+
+std::unique_ptr<MappedMesh> MappedMesh::open(const std::string& path)
+{
+    size_t size = 0;
+    void* mapping = mapFile(path, size);
+    if (!mapping)
+    {
+        return nullptr;
+    }
+
+    // whole file is read front to back, advice values are not flags and go in separate calls
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    madvise(mapping, size, MADV_WILLNEED);
+
+    std::unique_ptr<MappedMesh> mesh(new MappedMesh());
+    mesh->m_mapping = mapping;
+    mesh->m_mappingSize = size;
+
+    if (size < sizeof(MeshFileHeader))
+    {
+        return nullptr;
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(mapping);
+    const auto* header = reinterpret_cast<const MeshFileHeader*>(bytes);
+
+    // validate
+    uint64_t vertexBytes = uint64_t(header->vertexCount) * header->floatsPerVertex * sizeof(float);
+    uint64_t indexBytes = uint64_t(header->indexCount) * sizeof(uint32_t);
+
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->floatsPerVertex != MeshData::FLOATS_PER_VERTEX || header->indexCount % 3 != 0 ||
+        header->vertexOffset < sizeof(MeshFileHeader) || header->vertexOffset % ALIGN != 0 || header->indexOffset % ALIGN != 0 ||
+        header->vertexOffset + vertexBytes > header->indexOffset || header->indexOffset + indexBytes > size)
+    {
+        return nullptr;
+    }
+
+    mesh->m_header = header;
+    mesh->m_vertices = reinterpret_cast<const float*>(bytes + header->vertexOffset);
+    mesh->m_indices = reinterpret_cast<const uint32_t*>(bytes + header->indexOffset);
+
+    // reject out of range indices here so the loader can trust them
+    for (uint32_t index : mesh->indices())
+    {
+        if (index >= header->vertexCount)
+        {
+            return nullptr;
+        }
+    }
+
+    return mesh;
+}
+
+void MappedMesh::copyTo(MeshData& mesh) const
+{
+    auto v = vertices();
+    auto i = indices();
+    mesh.vertices.assign(v.begin(), v.end());
+    mesh.indices.assign(i.begin(), i.end());
+}
+
+bool hashFile(const std::string& path, uint64_t& hash, uint64_t& size)
+{
+    size_t length = 0;
+    void* mapping = mapFile(path, length);
+    if (!mapping)
+    {
+        return false;
+    }
+
+    madvise(mapping, length, MADV_SEQUENTIAL);
+
+    // 64 bit multiply-xorshift over 8 byte words, tail byte by byte
+    const auto* bytes = static_cast<const uint8_t*>(mapping);
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ length;
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    for (; i < length; ++i)
+    {
+        h = (h ^ bytes[i]) * 0x100000001B3ull;
+    }
+
+    munmap(mapping, length);
+
+    hash = h;
+    size = length;
+    return true;
+}
+
+bool writeMeshFile(const std::string& path, const MeshData& mesh, uint64_t sourceHash, uint64_t sourceSize)
+{
+    MeshFileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    header.vertexCount = static_cast<uint32_t>(mesh.vertexCount());
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.floatsPerVertex = MeshData::FLOATS_PER_VERTEX;
+    header.vertexOffset = alignUp(sizeof(MeshFileHeader));
+    header.indexOffset = alignUp(header.vertexOffset + mesh.vertices.size() * sizeof(float));
+
+    // write aside and rename, a concurrent reader never sees a partial file
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+
+        static constexpr char PADDING[ALIGN] = {};
+        uint64_t offset = sizeof(MeshFileHeader);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(PADDING, static_cast<std::streamsize>(header.vertexOffset - offset));
+        file.write(reinterpret_cast<const char*>(mesh.vertices.data()), static_cast<std::streamsize>(mesh.vertices.size() * sizeof(float)));
+
+        offset = header.vertexOffset + mesh.vertices.size() * sizeof(float);
+        file.write(PADDING, static_cast<std::streamsize>(header.indexOffset - offset));
+        file.write(reinterpret_cast<const char*>(mesh.indices.data()), static_cast<std::streamsize>(mesh.indices.size() * sizeof(uint32_t)));
+
+        if (!file)
+        {
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+std::string meshCachePath(const std::string& objPath)
+{
+    return objPath + ".mesh";
+}
+
+bool loadMesh(const std::string& objPath, MeshData& mesh)
+{
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    if (!hashFile(objPath, hash, size))
+    {
+        return false;
+    }
+
+    std::string cachePath = meshCachePath(objPath);
+
+    // hashing the source is much cheaper than parsing it
+    if (auto cached = MappedMesh::open(cachePath))
+    {
+        if (cached->getHeader().sourceHash == hash && cached->getHeader().sourceSize == size)
+        {
+            cached->copyTo(mesh);
+            return true;
+        }
+    }
+
+    if (!loadObj(objPath, mesh))
+    {
+        return false;
+    }
+
+    // read only asset dirs just mean parsing every start
+    if (!writeMeshFile(cachePath, mesh, hash, size))
+    {
+        std::cerr << "warning: mesh cache " << cachePath << ": " << std::strerror(errno) << "\n";
+    }
+
+    return true;
+}
+
+} // namespace assets
+} // namespace BulletEngine
@@ -0,0 +1,72 @@
+/*
+ * MeshCache.h
+ */
+
+#pragma once
+
+#include "assets/MeshData.h"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace BulletEngine {
+namespace assets {
+
+// on-disk layout: header, vertex buffer, index buffer, both 16 byte aligned
+struct MeshFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceHash;        // hash of obj bytes the mesh was converted from
+    uint64_t sourceSize;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t floatsPerVertex;
+    uint32_t reserved;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+};
+
+// read only view of a memory mapped mesh file
+class MappedMesh {
+public:
+    ~MappedMesh();
+
+    MappedMesh(const MappedMesh&) = delete;
+    MappedMesh& operator=(const MappedMesh&) = delete;
+
+    // returns nullptr if file is missing or malformed
+    static std::unique_ptr<MappedMesh> open(const std::string& path);
+
+    const MeshFileHeader& getHeader() const { return *m_header; }
+    std::span<const float> vertices() const { return {m_vertices, size_t(m_header->vertexCount) * m_header->floatsPerVertex}; }
+    std::span<const uint32_t> indices() const { return {m_indices, m_header->indexCount}; }
+
+    void copyTo(MeshData& mesh) const;
+
+private:
+    MappedMesh() = default;
+
+    void* m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+
+    const MeshFileHeader* m_header = nullptr;
+    const float* m_vertices = nullptr;
+    const uint32_t* m_indices = nullptr;
+};
+
+// content hash of a file, false if it can not be read
+bool hashFile(const std::string& path, uint64_t& hash, uint64_t& size);
+
+bool writeMeshFile(const std::string& path, const MeshData& mesh, uint64_t sourceHash, uint64_t sourceSize);
+
+// binary cache next to the obj file
+std::string meshCachePath(const std::string& objPath);
+
+// load from cache if it matches the obj content, otherwise parse obj and write the cache
+// BulletRender builds models from obj paths only, so AssetCache does not go through here until it takes buffers
+bool loadMesh(const std::string& objPath, MeshData& mesh);
+
+} // namespace assets
+} // namespace BulletEngine
@@ -0,0 +1,200 @@
+/*
+ * MeshData.cpp
+ */
+
+#include "MeshData.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <unordered_map>
+
+namespace BulletEngine {
+namespace assets {
+
+namespace {
+
+struct Corner {
+    int32_t position;
+    int32_t normal;     // -1 if missing
+};
+
+const char* skipSpaces(const char* it, const char* end)
+{
+    while (it < end && (*it == ' ' || *it == '\t'))
+    {
+        ++it;
+    }
+    return it;
+}
+
+const char* parseFloat(const char* it, const char* end, float& value)
+{
+    it = skipSpaces(it, end);
+    auto result = std::from_chars(it, end, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+const char* parseIndex(const char* it, const char* end, int32_t count, int32_t& index)
+{
+    int32_t value = 0;
+    auto result = std::from_chars(it, end, value);
+    if (result.ec != std::errc() || value == 0)
+    {
+        return nullptr;
+    }
+
+    // one based, negative counts from the end
+    index = value > 0 ? value - 1 : count + value;
+    return result.ptr;
+}
+
+// v, v/t, v//n or v/t/n
+const char* parseCorner(const char* it, const char* end, int32_t positions, int32_t normals, Corner& corner)
+{
+    corner.normal = -1;
+
+    it = parseIndex(it, end, positions, corner.position);
+    if (!it || it >= end || *it != '/')
+    {
+        return it;
+    }
+
+    ++it;
+    if (it < end && *it != '/')
+    {
+        int32_t texcoord = 0;
+        it = parseIndex(it, end, 1 << 30, texcoord);
+        if (!it)
+        {
+            return nullptr;
+        }
+    }
+
+    if (it < end && *it == '/')
+    {
+        it = parseIndex(it + 1, end, normals, corner.normal);
+    }
+    return it;
+}
+
+} // namespace
+
+bool loadObj(const std::string& path, MeshData& mesh)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    mesh.vertices.clear();
+    mesh.indices.clear();
+
+    std::vector<std::array<float, 3>> positions;
+    std::vector<std::array<float, 3>> normals;
+
+    // one output vertex per distinct (position, normal)
+    std::unordered_map<uint64_t, uint32_t> unique;
+    std::vector<Corner> face;
+
+    auto emit = [&](const Corner& corner, const std::array<float, 3>& faceNormal) -> uint32_t {
+        // flat normals are never shared between faces
+        if (corner.normal < 0)
+        {
+            uint32_t index = static_cast<uint32_t>(mesh.vertexCount());
+            const auto& p = positions[corner.position];
+            mesh.vertices.insert(mesh.vertices.end(), {p[0], p[1], p[2], faceNormal[0], faceNormal[1], faceNormal[2]});
+            return index;
+        }
+
+        uint64_t key = (uint64_t(uint32_t(corner.position)) << 32) | uint32_t(corner.normal);
+        auto [it, inserted] = unique.try_emplace(key, static_cast<uint32_t>(mesh.vertexCount()));
+        if (inserted)
+        {
+            const auto& p = positions[corner.position];
+            const auto& n = normals[corner.normal];
+            mesh.vertices.insert(mesh.vertices.end(), {p[0], p[1], p[2], n[0], n[1], n[2]});
+        }
+        return it->second;
+    };
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        const char* it = line.data();
+        const char* end = it + line.size();
+
+        if (line.size() > 2 && line[0] == 'v' && (line[1] == ' ' || line[1] == 'n'))
+        {
+            bool isNormal = line[1] == 'n';
+            std::array<float, 3> value{};
+
+            it += isNormal ? 2 : 1;
+            for (auto& component : value)
+            {
+                it = it ? parseFloat(it, end, component) : nullptr;
+            }
+            if (!it)
+            {
+                return false;
+            }
+
+            (isNormal ? normals : positions).push_back(value);
+        }
+        else if (line.size() > 2 && line[0] == 'f' && line[1] == ' ')
+        {
+            face.clear();
+            it += 1;
+
+            while (true)
+            {
+                it = skipSpaces(it, end);
+                if (it >= end || *it == '\r')
+                {
+                    break;
+                }
+
+                Corner corner{};
+                it = parseCorner(it, end, int32_t(positions.size()), int32_t(normals.size()), corner);
+                if (!it || corner.position < 0 || corner.position >= int32_t(positions.size()) || corner.normal >= int32_t(normals.size()))
+                {
+                    return false;
+                }
+                face.push_back(corner);
+            }
+
+            if (face.size() < 3)
+            {
+                continue;
+            }
+
+            for (size_t i = 1; i + 1 < face.size(); ++i)
+            {
+                const auto& a = positions[face[0].position];
+                const auto& b = positions[face[i].position];
+                const auto& c = positions[face[i + 1].position];
+
+                std::array<float, 3> e1{b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+                std::array<float, 3> e2{c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+                std::array<float, 3> n{e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+
+                float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (length > 0.0f)
+                {
+                    n = {n[0] / length, n[1] / length, n[2] / length};
+                }
+
+                mesh.indices.push_back(emit(face[0], n));
+                mesh.indices.push_back(emit(face[i], n));
+                mesh.indices.push_back(emit(face[i + 1], n));
+            }
+        }
+    }
+
+    return !mesh.indices.empty();
+}
+
+} // namespace assets
+} // namespace BulletEngine
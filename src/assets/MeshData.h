@@ -0,0 +1,28 @@
+/*
+ * MeshData.h
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BulletEngine {
+namespace assets {
+
+// cpu side mesh, interleaved position and normal per vertex
+struct MeshData {
+    static constexpr size_t FLOATS_PER_VERTEX = 6;
+
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+
+    size_t vertexCount() const { return vertices.size() / FLOATS_PER_VERTEX; }
+};
+
+// parse wavefront obj, faces are fan triangulated, missing normals are taken from faces
+bool loadObj(const std::string& path, MeshData& mesh);
+
+} // namespace assets
+} // namespace BulletEngine
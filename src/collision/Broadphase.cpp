@@ -0,0 +1,91 @@
+/*
+ * Broadphase.cpp
+ */
+
+#include "Broadphase.h"
+
+namespace BulletEngine {
+namespace collision {
+
+void Broadphase::clear()
+{
+    m_proxies.clear();
+
+    for (size_t i = 0; i < m_groupCount; i++)
+    {
+        m_groups[i].members.clear();
+    }
+    m_groupCount = 0;
+}
+
+void Broadphase::add(ecs::Entity entity, BulletPhysics::builtin::collision::collider::Collider* collider, uint32_t layer, uint32_t mask)
+{
+    auto index = static_cast<uint32_t>(m_proxies.size());
+    m_proxies.push_back({entity, collider, layer, mask});
+
+    // find group, number of distinct layer/mask combinations is small
+    for (size_t i = 0; i < m_groupCount; i++)
+    {
+        if (m_groups[i].layer == layer && m_groups[i].mask == mask)
+        {
+            m_groups[i].members.push_back(index);
+            return;
+        }
+    }
+
+    if (m_groupCount == m_groups.size())
+    {
+        m_groups.emplace_back();
+    }
+
+    auto& group = m_groups[m_groupCount++];
+    group.layer = layer;
+    group.mask = mask;
+    group.members.push_back(index);
+}
+
+void Broadphase::findPairs(std::vector<Pair>& pairs) const
+{
+    pairs.clear();
+
+    for (size_t i = 0; i < m_groupCount; i++)
+    {
+        const auto& groupA = m_groups[i];
+
+        for (size_t j = i; j < m_groupCount; j++)
+        {
+            const auto& groupB = m_groups[j];
+
+            if (!canCollide(groupA.layer, groupA.mask, groupB.layer, groupB.mask))
+            {
+                continue;
+            }
+
+            if (i == j)
+            {
+                // pairs inside group
+                for (size_t a = 0; a < groupA.members.size(); a++)
+                {
+                    for (size_t b = a + 1; b < groupA.members.size(); b++)
+                    {
+                        pairs.push_back({groupA.members[a], groupA.members[b]});
+                    }
+                }
+            }
+            else
+            {
+                // pairs across groups
+                for (auto a : groupA.members)
+                {
+                    for (auto b : groupB.members)
+                    {
+                        pairs.push_back({a, b});
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace collision
+} // namespace BulletEngine
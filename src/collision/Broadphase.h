@@ -0,0 +1,61 @@
+/*
+ * Broadphase.h
+ */
+
+#pragma once
+
+#include "ecs/Ecs.h"
+
+#include "builtin/collision/collider/Collider.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BulletEngine {
+namespace collision {
+
+// collider registered for one detection pass
+struct Proxy {
+    ecs::Entity entity = 0;
+    BulletPhysics::builtin::collision::collider::Collider* collider = nullptr;
+    uint32_t layer = 0;
+    uint32_t mask = 0;
+};
+
+// candidate pair, indices into proxies
+struct Pair {
+    uint32_t a = 0;
+    uint32_t b = 0;
+};
+
+class Broadphase {
+public:
+    void clear();
+    void add(ecs::Entity entity, BulletPhysics::builtin::collision::collider::Collider* collider, uint32_t layer, uint32_t mask);
+
+    // emit pairs allowed by layer/mask, filtered per group so rejected pairs are never enumerated
+    void findPairs(std::vector<Pair>& pairs) const;
+
+    static bool canCollide(uint32_t layerA, uint32_t maskA, uint32_t layerB, uint32_t maskB)
+    {
+        return (layerA & maskB) != 0 && (layerB & maskA) != 0;
+    }
+
+    const Proxy& proxy(uint32_t index) const { return m_proxies[index]; }
+    const std::vector<Proxy>& proxies() const { return m_proxies; }
+
+private:
+    // proxies sharing the same layer and mask
+    struct Group {
+        uint32_t layer = 0;
+        uint32_t mask = 0;
+        std::vector<uint32_t> members;
+    };
+
+    std::vector<Proxy> m_proxies;
+    std::vector<Group> m_groups;
+    size_t m_groupCount = 0;    // groups in use, vectors beyond are kept for reuse
+};
+
+} // namespace collision
+} // namespace BulletEngine
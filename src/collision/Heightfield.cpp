@@ -0,0 +1,664 @@
+/*
+ * Heightfield.cpp
+ */
+
+#include "Heightfield.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// linux
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace BulletEngine {
+namespace collision {
+
+static constexpr char MAGIC[4] = {'B', 'E', 'H', 'F'};
+static constexpr uint32_t VERSION = 1;
+static constexpr uint64_t PAGE_ALIGN = 4096;
+
+// large finite value instead of inf, keeps slab test free of nan
+static constexpr float BIG = 1e30f;
+
+static float inverse(float d)
+{
+    return d != 0.0f ? 1.0f / d : std::copysign(BIG, d);
+}
+
+static bool isPowerOfTwo(uint32_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// slab test against box, returns entry distance clamped to zero
+template<class R>
+static bool rayBox(const R& ray, float minX, float minY, float minZ, float maxX, float maxY, float maxZ, float tLimit, float& tEnter)
+{
+    float tx0 = (minX - ray.ox) * ray.invX;
+    float tx1 = (maxX - ray.ox) * ray.invX;
+    float ty0 = (minY - ray.oy) * ray.invY;
+    float ty1 = (maxY - ray.oy) * ray.invY;
+    float tz0 = (minZ - ray.oz) * ray.invZ;
+    float tz1 = (maxZ - ray.oz) * ray.invZ;
+
+    float tNear = std::max({std::min(tx0, tx1), std::min(ty0, ty1), std::min(tz0, tz1), 0.0f});
+    float tFar = std::min({std::max(tx0, tx1), std::max(ty0, ty1), std::max(tz0, tz1), tLimit});
+
+    tEnter = tNear;
+    return tNear <= tFar;
+}
+
+Heightfield::~Heightfield()
+{
+    if (m_mapping)
+    {
+        munmap(m_mapping, m_mappingSize);
+    }
+}
+
+std::shared_ptr<Heightfield> Heightfield::load(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "error: heightfield " << path << ": " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(HeightfieldHeader))
+    {
+        std::cerr << "error: heightfield " << path << ": file too small\n";
+        ::close(fd);
+        return nullptr;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "error: heightfield " << path << ": mmap failed: " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+
+    // queries jump around, no point reading ahead
+    madvise(mapping, static_cast<size_t>(st.st_size), MADV_RANDOM);
+
+    std::shared_ptr<Heightfield> heightfield(new Heightfield());
+    heightfield->m_mapping = mapping;
+    heightfield->m_mappingSize = static_cast<size_t>(st.st_size);
+
+    const auto* bytes = static_cast<const uint8_t*>(mapping);
+    const auto* header = reinterpret_cast<const HeightfieldHeader*>(bytes);
+
+    // validate, tile counts derived like write does, sizes compared by division so a bad header cannot overflow
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        !isPowerOfTwo(header->tileCells) || header->width < 2 || header->depth < 2 || !(header->cellSize > 0.0f) ||
+        header->tilesX != (static_cast<uint64_t>(header->width) - 1 + header->tileCells - 1) / header->tileCells ||
+        header->tilesZ != (static_cast<uint64_t>(header->depth) - 1 + header->tileCells - 1) / header->tileCells)
+    {
+        std::cerr << "error: heightfield " << path << ": invalid header\n";
+        return nullptr;
+    }
+
+    uint64_t tileCount = static_cast<uint64_t>(header->tilesX) * header->tilesZ;
+    uint64_t tileSamples = (static_cast<uint64_t>(header->tileCells) + 1) * (static_cast<uint64_t>(header->tileCells) + 1);
+    uint64_t size = heightfield->m_mappingSize;
+    uint64_t tableEnd = tileCount <= size / (2 * sizeof(float)) ? sizeof(HeightfieldHeader) + tileCount * 2 * sizeof(float) : UINT64_MAX;
+
+    if (header->dataOffset % PAGE_ALIGN != 0 || header->dataOffset < tableEnd || header->dataOffset > size ||
+        (size - header->dataOffset) / sizeof(float) / tileCount < tileSamples)
+    {
+        std::cerr << "error: heightfield " << path << ": file size does not match header\n";
+        return nullptr;
+    }
+
+    heightfield->m_header = header;
+    heightfield->m_tileBounds = reinterpret_cast<const float*>(bytes + sizeof(HeightfieldHeader));
+    heightfield->m_tiles = reinterpret_cast<const float*>(bytes + header->dataOffset);
+
+    // pyramid over tiles, only touches the bounds table
+    uint32_t w = header->tilesX;
+    uint32_t d = header->tilesZ;
+
+    heightfield->m_tileLevels.emplace_back(heightfield->m_tileBounds, heightfield->m_tileBounds + tileCount * 2);
+    heightfield->m_tileLevelWidths.push_back(w);
+    heightfield->m_tileLevelDepths.push_back(d);
+
+    while (w > 1 || d > 1)
+    {
+        uint32_t nw = (w + 1) / 2;
+        uint32_t nd = (d + 1) / 2;
+
+        const auto& below = heightfield->m_tileLevels.back();
+        std::vector<float> level(static_cast<size_t>(nw) * nd * 2);
+
+        for (uint32_t j = 0; j < nd; j++)
+        {
+            for (uint32_t i = 0; i < nw; i++)
+            {
+                float lo = BIG;
+                float hi = -BIG;
+
+                for (uint32_t cj = j * 2; cj < std::min(j * 2 + 2, d); cj++)
+                {
+                    for (uint32_t ci = i * 2; ci < std::min(i * 2 + 2, w); ci++)
+                    {
+                        lo = std::min(lo, below[(cj * w + ci) * 2]);
+                        hi = std::max(hi, below[(cj * w + ci) * 2 + 1]);
+                    }
+                }
+
+                level[(j * nw + i) * 2] = lo;
+                level[(j * nw + i) * 2 + 1] = hi;
+            }
+        }
+
+        heightfield->m_tileLevels.push_back(std::move(level));
+        heightfield->m_tileLevelWidths.push_back(nw);
+        heightfield->m_tileLevelDepths.push_back(nd);
+
+        w = nw;
+        d = nd;
+    }
+
+    // layout of pyramid inside a tile
+    size_t offset = 0;
+    for (uint32_t n = header->tileCells; n > 0; n /= 2)
+    {
+        heightfield->m_cellLevelOffsets.push_back(offset);
+        offset += static_cast<size_t>(n) * n * 2;
+        heightfield->m_cellLevels++;
+    }
+
+    heightfield->m_tileCache = std::make_unique<Tile[]>(tileCount);
+
+    return heightfield;
+}
+
+bool Heightfield::write(const std::string& path, const float* heights, uint32_t width, uint32_t depth, float cellSize, float originX, float originZ, uint32_t tileCells)
+{
+    if (!heights || width < 2 || depth < 2 || !isPowerOfTwo(tileCells) || cellSize <= 0.0f)
+    {
+        return false;
+    }
+
+    HeightfieldHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.width = width;
+    header.depth = depth;
+    header.tileCells = tileCells;
+    header.tilesX = (width - 1 + tileCells - 1) / tileCells;
+    header.tilesZ = (depth - 1 + tileCells - 1) / tileCells;
+    header.cellSize = cellSize;
+    header.originX = originX;
+    header.originZ = originZ;
+
+    size_t tileCount = static_cast<size_t>(header.tilesX) * header.tilesZ;
+    size_t tileStride = tileCells + 1;
+
+    uint64_t tableEnd = sizeof(HeightfieldHeader) + tileCount * 2 * sizeof(float);
+    header.dataOffset = (tableEnd + PAGE_ALIGN - 1) / PAGE_ALIGN * PAGE_ALIGN;
+
+    // cut tiles, samples past the raster edge repeat the last row or column
+    std::vector<float> tiles(tileCount * tileStride * tileStride);
+    std::vector<float> bounds(tileCount * 2);
+
+    for (uint32_t tz = 0; tz < header.tilesZ; tz++)
+    {
+        for (uint32_t tx = 0; tx < header.tilesX; tx++)
+        {
+            size_t tileIndex = static_cast<size_t>(tz) * header.tilesX + tx;
+            float* tile = tiles.data() + tileIndex * tileStride * tileStride;
+
+            float lo = BIG;
+            float hi = -BIG;
+
+            for (uint32_t lz = 0; lz < tileStride; lz++)
+            {
+                uint32_t gz = std::min(tz * tileCells + lz, depth - 1);
+
+                for (uint32_t lx = 0; lx < tileStride; lx++)
+                {
+                    uint32_t gx = std::min(tx * tileCells + lx, width - 1);
+                    float h = heights[static_cast<size_t>(gz) * width + gx];
+
+                    tile[lz * tileStride + lx] = h;
+                    lo = std::min(lo, h);
+                    hi = std::max(hi, h);
+                }
+            }
+
+            bounds[tileIndex * 2] = lo;
+            bounds[tileIndex * 2 + 1] = hi;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<char> padding(header.dataOffset - tableEnd, 0);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(bounds.data()), static_cast<std::streamsize>(bounds.size() * sizeof(float)));
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    file.write(reinterpret_cast<const char*>(tiles.data()), static_cast<std::streamsize>(tiles.size() * sizeof(float)));
+
+    return static_cast<bool>(file);
+}
+
+const float* Heightfield::tileData(uint32_t tileX, uint32_t tileZ) const
+{
+    size_t stride = m_header->tileCells + 1;
+    size_t tileIndex = static_cast<size_t>(tileZ) * m_header->tilesX + tileX;
+    return m_tiles + tileIndex * stride * stride;
+}
+
+const Heightfield::Tile& Heightfield::tile(uint32_t tileX, uint32_t tileZ) const
+{
+    auto& entry = m_tileCache[static_cast<size_t>(tileZ) * m_header->tilesX + tileX];
+
+    std::call_once(entry.built, [&]() {
+        buildTile(entry, tileX, tileZ);
+        m_touchedTiles.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    return entry;
+}
+
+void Heightfield::buildTile(Tile& tile, uint32_t tileX, uint32_t tileZ) const
+{
+    uint32_t n = m_header->tileCells;
+    size_t stride = n + 1;
+    const float* data = tileData(tileX, tileZ);
+
+    tile.bounds.resize(m_cellLevelOffsets.back() + 2);
+
+    // cells from corner samples
+    float* cells = tile.bounds.data();
+    for (uint32_t j = 0; j < n; j++)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            float h00 = data[j * stride + i];
+            float h10 = data[j * stride + i + 1];
+            float h01 = data[(j + 1) * stride + i];
+            float h11 = data[(j + 1) * stride + i + 1];
+
+            cells[(j * n + i) * 2] = std::min({h00, h10, h01, h11});
+            cells[(j * n + i) * 2 + 1] = std::max({h00, h10, h01, h11});
+        }
+    }
+
+    // reduce 2x2 upward
+    for (uint32_t level = 1; level < m_cellLevels; level++)
+    {
+        uint32_t below = n >> (level - 1);
+        uint32_t size = n >> level;
+
+        const float* src = tile.bounds.data() + m_cellLevelOffsets[level - 1];
+        float* dst = tile.bounds.data() + m_cellLevelOffsets[level];
+
+        for (uint32_t j = 0; j < size; j++)
+        {
+            for (uint32_t i = 0; i < size; i++)
+            {
+                size_t a = ((j * 2) * below + i * 2) * 2;
+                size_t b = a + 2;
+                size_t c = a + below * 2;
+                size_t d = c + 2;
+
+                dst[(j * size + i) * 2] = std::min({src[a], src[b], src[c], src[d]});
+                dst[(j * size + i) * 2 + 1] = std::max({src[a + 1], src[b + 1], src[c + 1], src[d + 1]});
+            }
+        }
+    }
+}
+
+std::optional<TerrainHit> Heightfield::sweep(const BulletPhysics::math::Vec3& from, const BulletPhysics::math::Vec3& to, double radius) const
+{
+    return query(from, to - from, radius);
+}
+
+std::optional<TerrainHit> Heightfield::raycast(const BulletPhysics::math::Vec3& origin, const BulletPhysics::math::Vec3& direction, double maxDistance) const
+{
+    double length = direction.length();
+    if (length < 1e-12 || maxDistance <= 0.0)
+    {
+        return std::nullopt;
+    }
+
+    auto hit = query(origin, direction * (maxDistance / length), 0.0);
+    if (hit)
+    {
+        // fraction -> distance
+        hit->t *= maxDistance;
+    }
+    return hit;
+}
+
+std::optional<TerrainHit> Heightfield::query(const BulletPhysics::math::Vec3& origin, const BulletPhysics::math::Vec3& delta, double radius) const
+{
+    // grid space, x and z measured in cells from sample (0, 0)
+    Ray ray{};
+    ray.ox = static_cast<float>((origin.x - m_header->originX) / m_header->cellSize);
+    ray.oy = static_cast<float>(origin.y);
+    ray.oz = static_cast<float>((origin.z - m_header->originZ) / m_header->cellSize);
+    ray.dx = static_cast<float>(delta.x / m_header->cellSize);
+    ray.dy = static_cast<float>(delta.y);
+    ray.dz = static_cast<float>(delta.z / m_header->cellSize);
+    ray.invX = inverse(ray.dx);
+    ray.invY = inverse(ray.dy);
+    ray.invZ = inverse(ray.dz);
+    ray.tMax = 1.0f;
+    ray.lift = static_cast<float>(radius);
+
+    float bestT = ray.tMax;
+    BulletPhysics::math::Vec3 bestNormal{0.0, 1.0, 0.0};
+    bool found = false;
+
+    // descend tile pyramid, nearest node first
+    struct Node {
+        uint32_t level;
+        uint32_t i;
+        uint32_t j;
+        float tEnter;
+    };
+
+    std::array<Node, 128> stack;
+    size_t top = 0;
+
+    uint32_t n = m_header->tileCells;
+    float limitX = static_cast<float>(m_header->width - 1);
+    float limitZ = static_cast<float>(m_header->depth - 1);
+
+    auto nodeBox = [&](uint32_t level, uint32_t i, uint32_t j, float tLimit, float& tEnter) {
+        const auto& bounds = m_tileLevels[level];
+        size_t index = (static_cast<size_t>(j) * m_tileLevelWidths[level] + i) * 2;
+
+        float x0 = static_cast<float>((i << level) * n);
+        float z0 = static_cast<float>((j << level) * n);
+        float x1 = std::min(static_cast<float>(((i + 1) << level) * n), limitX);
+        float z1 = std::min(static_cast<float>(((j + 1) << level) * n), limitZ);
+
+        return rayBox(ray, x0, bounds[index], z0, x1, bounds[index + 1] + ray.lift, z1, tLimit, tEnter);
+    };
+
+    auto rootLevel = static_cast<uint32_t>(m_tileLevels.size() - 1);
+    float tRoot = 0.0f;
+    if (!nodeBox(rootLevel, 0, 0, bestT, tRoot))
+    {
+        return std::nullopt;
+    }
+    stack[top++] = {rootLevel, 0, 0, tRoot};
+
+    while (top > 0)
+    {
+        Node node = stack[--top];
+        if (node.tEnter >= bestT)
+        {
+            continue;
+        }
+
+        if (node.level == 0)
+        {
+            found |= rayTile(ray, node.i, node.j, bestT, bestNormal);
+            continue;
+        }
+
+        // children, pushed far to near
+        uint32_t childLevel = node.level - 1;
+        Node children[4];
+        size_t count = 0;
+
+        for (uint32_t cj = node.j * 2; cj < std::min(node.j * 2 + 2, m_tileLevelDepths[childLevel]); cj++)
+        {
+            for (uint32_t ci = node.i * 2; ci < std::min(node.i * 2 + 2, m_tileLevelWidths[childLevel]); ci++)
+            {
+                float tEnter = 0.0f;
+                if (nodeBox(childLevel, ci, cj, bestT, tEnter))
+                {
+                    children[count++] = {childLevel, ci, cj, tEnter};
+                }
+            }
+        }
+
+        std::sort(children, children + count, [](const Node& a, const Node& b) { return a.tEnter > b.tEnter; });
+
+        for (size_t c = 0; c < count; c++)
+        {
+            stack[top++] = children[c];
+        }
+    }
+
+    if (!found)
+    {
+        return std::nullopt;
+    }
+
+    TerrainHit hit;
+    hit.t = bestT;
+    hit.position = origin + delta * static_cast<double>(bestT);
+    hit.normal = bestNormal;
+    return hit;
+}
+
+bool Heightfield::rayTile(const Ray& ray, uint32_t tileX, uint32_t tileZ, float& bestT, BulletPhysics::math::Vec3& bestNormal) const
+{
+    const auto& cache = tile(tileX, tileZ);
+    const float* data = tileData(tileX, tileZ);
+
+    uint32_t n = m_header->tileCells;
+    float baseX = static_cast<float>(tileX * n);
+    float baseZ = static_cast<float>(tileZ * n);
+
+    struct Node {
+        uint32_t level;
+        uint32_t i;
+        uint32_t j;
+        float tEnter;
+    };
+
+    std::array<Node, 128> stack;
+    size_t top = 0;
+    bool found = false;
+
+    auto nodeBox = [&](uint32_t level, uint32_t i, uint32_t j, float tLimit, float& tEnter) {
+        uint32_t size = n >> level;
+        const float* bounds = cache.bounds.data() + m_cellLevelOffsets[level] + (static_cast<size_t>(j) * size + i) * 2;
+
+        float x0 = baseX + static_cast<float>(i << level);
+        float z0 = baseZ + static_cast<float>(j << level);
+        float x1 = baseX + static_cast<float>((i + 1) << level);
+        float z1 = baseZ + static_cast<float>((j + 1) << level);
+
+        return rayBox(ray, x0, bounds[0], z0, x1, bounds[1] + ray.lift, z1, tLimit, tEnter);
+    };
+
+    uint32_t rootLevel = m_cellLevels - 1;
+    float tRoot = 0.0f;
+    if (!nodeBox(rootLevel, 0, 0, bestT, tRoot))
+    {
+        return false;
+    }
+    stack[top++] = {rootLevel, 0, 0, tRoot};
+
+    while (top > 0)
+    {
+        Node node = stack[--top];
+        if (node.tEnter >= bestT)
+        {
+            continue;
+        }
+
+        if (node.level == 0)
+        {
+            found |= rayCell(ray, data, tileX, tileZ, node.i, node.j, bestT, bestNormal);
+            continue;
+        }
+
+        uint32_t childLevel = node.level - 1;
+        Node children[4];
+        size_t count = 0;
+
+        for (uint32_t cj = node.j * 2; cj < node.j * 2 + 2; cj++)
+        {
+            for (uint32_t ci = node.i * 2; ci < node.i * 2 + 2; ci++)
+            {
+                float tEnter = 0.0f;
+                if (nodeBox(childLevel, ci, cj, bestT, tEnter))
+                {
+                    children[count++] = {childLevel, ci, cj, tEnter};
+                }
+            }
+        }
+
+        std::sort(children, children + count, [](const Node& a, const Node& b) { return a.tEnter > b.tEnter; });
+
+        for (size_t c = 0; c < count; c++)
+        {
+            stack[top++] = children[c];
+        }
+    }
+
+    return found;
+}
+
+bool Heightfield::rayCell(const Ray& ray, const float* data, uint32_t tileX, uint32_t tileZ, uint32_t cellX, uint32_t cellZ, float& bestT, BulletPhysics::math::Vec3& bestNormal) const
+{
+    uint32_t n = m_header->tileCells;
+    uint32_t gx = tileX * n + cellX;
+    uint32_t gz = tileZ * n + cellZ;
+
+    // padding past raster edge
+    if (gx >= m_header->width - 1 || gz >= m_header->depth - 1)
+    {
+        return false;
+    }
+
+    size_t stride = n + 1;
+    float h00 = data[cellZ * stride + cellX] + ray.lift;
+    float h10 = data[cellZ * stride + cellX + 1] + ray.lift;
+    float h01 = data[(cellZ + 1) * stride + cellX] + ray.lift;
+    float h11 = data[(cellZ + 1) * stride + cellX + 1] + ray.lift;
+
+    // origin relative to cell corner, keeps precision on large rasters
+    float ox = ray.ox - static_cast<float>(gx);
+    float oz = ray.oz - static_cast<float>(gz);
+
+    // triangles (00, 10, 11) and (00, 11, 01)
+    const float corners[2][3][3] = {
+        {{0.0f, h00, 0.0f}, {1.0f, h10, 0.0f}, {1.0f, h11, 1.0f}},
+        {{0.0f, h00, 0.0f}, {1.0f, h11, 1.0f}, {0.0f, h01, 1.0f}},
+    };
+
+    bool found = false;
+
+    for (const auto& tri : corners)
+    {
+        // moller-trumbore
+        float e1x = tri[1][0] - tri[0][0], e1y = tri[1][1] - tri[0][1], e1z = tri[1][2] - tri[0][2];
+        float e2x = tri[2][0] - tri[0][0], e2y = tri[2][1] - tri[0][1], e2z = tri[2][2] - tri[0][2];
+
+        float px = ray.dy * e2z - ray.dz * e2y;
+        float py = ray.dz * e2x - ray.dx * e2z;
+        float pz = ray.dx * e2y - ray.dy * e2x;
+
+        float det = e1x * px + e1y * py + e1z * pz;
+        if (std::fabs(det) < 1e-12f)
+        {
+            continue;
+        }
+
+        float invDet = 1.0f / det;
+        float sx = ox - tri[0][0], sy = ray.oy - tri[0][1], sz = oz - tri[0][2];
+
+        float u = (sx * px + sy * py + sz * pz) * invDet;
+        if (u < 0.0f || u > 1.0f)
+        {
+            continue;
+        }
+
+        float qx = sy * e1z - sz * e1y;
+        float qy = sz * e1x - sx * e1z;
+        float qz = sx * e1y - sy * e1x;
+
+        float v = (ray.dx * qx + ray.dy * qy + ray.dz * qz) * invDet;
+        if (v < 0.0f || u + v > 1.0f)
+        {
+            continue;
+        }
+
+        float t = (e2x * qx + e2y * qy + e2z * qz) * invDet;
+        if (t < 0.0f || t >= bestT)
+        {
+            continue;
+        }
+
+        // normal in world units, facing up
+        double cs = m_header->cellSize;
+        BulletPhysics::math::Vec3 a{e1x * cs, e1y, e1z * cs};
+        BulletPhysics::math::Vec3 b{e2x * cs, e2y, e2z * cs};
+        BulletPhysics::math::Vec3 normal{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+        if (normal.y < 0.0)
+        {
+            normal = -normal;
+        }
+
+        bestT = t;
+        bestNormal = normal.normalized();
+        found = true;
+    }
+
+    return found;
+}
+
+std::optional<double> Heightfield::heightAt(double x, double z) const
+{
+    double gx = (x - m_header->originX) / m_header->cellSize;
+    double gz = (z - m_header->originZ) / m_header->cellSize;
+
+    if (gx < 0.0 || gz < 0.0 || gx > m_header->width - 1 || gz > m_header->depth - 1)
+    {
+        return std::nullopt;
+    }
+
+    uint32_t n = m_header->tileCells;
+    auto cx = std::min(static_cast<uint32_t>(gx), m_header->width - 2);
+    auto cz = std::min(static_cast<uint32_t>(gz), m_header->depth - 2);
+
+    const float* data = tileData(cx / n, cz / n);
+    size_t stride = n + 1;
+    uint32_t lx = cx % n;
+    uint32_t lz = cz % n;
+
+    double h00 = data[lz * stride + lx];
+    double h10 = data[lz * stride + lx + 1];
+    double h01 = data[(lz + 1) * stride + lx];
+    double h11 = data[(lz + 1) * stride + lx + 1];
+
+    // same diagonal split as raycast
+    double u = gx - cx;
+    double v = gz - cz;
+
+    if (u >= v)
+    {
+        return h00 + u * (h10 - h00) + v * (h11 - h10);
+    }
+    return h00 + v * (h01 - h00) + u * (h11 - h01);
+}
+
+} // namespace collision
+} // namespace BulletEngine
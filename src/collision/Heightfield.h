@@ -0,0 +1,119 @@
+/*
+ * Heightfield.h
+ */
+
+#pragma once
+
+#include "ballistics/terminal/Material.h"
+#include "math/Vec3.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace BulletEngine {
+namespace collision {
+
+// on-disk layout: header, per tile min/max table, tiles of (tileCells + 1)^2 heights
+// neighbouring tiles share their edge samples, so every cell lives in exactly one tile
+struct HeightfieldHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;         // samples along x
+    uint32_t depth;         // samples along z
+    uint32_t tileCells;     // cells per tile edge, power of two
+    uint32_t tilesX;
+    uint32_t tilesZ;
+    float cellSize;         // m
+    float originX;          // world position of sample (0, 0)
+    float originZ;
+    uint64_t dataOffset;    // byte offset of first tile, page aligned
+};
+
+struct TerrainHit {
+    double t = 0.0;                         // fraction along swept segment
+    BulletPhysics::math::Vec3 position;
+    BulletPhysics::math::Vec3 normal;
+};
+
+// terrain elevation from a memory mapped tile file, tiles are paged in by the os on first access
+class Heightfield {
+public:
+    ~Heightfield();
+
+    Heightfield(const Heightfield&) = delete;
+    Heightfield& operator=(const Heightfield&) = delete;
+
+    // map file, returns nullptr if it is missing or malformed
+    static std::shared_ptr<Heightfield> load(const std::string& path);
+
+    // convert row-major raster (z rows of x samples) into tile file
+    static bool write(const std::string& path, const float* heights, uint32_t width, uint32_t depth, float cellSize, float originX, float originZ, uint32_t tileCells = 256);
+
+    // first hit of segment from -> to, radius lifts the surface for swept projectiles
+    std::optional<TerrainHit> sweep(const BulletPhysics::math::Vec3& from, const BulletPhysics::math::Vec3& to, double radius = 0.0) const;
+    std::optional<TerrainHit> raycast(const BulletPhysics::math::Vec3& origin, const BulletPhysics::math::Vec3& direction, double maxDistance) const;
+
+    // surface height, nullopt outside terrain
+    std::optional<double> heightAt(double x, double z) const;
+
+    void setMaterial(const BulletPhysics::ballistics::terminal::Material& material) { m_material = material; }
+    const std::optional<BulletPhysics::ballistics::terminal::Material>& getMaterial() const { return m_material; }
+
+    const HeightfieldHeader& getHeader() const { return *m_header; }
+    size_t getTouchedTiles() const { return m_touchedTiles.load(std::memory_order_relaxed); }
+
+private:
+    Heightfield() = default;
+
+    // min/max pyramid over one tile, built on first query that reaches it
+    struct Tile {
+        std::once_flag built;
+        std::vector<float> bounds;  // (min, max) per node, levels concatenated from cells upward
+    };
+
+    struct Ray {
+        float ox, oy, oz;       // grid space, x and z in cells
+        float dx, dy, dz;
+        float invX, invY, invZ;
+        float tMax;
+        float lift;
+    };
+
+    const float* tileData(uint32_t tileX, uint32_t tileZ) const;
+    const Tile& tile(uint32_t tileX, uint32_t tileZ) const;
+    void buildTile(Tile& tile, uint32_t tileX, uint32_t tileZ) const;
+
+    bool rayTile(const Ray& ray, uint32_t tileX, uint32_t tileZ, float& bestT, BulletPhysics::math::Vec3& bestNormal) const;
+    bool rayCell(const Ray& ray, const float* data, uint32_t tileX, uint32_t tileZ, uint32_t cellX, uint32_t cellZ, float& bestT, BulletPhysics::math::Vec3& bestNormal) const;
+
+    std::optional<TerrainHit> query(const BulletPhysics::math::Vec3& origin, const BulletPhysics::math::Vec3& delta, double radius) const;
+
+    void* m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+
+    const HeightfieldHeader* m_header = nullptr;
+    const float* m_tileBounds = nullptr;    // (min, max) per tile, from file
+    const float* m_tiles = nullptr;
+
+    // pyramid over tiles, built at load from tile table only
+    std::vector<std::vector<float>> m_tileLevels;
+    std::vector<uint32_t> m_tileLevelWidths;
+    std::vector<uint32_t> m_tileLevelDepths;
+
+    // layout of per tile pyramid
+    uint32_t m_cellLevels = 0;
+    std::vector<size_t> m_cellLevelOffsets;
+
+    std::unique_ptr<Tile[]> m_tileCache;
+    mutable std::atomic<size_t> m_touchedTiles{0};
+
+    std::optional<BulletPhysics::ballistics::terminal::Material> m_material;
+};
+
+} // namespace collision
+} // namespace BulletEngine
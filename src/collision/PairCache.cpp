@@ -0,0 +1,56 @@
+/*
+ * PairCache.cpp
+ */
+
+#include "PairCache.h"
+
+#include <algorithm>
+
+namespace BulletEngine {
+namespace collision {
+
+bool PairCache::touch(ecs::Entity entityA, ecs::Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold, uint64_t frame)
+{
+    auto [it, inserted] = m_entries.try_emplace(key(entityA, entityB));
+
+    auto& entry = it->second;
+    entry.entityA = entityA;
+    entry.entityB = entityB;
+    entry.manifold = manifold;
+    entry.frame = frame;
+
+    return inserted;
+}
+
+const PairCache::Entry* PairCache::find(ecs::Entity entityA, ecs::Entity entityB) const
+{
+    auto it = m_entries.find(key(entityA, entityB));
+    return it != m_entries.end() ? &it->second : nullptr;
+}
+
+void PairCache::removeStale(uint64_t frame, std::vector<Entry>& removed)
+{
+    removed.clear();
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (it->second.frame != frame)
+        {
+            removed.push_back(it->second);
+            it = m_entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // map order is arbitrary
+    std::sort(removed.begin(), removed.end(), [](const Entry& a, const Entry& b) {
+        if (a.entityA != b.entityA) return a.entityA < b.entityA;
+        return a.entityB < b.entityB;
+    });
+}
+
+} // namespace collision
+} // namespace BulletEngine
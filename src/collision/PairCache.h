@@ -0,0 +1,50 @@
+/*
+ * PairCache.h
+ */
+
+#pragma once
+
+#include "ecs/Ecs.h"
+
+#include "builtin/collision/Collision.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace BulletEngine {
+namespace collision {
+
+// contact state of touching pairs across updates
+class PairCache {
+public:
+    struct Entry {
+        ecs::Entity entityA = 0;
+        ecs::Entity entityB = 0;
+        BulletPhysics::builtin::collision::Manifold manifold;
+        uint64_t frame = 0;     // last update pair was touching
+    };
+
+    // record contact in frame, returns true if pair was not touching before
+    bool touch(ecs::Entity entityA, ecs::Entity entityB, const BulletPhysics::builtin::collision::Manifold& manifold, uint64_t frame);
+
+    const Entry* find(ecs::Entity entityA, ecs::Entity entityB) const;
+
+    // remove pairs not touched in frame, ordered by entities
+    void removeStale(uint64_t frame, std::vector<Entry>& removed);
+
+    void clear() { m_entries.clear(); }
+    size_t size() const { return m_entries.size(); }
+
+private:
+    // order independent
+    static uint64_t key(ecs::Entity a, ecs::Entity b)
+    {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+
+    std::unordered_map<uint64_t, Entry> m_entries;
+};
+
+} // namespace collision
+} // namespace BulletEngine
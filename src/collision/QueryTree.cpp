@@ -0,0 +1,405 @@
+/*
+ * QueryTree.cpp
+ */
+
+#include "QueryTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace BulletEngine {
+namespace collision {
+
+static constexpr uint32_t NO_HIT = 0xFFFFFFFFu;
+
+// large finite value instead of inf, keeps slab test free of nan
+static constexpr float BIG = 1e30f;
+
+static float inverse(float d)
+{
+    return d != 0.0f ? 1.0f / d : std::copysign(BIG, d);
+}
+
+void QueryTree::clear()
+{
+    m_boxes.clear();
+    m_planes.clear();
+    m_terrains.clear();
+    m_nodes.clear();
+    m_order.clear();
+}
+
+void QueryTree::addBox(ecs::Entity entity, uint32_t layer, const BulletPhysics::math::Vec3& center, const BulletPhysics::math::Vec3 axes[3], const BulletPhysics::math::Vec3& halfExtents, const BulletPhysics::ballistics::terminal::Material* material)
+{
+    Box box{};
+    box.center[0] = static_cast<float>(center.x);
+    box.center[1] = static_cast<float>(center.y);
+    box.center[2] = static_cast<float>(center.z);
+
+    for (int k = 0; k < 3; k++)
+    {
+        box.axes[k][0] = static_cast<float>(axes[k].x);
+        box.axes[k][1] = static_cast<float>(axes[k].y);
+        box.axes[k][2] = static_cast<float>(axes[k].z);
+    }
+
+    box.halfExtents[0] = static_cast<float>(halfExtents.x);
+    box.halfExtents[1] = static_cast<float>(halfExtents.y);
+    box.halfExtents[2] = static_cast<float>(halfExtents.z);
+    box.entity = entity;
+    box.layer = layer;
+    box.material = material;
+
+    m_boxes.push_back(box);
+}
+
+void QueryTree::addPlane(ecs::Entity entity, uint32_t layer, double height, const BulletPhysics::ballistics::terminal::Material* material)
+{
+    m_planes.push_back({height, entity, layer, material});
+}
+
+void QueryTree::addHeightfield(ecs::Entity entity, uint32_t layer, const Heightfield* heightfield)
+{
+    m_terrains.push_back({heightfield, entity, layer});
+}
+
+void QueryTree::build()
+{
+    m_nodes.clear();
+    m_order.resize(m_boxes.size());
+    std::iota(m_order.begin(), m_order.end(), 0u);
+
+    if (m_boxes.empty())
+    {
+        return;
+    }
+
+    // world aabb of every box
+    m_bounds.resize(m_boxes.size() * 6);
+    for (size_t i = 0; i < m_boxes.size(); i++)
+    {
+        const auto& box = m_boxes[i];
+
+        for (int c = 0; c < 3; c++)
+        {
+            float extent = std::fabs(box.axes[0][c]) * box.halfExtents[0] + std::fabs(box.axes[1][c]) * box.halfExtents[1] + std::fabs(box.axes[2][c]) * box.halfExtents[2];
+
+            m_bounds[i * 6 + c] = box.center[c] - extent;
+            m_bounds[i * 6 + 3 + c] = box.center[c] + extent;
+        }
+    }
+
+    m_nodes.reserve(m_boxes.size() * 2);
+    m_nodes.emplace_back();
+    buildNode(0, 0, static_cast<uint32_t>(m_boxes.size()));
+}
+
+void QueryTree::buildNode(uint32_t node, uint32_t first, uint32_t count)
+{
+    float bmin[3] = {BIG, BIG, BIG};
+    float bmax[3] = {-BIG, -BIG, -BIG};
+    float cmin[3] = {BIG, BIG, BIG};
+    float cmax[3] = {-BIG, -BIG, -BIG};
+
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        const float* b = &m_bounds[m_order[i] * 6];
+
+        for (int c = 0; c < 3; c++)
+        {
+            bmin[c] = std::min(bmin[c], b[c]);
+            bmax[c] = std::max(bmax[c], b[3 + c]);
+
+            float centroid = (b[c] + b[3 + c]) * 0.5f;
+            cmin[c] = std::min(cmin[c], centroid);
+            cmax[c] = std::max(cmax[c], centroid);
+        }
+    }
+
+    std::copy(bmin, bmin + 3, m_nodes[node].min);
+    std::copy(bmax, bmax + 3, m_nodes[node].max);
+
+    if (count <= LEAF_SIZE)
+    {
+        m_nodes[node].first = first;
+        m_nodes[node].count = count;
+        return;
+    }
+
+    // median split on widest centroid axis
+    int axis = 0;
+    if (cmax[1] - cmin[1] > cmax[axis] - cmin[axis]) axis = 1;
+    if (cmax[2] - cmin[2] > cmax[axis] - cmin[axis]) axis = 2;
+
+    uint32_t half = count / 2;
+    std::nth_element(m_order.begin() + first, m_order.begin() + first + half, m_order.begin() + first + count, [&](uint32_t a, uint32_t b) {
+        return m_bounds[a * 6 + axis] + m_bounds[a * 6 + 3 + axis] < m_bounds[b * 6 + axis] + m_bounds[b * 6 + 3 + axis];
+    });
+
+    auto children = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    m_nodes.emplace_back();
+
+    m_nodes[node].first = children;
+    m_nodes[node].count = 0;
+
+    buildNode(children, first, half);
+    buildNode(children + 1, first + half, count - half);
+}
+
+void QueryTree::raycast(std::span<const Ray> rays, std::span<RayHit> hits) const
+{
+    size_t total = std::min(rays.size(), hits.size());
+
+    for (size_t base = 0; base < total; base += PACKET)
+    {
+        Packet packet;
+        packet.size = std::min(PACKET, total - base);
+
+        for (size_t i = 0; i < PACKET; i++)
+        {
+            packet.hitBox[i] = NO_HIT;
+
+            // unused lanes never hit anything
+            if (i >= packet.size)
+            {
+                packet.ox[i] = packet.oy[i] = packet.oz[i] = 0.0f;
+                packet.dx[i] = packet.dy[i] = packet.dz[i] = 0.0f;
+                packet.invX[i] = packet.invY[i] = packet.invZ[i] = BIG;
+                packet.tMax[i] = -1.0f;
+                packet.mask[i] = 0;
+                continue;
+            }
+
+            const auto& ray = rays[base + i];
+            double length = ray.direction.length();
+            double scale = length > 1e-12 ? 1.0 / length : 0.0;
+
+            packet.ox[i] = static_cast<float>(ray.origin.x);
+            packet.oy[i] = static_cast<float>(ray.origin.y);
+            packet.oz[i] = static_cast<float>(ray.origin.z);
+            packet.dx[i] = static_cast<float>(ray.direction.x * scale);
+            packet.dy[i] = static_cast<float>(ray.direction.y * scale);
+            packet.dz[i] = static_cast<float>(ray.direction.z * scale);
+            packet.invX[i] = inverse(packet.dx[i]);
+            packet.invY[i] = inverse(packet.dy[i]);
+            packet.invZ[i] = inverse(packet.dz[i]);
+            packet.tMax[i] = length > 1e-12 ? static_cast<float>(ray.maxDistance) : -1.0f;
+            packet.mask[i] = ray.mask;
+        }
+
+        if (!m_nodes.empty())
+        {
+            traverse(packet);
+        }
+
+        // resolve lanes, unbounded shapes tested per ray
+        for (size_t i = 0; i < packet.size; i++)
+        {
+            const auto& ray = rays[base + i];
+            auto& hit = hits[base + i];
+            hit = RayHit{};
+
+            double best = packet.tMax[i];
+
+            if (packet.hitBox[i] != NO_HIT)
+            {
+                const auto& box = m_boxes[packet.hitBox[i]];
+                hit.entity = box.entity;
+                hit.distance = best;
+                hit.normal = {packet.hitNormal[i][0], packet.hitNormal[i][1], packet.hitNormal[i][2]};
+                hit.material = box.material;
+            }
+
+            if (best < 0.0)
+            {
+                continue;
+            }
+
+            BulletPhysics::math::Vec3 direction{packet.dx[i], packet.dy[i], packet.dz[i]};
+
+            for (const auto& plane : m_planes)
+            {
+                if ((plane.layer & ray.mask) == 0)
+                {
+                    continue;
+                }
+
+                // everything below plane is solid
+                double t = -1.0;
+                if (ray.origin.y <= plane.height)
+                {
+                    t = 0.0;
+                }
+                else if (direction.y < 0.0)
+                {
+                    t = (plane.height - ray.origin.y) / direction.y;
+                }
+
+                if (t >= 0.0 && t < best)
+                {
+                    best = t;
+                    hit.entity = plane.entity;
+                    hit.distance = t;
+                    hit.normal = {0.0, 1.0, 0.0};
+                    hit.material = plane.material;
+                }
+            }
+
+            for (const auto& terrain : m_terrains)
+            {
+                if ((terrain.layer & ray.mask) == 0)
+                {
+                    continue;
+                }
+
+                auto terrainHit = terrain.heightfield->raycast(ray.origin, direction, best);
+                if (terrainHit && terrainHit->t < best)
+                {
+                    best = terrainHit->t;
+                    hit.entity = terrain.entity;
+                    hit.distance = terrainHit->t;
+                    hit.normal = terrainHit->normal;
+                    hit.material = terrain.heightfield->getMaterial() ? &*terrain.heightfield->getMaterial() : nullptr;
+                }
+            }
+        }
+    }
+}
+
+void QueryTree::traverse(Packet& packet) const
+{
+    uint32_t stack[64];
+    size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const auto& node = m_nodes[stack[--top]];
+
+        // slab test of node against every lane
+        uint32_t active = 0;
+        for (size_t i = 0; i < PACKET; i++)
+        {
+            float tx0 = (node.min[0] - packet.ox[i]) * packet.invX[i];
+            float tx1 = (node.max[0] - packet.ox[i]) * packet.invX[i];
+            float ty0 = (node.min[1] - packet.oy[i]) * packet.invY[i];
+            float ty1 = (node.max[1] - packet.oy[i]) * packet.invY[i];
+            float tz0 = (node.min[2] - packet.oz[i]) * packet.invZ[i];
+            float tz1 = (node.max[2] - packet.oz[i]) * packet.invZ[i];
+
+            float tNear = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), 0.0f));
+            float tFar = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), packet.tMax[i]));
+
+            active |= static_cast<uint32_t>(tNear <= tFar) << i;
+        }
+
+        if (active == 0)
+        {
+            continue;
+        }
+
+        if (node.count > 0)
+        {
+            for (uint32_t k = node.first; k < node.first + node.count; k++)
+            {
+                intersectBox(packet, m_order[k], active);
+            }
+            continue;
+        }
+
+        stack[top++] = node.first + 1;
+        stack[top++] = node.first;
+    }
+}
+
+void QueryTree::intersectBox(Packet& packet, uint32_t boxIndex, uint32_t active) const
+{
+    const auto& box = m_boxes[boxIndex];
+
+    for (size_t i = 0; i < packet.size; i++)
+    {
+        if (!(active & (1u << i)) || (box.layer & packet.mask[i]) == 0)
+        {
+            continue;
+        }
+
+        // ray in box frame
+        float rx = packet.ox[i] - box.center[0];
+        float ry = packet.oy[i] - box.center[1];
+        float rz = packet.oz[i] - box.center[2];
+
+        float tNear = -BIG;
+        float tFar = BIG;
+        int nearAxis = -1;
+        float nearSign = 0.0f;
+        bool miss = false;
+
+        for (int k = 0; k < 3; k++)
+        {
+            const float* axis = box.axes[k];
+            float o = rx * axis[0] + ry * axis[1] + rz * axis[2];
+            float d = packet.dx[i] * axis[0] + packet.dy[i] * axis[1] + packet.dz[i] * axis[2];
+            float h = box.halfExtents[k];
+
+            if (std::fabs(d) < 1e-12f)
+            {
+                if (o < -h || o > h)
+                {
+                    miss = true;
+                    break;
+                }
+                continue;
+            }
+
+            float t0 = (-h - o) / d;
+            float t1 = (h - o) / d;
+            float sign = -1.0f;
+            if (t0 > t1)
+            {
+                std::swap(t0, t1);
+                sign = 1.0f;
+            }
+
+            if (t0 > tNear)
+            {
+                tNear = t0;
+                nearAxis = k;
+                nearSign = sign;
+            }
+            tFar = std::min(tFar, t1);
+        }
+
+        if (miss || tNear > tFar || tFar < 0.0f)
+        {
+            continue;
+        }
+
+        // origin inside box
+        float t = std::max(tNear, 0.0f);
+        if (t >= packet.tMax[i])
+        {
+            continue;
+        }
+
+        packet.tMax[i] = t;
+        packet.hitBox[i] = boxIndex;
+
+        if (tNear < 0.0f || nearAxis < 0)
+        {
+            packet.hitNormal[i][0] = -packet.dx[i];
+            packet.hitNormal[i][1] = -packet.dy[i];
+            packet.hitNormal[i][2] = -packet.dz[i];
+        }
+        else
+        {
+            packet.hitNormal[i][0] = box.axes[nearAxis][0] * nearSign;
+            packet.hitNormal[i][1] = box.axes[nearAxis][1] * nearSign;
+            packet.hitNormal[i][2] = box.axes[nearAxis][2] * nearSign;
+        }
+    }
+}
+
+} // namespace collision
+} // namespace BulletEngine
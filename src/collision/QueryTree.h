@@ -0,0 +1,112 @@
+/*
+ * QueryTree.h
+ */
+
+#pragma once
+
+#include "ecs/Ecs.h"
+#include "collision/Heightfield.h"
+
+#include "ballistics/terminal/Material.h"
+#include "math/Vec3.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BulletEngine {
+namespace collision {
+
+struct Ray {
+    BulletPhysics::math::Vec3 origin;
+    BulletPhysics::math::Vec3 direction;    // need not be normalized
+    double maxDistance = 1000.0;
+    uint32_t mask = 0xFFFFFFFFu;            // layers the ray can hit
+};
+
+struct RayHit {
+    ecs::Entity entity = 0;                 // 0 if nothing was hit
+    double distance = 0.0;                  // m along ray
+    BulletPhysics::math::Vec3 normal;
+    const BulletPhysics::ballistics::terminal::Material* material = nullptr;
+
+    bool hit() const { return entity != 0; }
+};
+
+// static snapshot of collider shapes for ray queries, bvh over oriented boxes plus unbounded shapes
+class QueryTree {
+public:
+    void clear();
+
+    void addBox(ecs::Entity entity, uint32_t layer, const BulletPhysics::math::Vec3& center, const BulletPhysics::math::Vec3 axes[3], const BulletPhysics::math::Vec3& halfExtents, const BulletPhysics::ballistics::terminal::Material* material);
+    void addPlane(ecs::Entity entity, uint32_t layer, double height, const BulletPhysics::ballistics::terminal::Material* material);
+    void addHeightfield(ecs::Entity entity, uint32_t layer, const Heightfield* heightfield);
+
+    void build();
+
+    // rays are traversed in packets, no allocation per query
+    void raycast(std::span<const Ray> rays, std::span<RayHit> hits) const;
+
+    size_t boxCount() const { return m_boxes.size(); }
+
+private:
+    static constexpr size_t PACKET = 8;
+    static constexpr uint32_t LEAF_SIZE = 4;
+
+    struct Box {
+        float center[3];
+        float axes[3][3];
+        float halfExtents[3];
+        ecs::Entity entity;
+        uint32_t layer;
+        const BulletPhysics::ballistics::terminal::Material* material;
+    };
+
+    struct Plane {
+        double height;
+        ecs::Entity entity;
+        uint32_t layer;
+        const BulletPhysics::ballistics::terminal::Material* material;
+    };
+
+    struct Terrain {
+        const Heightfield* heightfield;
+        ecs::Entity entity;
+        uint32_t layer;
+    };
+
+    // leaf if count > 0, then first indexes m_order, else first is left child and right is first + 1
+    struct Node {
+        float min[3];
+        float max[3];
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // packet of rays in structure of arrays form
+    struct Packet {
+        float ox[PACKET], oy[PACKET], oz[PACKET];
+        float dx[PACKET], dy[PACKET], dz[PACKET];
+        float invX[PACKET], invY[PACKET], invZ[PACKET];
+        float tMax[PACKET];
+        uint32_t mask[PACKET];
+        uint32_t hitBox[PACKET];
+        float hitNormal[PACKET][3];
+        size_t size;
+    };
+
+    void buildNode(uint32_t node, uint32_t first, uint32_t count);
+    void traverse(Packet& packet) const;
+    void intersectBox(Packet& packet, uint32_t boxIndex, uint32_t active) const;
+
+    std::vector<Box> m_boxes;
+    std::vector<Plane> m_planes;
+    std::vector<Terrain> m_terrains;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_order;          // box indices, leaves reference ranges
+    std::vector<float> m_bounds;            // box aabb, 6 floats each, used while building
+};
+
+} // namespace collision
+} // namespace BulletEngine
@@ -0,0 +1,125 @@
+/*
+ * AllocationOperators.cpp
+ */
+
+#include "AllocationTracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// global allocation functions, plain malloc underneath
+// part of the engine when it tracks allocations, otherwise linked only into the targets that measure them
+#ifdef BULLET_ENGINE_TRACK_ALLOCATIONS
+
+namespace {
+
+size_t usableSize(void* ptr)
+{
+#ifdef __GLIBC__
+    return malloc_usable_size(ptr);
+#else
+    (void)ptr;
+    return 0;
+#endif
+}
+
+void* allocate(std::size_t size)
+{
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr)
+    {
+        BulletEngine::core::AllocationTracker::instance().recordAllocation(size, usableSize(ptr));
+    }
+    return ptr;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    // aligned_alloc wants a multiple of the alignment
+    auto align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+
+    void* ptr = std::aligned_alloc(align, rounded);
+    if (ptr)
+    {
+        BulletEngine::core::AllocationTracker::instance().recordAllocation(size, usableSize(ptr));
+    }
+    return ptr;
+}
+
+void release(void* ptr)
+{
+    if (ptr)
+    {
+        BulletEngine::core::AllocationTracker::instance().recordRelease(usableSize(ptr));
+        std::free(ptr);
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* ptr = allocate(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* ptr = allocateAligned(size, alignment);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { release(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { release(ptr); }
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * AllocationTracker.cpp
+ */
+
+#include "AllocationTracker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+namespace BulletEngine {
+namespace core {
+
+// trivially constructed, safe to touch from operator new before main
+static thread_local AllocationTracker::Context t_context = {};
+
+AllocationTracker::AllocationTracker()
+{
+    m_tags[UNTAGGED].name = "untagged";
+}
+
+AllocationTracker& AllocationTracker::instance()
+{
+    static AllocationTracker tracker;
+    return tracker;
+}
+
+bool AllocationTracker::isCompiledIn()
+{
+#ifdef BULLET_ENGINE_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t AllocationTracker::registerTag(const char* name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    uint32_t count = m_tagCount.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (std::strcmp(m_tags[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+
+    // out of tags, later ones count as untagged
+    if (count == MAX_TAGS)
+    {
+        return UNTAGGED;
+    }
+
+    m_tags[count].name = name;
+    m_tagCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void AllocationTracker::setBudget(const char* name, const Budget& budget)
+{
+    uint32_t tag = registerTag(name);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tags[tag].hasBudget = true;
+    m_tags[tag].budget = budget;
+}
+
+void AllocationTracker::setViolationHandler(std::function<void(const Violation&)> handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_handler = std::move(handler);
+}
+
+void AllocationTracker::recordAllocation(size_t bytes, size_t usableBytes)
+{
+    m_allocations.fetch_add(1, std::memory_order_relaxed);
+    m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    m_liveBytes.fetch_add(static_cast<int64_t>(usableBytes), std::memory_order_relaxed);
+
+    const auto& context = t_context;
+    if (context.depth == 0)
+    {
+        auto& tag = m_tags[UNTAGGED];
+        tag.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+        tag.frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+        tag.frameSelfAllocations.fetch_add(1, std::memory_order_relaxed);
+        tag.frameSelfBytes.fetch_add(bytes, std::memory_order_relaxed);
+        return;
+    }
+
+    // push counts past MAX_DEPTH, only the tags that fit are on the stack
+    uint32_t depth = std::min<uint32_t>(context.depth, MAX_DEPTH);
+    for (uint32_t i = 0; i < depth; i++)
+    {
+        // a tag open twice on the stack counts once
+        uint16_t id = context.stack[i];
+        bool repeated = false;
+        for (uint32_t j = 0; j < i; j++)
+        {
+            repeated |= context.stack[j] == id;
+        }
+
+        if (!repeated)
+        {
+            m_tags[id].frameAllocations.fetch_add(1, std::memory_order_relaxed);
+            m_tags[id].frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    auto& self = m_tags[context.stack[depth - 1]];
+    self.frameSelfAllocations.fetch_add(1, std::memory_order_relaxed);
+    self.frameSelfBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocationTracker::recordRelease(size_t usableBytes)
+{
+    m_liveBytes.fetch_sub(static_cast<int64_t>(usableBytes), std::memory_order_relaxed);
+}
+
+void AllocationTracker::push(uint32_t tag)
+{
+    // deeper nesting is charged to the deepest tag that fit
+    auto& context = t_context;
+    if (context.depth < MAX_DEPTH)
+    {
+        context.stack[context.depth] = static_cast<uint16_t>(tag);
+    }
+    context.depth++;
+}
+
+void AllocationTracker::pop()
+{
+    t_context.depth--;
+}
+
+AllocationTracker::Context AllocationTracker::capture()
+{
+    return t_context;
+}
+
+void AllocationTracker::restore(const Context& context)
+{
+    t_context = context;
+}
+
+void AllocationTracker::endFrame()
+{
+    std::vector<Violation> violations;
+    std::function<void(const Violation&)> handler;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        uint64_t frame = m_frame.load(std::memory_order_relaxed);
+        uint32_t count = m_tagCount.load(std::memory_order_acquire);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& tag = m_tags[i];
+            tag.allocations = tag.frameAllocations.exchange(0, std::memory_order_relaxed);
+            tag.bytes = tag.frameBytes.exchange(0, std::memory_order_relaxed);
+            tag.selfAllocations = tag.frameSelfAllocations.exchange(0, std::memory_order_relaxed);
+            tag.selfBytes = tag.frameSelfBytes.exchange(0, std::memory_order_relaxed);
+            tag.peakAllocations = std::max(tag.peakAllocations, tag.allocations);
+            tag.totalAllocations += tag.allocations;
+
+            if (tag.hasBudget && frame >= tag.budget.graceFrames && (tag.allocations > tag.budget.maxAllocations || tag.bytes > tag.budget.maxBytes))
+            {
+                tag.violations++;
+                violations.push_back({tag.name, frame, tag.allocations, tag.bytes, tag.budget});
+            }
+        }
+
+        m_frame.store(frame + 1, std::memory_order_relaxed);
+        handler = m_handler;
+    }
+
+    // outside the lock, a handler may read stats
+    for (const auto& violation : violations)
+    {
+        if (handler)
+        {
+            handler(violation);
+            continue;
+        }
+
+        std::cerr << "AllocationTracker: " << violation.tag << " made " << violation.allocations << " allocations (" << violation.bytes << " bytes) in frame " << violation.frame
+                  << ", budget " << violation.budget.maxAllocations << " allocations, " << violation.budget.maxBytes << " bytes" << std::endl;
+        assert(!"allocation budget exceeded");
+    }
+}
+
+void AllocationTracker::stats(std::vector<TagStats>& out) const
+{
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    uint32_t count = m_tagCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const auto& tag = m_tags[i];
+        out.push_back({tag.name, tag.allocations, tag.bytes, tag.selfAllocations, tag.selfBytes, tag.peakAllocations, tag.totalAllocations, tag.violations, tag.hasBudget, tag.budget});
+    }
+}
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,165 @@
+/*
+ * AllocationTracker.h
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace BulletEngine {
+namespace core {
+
+// heap allocations counted per tag and frame, through the global operator new of the engine
+// tags nest per thread, an allocation counts for every open tag and as self for the innermost
+// without BULLET_ENGINE_TRACK_ALLOCATIONS engine scopes are compiled out and operator new is left alone
+// targets that measure allocations link AllocationOperators.cpp themselves, so totals and their own scopes still count
+class AllocationTracker {
+public:
+    static constexpr size_t MAX_TAGS = 256;
+    static constexpr size_t MAX_DEPTH = 32;
+    static constexpr uint32_t UNTAGGED = 0;         // allocations outside any tag
+
+    struct Budget {
+        uint64_t maxAllocations = std::numeric_limits<uint64_t>::max();     // per frame, tag and nested tags
+        uint64_t maxBytes = std::numeric_limits<uint64_t>::max();
+        uint64_t graceFrames = 0;                   // first frames fill caches and are not checked
+    };
+
+    struct Violation {
+        const char* tag;
+        uint64_t frame;
+        uint64_t allocations;
+        uint64_t bytes;
+        Budget budget;
+    };
+
+    // counts of last finished frame
+    struct TagStats {
+        const char* name;
+        uint64_t allocations;           // with nested tags
+        uint64_t bytes;
+        uint64_t selfAllocations;       // innermost tag only
+        uint64_t selfBytes;
+        uint64_t peakAllocations;       // worst frame so far
+        uint64_t totalAllocations;      // since start
+        uint64_t violations;
+        bool hasBudget;
+        Budget budget;
+    };
+
+    // open tags of a thread, carried over to workers running a job for it
+    struct Context {
+        uint16_t stack[MAX_DEPTH];
+        uint32_t depth;
+    };
+
+    static AllocationTracker& instance();
+
+    // engine scopes and operator new of the engine, a target may still count through its own operator new
+    static bool isCompiledIn();
+
+    // once per call site, name must outlive the tracker, same name shares one tag
+    uint32_t registerTag(const char* name);
+
+    // replaces the budget of the tag, registering it if needed
+    void setBudget(const char* name, const Budget& budget);
+
+    // called for each exceeded budget at endFrame, default logs and asserts in debug builds
+    void setViolationHandler(std::function<void(const Violation&)> handler);
+
+    // roll frame counts into stats and check budgets, once per frame from one thread
+    void endFrame();
+
+    void stats(std::vector<TagStats>& out) const;
+    uint64_t getFrame() const { return m_frame.load(std::memory_order_relaxed); }
+
+    // all threads since start
+    uint64_t getAllocations() const { return m_allocations.load(std::memory_order_relaxed); }
+    uint64_t getBytes() const { return m_bytes.load(std::memory_order_relaxed); }
+    int64_t getLiveBytes() const { return m_liveBytes.load(std::memory_order_relaxed); }
+
+    // hot path, called by operator new and delete
+    void recordAllocation(size_t bytes, size_t usableBytes);
+    void recordRelease(size_t usableBytes);
+
+    static void push(uint32_t tag);
+    static void pop();
+    static Context capture();
+    static void restore(const Context& context);
+
+private:
+    AllocationTracker();
+
+    struct alignas(64) Tag {
+        const char* name = nullptr;
+        std::atomic<uint64_t> frameAllocations{0};
+        std::atomic<uint64_t> frameBytes{0};
+        std::atomic<uint64_t> frameSelfAllocations{0};
+        std::atomic<uint64_t> frameSelfBytes{0};
+
+        // endFrame only
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t selfAllocations = 0;
+        uint64_t selfBytes = 0;
+        uint64_t peakAllocations = 0;
+        uint64_t totalAllocations = 0;
+        uint64_t violations = 0;
+        bool hasBudget = false;
+        Budget budget;
+    };
+
+    Tag m_tags[MAX_TAGS];
+    std::atomic<uint32_t> m_tagCount{1};
+
+    std::atomic<uint64_t> m_allocations{0};
+    std::atomic<uint64_t> m_bytes{0};
+    std::atomic<int64_t> m_liveBytes{0};
+    std::atomic<uint64_t> m_frame{0};
+
+    mutable std::mutex m_mutex;         // registration, budgets, stats
+    std::function<void(const Violation&)> m_handler;
+};
+
+// counts allocations of enclosing block under a tag
+class AllocationScope {
+public:
+    explicit AllocationScope(uint32_t tag) { AllocationTracker::push(tag); }
+    ~AllocationScope() { AllocationTracker::pop(); }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+// runs enclosing block under the tags of another thread
+class AllocationContextScope {
+public:
+    explicit AllocationContextScope(const AllocationTracker::Context& context) : m_saved(AllocationTracker::capture()) { AllocationTracker::restore(context); }
+    ~AllocationContextScope() { AllocationTracker::restore(m_saved); }
+
+    AllocationContextScope(const AllocationContextScope&) = delete;
+    AllocationContextScope& operator=(const AllocationContextScope&) = delete;
+
+private:
+    AllocationTracker::Context m_saved;
+};
+
+} // namespace core
+} // namespace BulletEngine
+
+// allocation tag of enclosing block, compiled out unless BULLET_ENGINE_TRACK_ALLOCATIONS is defined
+#ifdef BULLET_ENGINE_TRACK_ALLOCATIONS
+#define BE_ALLOCATION_CONCAT_INNER(a, b) a##b
+#define BE_ALLOCATION_CONCAT(a, b) BE_ALLOCATION_CONCAT_INNER(a, b)
+#define BE_ALLOCATION_SCOPE(name) \
+    static const uint32_t BE_ALLOCATION_CONCAT(beAllocationTag, __LINE__) = ::BulletEngine::core::AllocationTracker::instance().registerTag(name); \
+    ::BulletEngine::core::AllocationScope BE_ALLOCATION_CONCAT(beAllocationScope, __LINE__)(BE_ALLOCATION_CONCAT(beAllocationTag, __LINE__))
+#else
+#define BE_ALLOCATION_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,58 @@
+/*
+ * HeadlessLoop.cpp
+ */
+
+#include "HeadlessLoop.h"
+#include "Profiler.h"
+
+#include <chrono>
+#include <thread>
+
+namespace BulletEngine {
+namespace core {
+
+void HeadlessLoop::run(const std::function<void(float)>& frame)
+{
+    using Clock = std::chrono::steady_clock;
+
+    m_running = true;
+    m_frames = 0;
+
+#ifdef BULLET_ENGINE_PROFILE
+    Profiler::instance().setThreadName("main");
+#endif
+
+    auto start = Clock::now();
+    auto period = m_config.rate > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_config.rate)) : Clock::duration::zero();
+    auto next = start;
+
+    while (m_running && (m_config.maxFrames == 0 || m_frames < m_config.maxFrames))
+    {
+        frame(m_config.dt);
+        m_frames++;
+
+        Profiler::instance().endFrame();
+        AllocationTracker::instance().endFrame();
+
+        // fixed rate, late frames are not made up for
+        if (m_config.rate > 0.0)
+        {
+            next += period;
+            auto now = Clock::now();
+            if (next > now)
+            {
+                std::this_thread::sleep_until(next);
+            }
+            else
+            {
+                next = now;
+            }
+        }
+    }
+
+    m_running = false;
+    m_elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace core
+} // namespace BulletEngine
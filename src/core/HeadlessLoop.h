@@ -0,0 +1,41 @@
+/*
+ * HeadlessLoop.h
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace BulletEngine {
+namespace core {
+
+// frame loop without window or gl, frames get a fixed dt
+class HeadlessLoop {
+public:
+    struct Config {
+        float dt = 1.0f / 60.0f;    // s of simulated time per frame
+        double rate = 0.0;          // frames per wall clock second, 0 runs at maximum speed
+        uint64_t maxFrames = 0;     // 0 runs until stop
+    };
+
+    explicit HeadlessLoop(const Config& config) : m_config(config) {}
+
+    // calls frame until stop or maxFrames
+    void run(const std::function<void(float)>& frame);
+
+    // safe to call from inside frame
+    void stop() { m_running = false; }
+
+    uint64_t getFrames() const { return m_frames; }
+    double getElapsed() const { return m_elapsed; }     // wall clock s of last run
+
+private:
+    Config m_config;
+    bool m_running = false;
+    uint64_t m_frames = 0;
+    double m_elapsed = 0.0;
+};
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,111 @@
+/*
+ * Histogram.cpp
+ */
+
+#include "Histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace BulletEngine {
+namespace core {
+
+int Histogram::bucketOf(uint64_t micros)
+{
+    // values below SUB_BUCKETS are exact, above that SUB_BITS of mantissa per power of two
+    if (micros < SUB_BUCKETS)
+    {
+        return static_cast<int>(micros);
+    }
+
+    int exponent = std::bit_width(micros) - 1;
+    int shift = exponent - SUB_BITS;
+    int bucket = (shift + 1) * SUB_BUCKETS + static_cast<int>((micros >> shift) & (SUB_BUCKETS - 1));
+    return std::min(bucket, BUCKETS - 1);
+}
+
+uint64_t Histogram::upperBound(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return static_cast<uint64_t>(bucket);
+    }
+
+    int shift = bucket / SUB_BUCKETS - 1;
+    uint64_t mantissa = SUB_BUCKETS + static_cast<uint64_t>(bucket % SUB_BUCKETS);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void Histogram::record(double seconds)
+{
+    uint64_t micros = static_cast<uint64_t>(std::max(0.0, std::round(seconds * 1e6)));
+
+    m_buckets[bucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumMicros.fetch_add(micros, std::memory_order_relaxed);
+
+    // single recorder, plain compare is enough
+    if (micros > m_maxMicros.load(std::memory_order_relaxed))
+    {
+        m_maxMicros.store(micros, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::reset()
+{
+    for (auto& bucket : m_buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sumMicros.store(0, std::memory_order_relaxed);
+    m_maxMicros.store(0, std::memory_order_relaxed);
+}
+
+double Histogram::mean() const
+{
+    uint64_t n = count();
+    return n ? static_cast<double>(m_sumMicros.load(std::memory_order_relaxed)) / static_cast<double>(n) * 1e-6 : 0.0;
+}
+
+double Histogram::max() const
+{
+    return static_cast<double>(m_maxMicros.load(std::memory_order_relaxed)) * 1e-6;
+}
+
+double Histogram::percentile(double p) const
+{
+    uint64_t n = count();
+    if (n == 0)
+    {
+        return 0.0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(n)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKETS; ++bucket)
+    {
+        seen += m_buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return static_cast<double>(std::min(upperBound(bucket), m_maxMicros.load(std::memory_order_relaxed))) * 1e-6;
+        }
+    }
+    return max();
+}
+
+void Histogram::print(std::ostream& out, std::string_view name) const
+{
+    out << name << ": n " << count()
+        << ", mean " << mean() * 1e3
+        << " ms, p50 " << percentile(0.5) * 1e3
+        << " ms, p90 " << percentile(0.9) * 1e3
+        << " ms, p99 " << percentile(0.99) * 1e3
+        << " ms, max " << max() * 1e3 << " ms\n";
+}
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,49 @@
+/*
+ * Histogram.h
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace BulletEngine {
+namespace core {
+
+// log-linear histogram of durations, 1 us resolution, about 6% relative error
+// one thread records, any thread may read
+class Histogram {
+public:
+    void record(double seconds);
+    void reset();
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    double mean() const;
+    double max() const;
+
+    // p in [0, 1], upper bound of bucket holding the value, s
+    double percentile(double p) const;
+
+    // name count mean p50 p90 p99 max, in ms
+    void print(std::ostream& out, std::string_view name) const;
+
+private:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int EXPONENTS = 40;
+    static constexpr int BUCKETS = SUB_BUCKETS * EXPONENTS;
+
+    static int bucketOf(uint64_t micros);
+    static uint64_t upperBound(int bucket);
+
+    std::array<std::atomic<uint64_t>, BUCKETS> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sumMicros{0};
+    std::atomic<uint64_t> m_maxMicros{0};
+};
+
+} // namespace core
+} // namespace BulletEngine
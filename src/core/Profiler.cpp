@@ -0,0 +1,296 @@
+/*
+ * Profiler.cpp
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+
+namespace BulletEngine {
+namespace core {
+
+thread_local uint32_t ProfileScope::s_depth = 0;
+
+Profiler::Profiler()
+{
+    m_trace.configure(TraceRecorder::configFromEnvironment());
+}
+
+Profiler::~Profiler()
+{
+    if (m_dumpWriter.joinable())
+    {
+        m_dumpWriter.join();
+    }
+}
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+uint32_t Profiler::registerScope(const char* name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // same name from several call sites shares one entry
+    for (size_t i = 0; i < m_scopes.size(); i++)
+    {
+        if (std::string_view(m_scopes[i]->name) == name)
+        {
+            return static_cast<uint32_t>(i);
+        }
+    }
+
+    auto scope = std::make_unique<Scope>();
+    scope->name = name;
+    m_scopes.push_back(std::move(scope));
+    return static_cast<uint32_t>(m_scopes.size() - 1);
+}
+
+Profiler::ThreadRing& Profiler::ring()
+{
+    // ring is shared so it outlives its thread until drained, exiting thread marks it for release
+    struct Owner {
+        std::shared_ptr<ThreadRing> ring;
+
+        ~Owner()
+        {
+            if (ring)
+            {
+                ring->orphaned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local Owner owner;
+    if (!owner.ring)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        owner.ring = std::make_shared<ThreadRing>(std::max<size_t>(m_threadCapacity, 1), static_cast<uint32_t>(m_threadNames.size()));
+        m_threadNames.push_back("thread " + std::to_string(owner.ring->index));
+        m_rings.push_back(owner.ring);
+    }
+    return *owner.ring;
+}
+
+void Profiler::setThreadName(const char* name)
+{
+    auto& r = ring();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threadNames[r.index] = name;
+}
+
+void Profiler::record(uint32_t scope, uint32_t depth, int64_t start, int64_t end)
+{
+    if (!m_enabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    auto& r = ring();
+    size_t head = r.head.load(std::memory_order_relaxed);
+    size_t tail = r.tail.load(std::memory_order_acquire);
+
+    if (head - tail >= r.events.size())
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    r.events[head % r.events.size()] = {scope, depth, start, end};
+    r.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::endFrame()
+{
+    int64_t frameEnd = now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_lastFrame.clear();
+
+    for (auto& r : m_rings)
+    {
+        // read before head, events of an orphaned ring are all visible once the flag is
+        bool orphaned = r->orphaned.load(std::memory_order_acquire);
+
+        size_t tail = r->tail.load(std::memory_order_relaxed);
+        size_t head = r->head.load(std::memory_order_acquire);
+
+        for (size_t i = tail; i < head; i++)
+        {
+            const auto& event = r->events[i % r->events.size()];
+
+            auto& scope = *m_scopes[event.scope];
+            scope.frameTotal += event.end - event.start;
+            scope.frameCalls++;
+
+            // spans begun before this frame are clipped to its start
+            int64_t start = std::max(event.start, m_frameStart);
+            m_lastFrame.push_back({event.scope, scope.name, r->index, event.depth, (start - m_frameStart) * 1e-6, (event.end - start) * 1e-6});
+
+            m_trace.append(event.scope, r->index, event.depth, event.start, event.end);
+        }
+
+        r->tail.store(head, std::memory_order_release);
+
+        if (orphaned)
+        {
+            r.reset();
+        }
+    }
+
+    std::erase(m_rings, nullptr);
+
+    size_t slot = m_frame % FRAME_HISTORY;
+    for (auto& scope : m_scopes)
+    {
+        scope->history[slot] = scope->frameTotal * 1e-6;
+        scope->calls[slot] = scope->frameCalls;
+        scope->frameTotal = 0;
+        scope->frameCalls = 0;
+    }
+
+    m_lastFrameTime = m_frameStart != 0 ? (frameEnd - m_frameStart) * 1e-6 : 0.0;
+
+    // slow frame, keep the window that led up to it
+    if (m_frameStart != 0 && m_trace.endFrame(m_frameStart, frameEnd))
+    {
+        writeSpikeTrace();
+    }
+
+    m_frameStart = frameEnd;
+    m_frame++;
+}
+
+void Profiler::stats(std::vector<ScopeStats>& out) const
+{
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t frames = std::min(m_frame, FRAME_HISTORY);
+    if (frames == 0)
+    {
+        return;
+    }
+
+    size_t last = (m_frame - 1) % FRAME_HISTORY;
+    double samples[FRAME_HISTORY];
+
+    for (const auto& scope : m_scopes)
+    {
+        size_t count = 0;
+        double sum = 0.0;
+        uint64_t calls = 0;
+
+        for (size_t i = 0; i < frames; i++)
+        {
+            calls += scope->calls[i];
+            if (scope->calls[i] > 0)
+            {
+                samples[count++] = scope->history[i];
+                sum += scope->history[i];
+            }
+        }
+
+        if (count == 0)
+        {
+            continue;
+        }
+
+        size_t rank = std::min(count - 1, static_cast<size_t>(0.99 * static_cast<double>(count)));
+        std::nth_element(samples, samples + rank, samples + count);
+
+        out.push_back({scope->name, sum / static_cast<double>(count), samples[rank], scope->history[last], static_cast<double>(calls) / static_cast<double>(frames)});
+    }
+}
+
+void Profiler::configureTrace(const TraceRecorder::Config& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_trace.configure(config);
+}
+
+bool Profiler::isTracing() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_trace.isEnabled();
+}
+
+bool Profiler::dumpTrace(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_trace.isEnabled() && writeTrace(path);
+}
+
+size_t Profiler::getTraceDumps() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_trace.getDumpCount();
+}
+
+bool Profiler::writeTrace(const std::string& path) const
+{
+    return m_trace.write(path, scopeNames(), threadNames());
+}
+
+void Profiler::writeSpikeTrace()
+{
+    // still writing the previous dump, a stall right after another one is not worth blocking for
+    if (m_dumpWriting.load(std::memory_order_acquire))
+    {
+        std::cerr << "Profiler: " << m_lastFrameTime << " ms frame, previous trace still writing, skipped" << std::endl;
+        return;
+    }
+
+    if (m_dumpWriter.joinable())
+    {
+        m_dumpWriter.join();
+    }
+
+    // copying the window is a memcpy, formatting and writing json happens without the lock
+    std::string path = m_trace.nextDumpPath();
+    m_dumpWriting.store(true, std::memory_order_relaxed);
+    m_dumpWriter = std::thread([this, path, frameTime = m_lastFrameTime, trace = m_trace, scopes = scopeNames(), threads = threadNames()]() {
+        if (trace.write(path, scopes, threads))
+        {
+            std::cerr << "Profiler: " << frameTime << " ms frame, trace written to " << path << std::endl;
+        }
+        else
+        {
+            std::cerr << "Profiler: failed to write trace " << path << std::endl;
+        }
+
+        m_dumpWriting.store(false, std::memory_order_release);
+    });
+}
+
+std::vector<const char*> Profiler::scopeNames() const
+{
+    std::vector<const char*> names;
+    names.reserve(m_scopes.size());
+    for (const auto& scope : m_scopes)
+    {
+        names.push_back(scope->name);
+    }
+    return names;
+}
+
+std::vector<std::string> Profiler::threadNames() const
+{
+    return m_threadNames;
+}
+
+size_t Profiler::getThreadCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rings.size();
+}
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,184 @@
+/*
+ * Profiler.h
+ */
+
+#pragma once
+
+#include "core/AllocationTracker.h"
+#include "core/TraceRecorder.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BulletEngine {
+namespace core {
+
+// timed region of one thread, ns on the steady clock
+struct ProfileEvent {
+    uint32_t scope;
+    uint32_t depth;
+    int64_t start;
+    int64_t end;
+};
+
+// per frame timing of named scopes, threads record into their own ring without locks
+// drained events also feed the trace recorder when one is configured
+class Profiler {
+public:
+    static constexpr size_t DEFAULT_THREAD_CAPACITY = 1 << 14;     // events per thread between frames
+    static constexpr size_t FRAME_HISTORY = 240;
+
+    struct ScopeStats {
+        const char* name;
+        double mean;            // ms per frame, frames the scope ran in
+        double p99;
+        double last;
+        double calls;           // per frame
+    };
+
+    // event of last finished frame, for flame bars
+    struct FrameEvent {
+        uint32_t scope;
+        const char* name;
+        uint32_t thread;
+        uint32_t depth;
+        double start;           // ms since frame start
+        double duration;        // ms
+    };
+
+    static Profiler& instance();
+    ~Profiler();
+
+    // once per call site, name must outlive the profiler
+    uint32_t registerScope(const char* name);
+
+    // called by scopes on any thread, drops the event if the ring of the thread is full
+    void record(uint32_t scope, uint32_t depth, int64_t start, int64_t end);
+
+    // drain all threads and roll statistics, call once per frame from one thread
+    void endFrame();
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // capacity of rings of threads that record for the first time after the call
+    void setThreadCapacity(size_t events) { m_threadCapacity = events; }
+
+    // label of the calling thread in traces
+    void setThreadName(const char* name);
+
+    // starts from BE_TRACE_* environment variables, reconfiguring drops the recorded window
+    void configureTrace(const TraceRecorder::Config& config);
+    bool isTracing() const;
+
+    // chrome trace json of the retained frames, false if tracing is off or the file failed
+    bool dumpTrace(const std::string& path);
+    size_t getTraceDumps() const;
+
+    void stats(std::vector<ScopeStats>& out) const;
+    const std::vector<FrameEvent>& lastFrame() const { return m_lastFrame; }
+    double lastFrameTime() const { return m_lastFrameTime; }       // ms
+
+    size_t getDroppedEvents() const { return m_dropped.load(std::memory_order_relaxed); }
+    size_t getThreadCount() const;         // threads with a ring, exited ones until the next endFrame
+
+    static int64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+private:
+    Profiler();
+
+    // single producer single consumer ring, owner thread writes head, endFrame writes tail
+    // orphaned once its thread exits, released by the next endFrame after draining it
+    struct ThreadRing {
+        explicit ThreadRing(size_t capacity, uint32_t index) : events(capacity), index(index) {}
+
+        std::vector<ProfileEvent> events;
+        uint32_t index;
+        std::atomic<bool> orphaned{false};
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+    };
+
+    struct Scope {
+        const char* name;
+        int64_t frameTotal = 0;
+        uint32_t frameCalls = 0;
+        double history[FRAME_HISTORY] = {};     // ms, 0 if not run
+        uint32_t calls[FRAME_HISTORY] = {};
+    };
+
+    ThreadRing& ring();
+    bool writeTrace(const std::string& path) const;
+    void writeSpikeTrace();
+
+    // names indexed like the recorded ids, under the lock
+    std::vector<const char*> scopeNames() const;
+    std::vector<std::string> threadNames() const;
+
+    std::atomic<bool> m_enabled{true};
+    size_t m_threadCapacity = DEFAULT_THREAD_CAPACITY;
+    std::atomic<size_t> m_dropped{0};
+
+    mutable std::mutex m_mutex;             // scopes and rings registration, stats, trace
+    std::vector<std::unique_ptr<Scope>> m_scopes;
+    std::vector<std::shared_ptr<ThreadRing>> m_rings;         // live threads and orphans not yet drained
+    std::vector<std::string> m_threadNames;                 // by ring index, kept for traces of exited threads
+
+    size_t m_frame = 0;
+    int64_t m_frameStart = 0;
+    double m_lastFrameTime = 0.0;
+    std::vector<FrameEvent> m_lastFrame;
+
+    TraceRecorder m_trace;
+
+    // spike dumps are written from a copy of the window, one at a time off the frame thread
+    std::thread m_dumpWriter;
+    std::atomic<bool> m_dumpWriting{false};
+};
+
+// times enclosing block
+class ProfileScope {
+public:
+    explicit ProfileScope(uint32_t scope) : m_scope(scope), m_start(Profiler::now()) { s_depth++; }
+    ~ProfileScope() { s_depth--; Profiler::instance().record(m_scope, s_depth, m_start, Profiler::now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    uint32_t m_scope;
+    int64_t m_start;
+
+    static thread_local uint32_t s_depth;
+};
+
+} // namespace core
+} // namespace BulletEngine
+
+// scoped timer, compiled out unless BULLET_ENGINE_PROFILE is defined
+#ifdef BULLET_ENGINE_PROFILE
+#define BE_PROFILE_CONCAT_INNER(a, b) a##b
+#define BE_PROFILE_CONCAT(a, b) BE_PROFILE_CONCAT_INNER(a, b)
+#define BE_PROFILE_TIMER(name) \
+    static const uint32_t BE_PROFILE_CONCAT(beProfileId, __LINE__) = ::BulletEngine::core::Profiler::instance().registerScope(name); \
+    ::BulletEngine::core::ProfileScope BE_PROFILE_CONCAT(beProfileScope, __LINE__)(BE_PROFILE_CONCAT(beProfileId, __LINE__))
+#else
+#define BE_PROFILE_TIMER(name) ((void)0)
+#endif
+
+// with allocation tracking every profiler scope is also an allocation tag of the same name
+// tags come with the profiler only, so a build without it pays nothing per scope
+#if defined(BULLET_ENGINE_PROFILE) && defined(BULLET_ENGINE_TRACK_ALLOCATIONS)
+#define BE_PROFILE_SCOPE(name) \
+    BE_PROFILE_TIMER(name); \
+    BE_ALLOCATION_SCOPE(name)
+#else
+#define BE_PROFILE_SCOPE(name) BE_PROFILE_TIMER(name)
+#endif
@@ -0,0 +1,162 @@
+/*
+ * SimulationThread.h
+ */
+
+#pragma once
+
+#include "core/TripleBuffer.h"
+#include "core/SpscQueue.h"
+#include "core/Histogram.h"
+#include "core/Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace BulletEngine {
+namespace core {
+
+// fixed step simulation on its own thread, paced to wall clock
+// state goes out as snapshots through a triple buffer, events come in through an spsc queue
+template<class Snapshot, class Event, size_t EventCapacity = 256>
+class SimulationThread {
+public:
+    struct Callbacks {
+        std::function<void(const Event&)> onEvent;      // before next step
+        std::function<void(double dt)> step;
+        std::function<void(Snapshot&)> publish;         // fill snapshot from current state
+    };
+
+    struct Config {
+        double stepDt = 0.001;          // s
+        int stepsPerPublish = 1;        // publish at most every n steps
+        int maxCatchUpSteps = 64;       // behind by more than this, backlog is dropped
+    };
+
+    SimulationThread(const Config& config, Callbacks callbacks)
+        : m_config(config)
+        , m_callbacks(std::move(callbacks))
+    {}
+
+    ~SimulationThread() { stop(); }
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void start()
+    {
+        if (m_thread.joinable())
+        {
+            return;
+        }
+
+        m_running.store(true, std::memory_order_release);
+        m_thread = std::thread([this] { main(); });
+    }
+
+    void stop()
+    {
+        m_running.store(false, std::memory_order_release);
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    // producer side of input queue, false if full
+    bool post(const Event& event) { return m_events.push(event); }
+
+    // render thread, true if a newer snapshot was taken
+    bool acquire() { return m_snapshots.acquire(); }
+    const Snapshot& latest() const { return m_snapshots.readBuffer(); }
+
+    // wall time of one step and interval between published snapshots
+    const Histogram& getStepTimes() const { return m_stepTimes; }
+    const Histogram& getPublishIntervals() const { return m_publishIntervals; }
+
+    uint64_t getSteps() const { return m_steps.load(std::memory_order_relaxed); }
+    uint64_t getDroppedSteps() const { return m_droppedSteps.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void main()
+    {
+#ifdef BULLET_ENGINE_PROFILE
+        Profiler::instance().setThreadName("simulation");
+#endif
+
+        auto stepPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_config.stepDt));
+        auto next = Clock::now();
+        auto lastPublish = next;
+        int unpublished = 0;
+
+        while (m_running.load(std::memory_order_acquire))
+        {
+            // catch up with wall clock, bounded so a long stall does not spiral
+            int steps = 0;
+            while (Clock::now() >= next && steps < m_config.maxCatchUpSteps)
+            {
+                Event event;
+                while (m_events.pop(event))
+                {
+                    m_callbacks.onEvent(event);
+                }
+
+                auto begin = Clock::now();
+                {
+                    BE_PROFILE_SCOPE("sim/step");
+                    m_callbacks.step(m_config.stepDt);
+                }
+                m_stepTimes.record(std::chrono::duration<double>(Clock::now() - begin).count());
+
+                m_steps.fetch_add(1, std::memory_order_relaxed);
+                next += stepPeriod;
+                steps++;
+            }
+
+            // too far behind, drop the backlog instead of running ever longer
+            auto now = Clock::now();
+            if (now - next > stepPeriod * m_config.maxCatchUpSteps)
+            {
+                m_droppedSteps.fetch_add(static_cast<uint64_t>((now - next) / stepPeriod), std::memory_order_relaxed);
+                next = now;
+            }
+
+            unpublished += steps;
+            if (unpublished > 0 && unpublished >= m_config.stepsPerPublish)
+            {
+                unpublished = 0;
+                {
+                    BE_PROFILE_SCOPE("sim/publish");
+                    m_callbacks.publish(m_snapshots.writeBuffer());
+                }
+                m_snapshots.publish();
+
+                m_publishIntervals.record(std::chrono::duration<double>(now - lastPublish).count());
+                lastPublish = now;
+            }
+
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    Config m_config;
+    Callbacks m_callbacks;
+
+    TripleBuffer<Snapshot> m_snapshots;
+    SpscQueue<Event, EventCapacity> m_events;
+
+    Histogram m_stepTimes;
+    Histogram m_publishIntervals;
+
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_steps{0};
+    std::atomic<uint64_t> m_droppedSteps{0};
+    std::thread m_thread;
+};
+
+} // namespace core
+} // namespace BulletEngine
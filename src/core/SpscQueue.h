@@ -0,0 +1,69 @@
+/*
+ * SpscQueue.h
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace BulletEngine {
+namespace core {
+
+// bounded lock-free queue for exactly one producer and one consumer thread
+template<class T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // producer, false if full
+    bool push(const T& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == Capacity)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == Capacity)
+            {
+                return false;
+            }
+        }
+
+        m_items[tail & (Capacity - 1)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer, false if empty
+    bool pop(T& value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache)
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache)
+            {
+                return false;
+            }
+        }
+
+        value = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> m_items{};
+
+    // producer line
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_headCache = 0;
+
+    // consumer line
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t m_tailCache = 0;
+};
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,156 @@
+/*
+ * ThreadPool.cpp
+ */
+
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+#include <atomic>
+#include <string>
+
+namespace BulletEngine {
+namespace core {
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = 1;
+    }
+
+    m_threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++)
+    {
+        m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::defaultThreadCount()
+{
+    auto count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+void ThreadPool::run(const std::function<void(size_t worker)>& job)
+{
+    if (m_threads.empty())
+    {
+        job(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_context = AllocationTracker::capture();
+        m_pending = m_threads.size();
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    {
+        BE_PROFILE_SCOPE("worker/job");
+        job(0);
+    }
+
+    // wait for the rest
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_pending == 0; });
+    m_job = nullptr;
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end, size_t worker)>& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (grain == 0)
+    {
+        grain = 1;
+    }
+
+    // not worth waking anyone
+    if (m_threads.empty() || count <= grain)
+    {
+        body(0, count, 0);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+
+    run([&](size_t worker) {
+        while (true)
+        {
+            size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+            if (begin >= count)
+            {
+                break;
+            }
+
+            size_t end = begin + grain < count ? begin + grain : count;
+            body(begin, end, worker);
+        }
+    });
+}
+
+void ThreadPool::workerLoop(size_t worker)
+{
+    uint64_t seen = 0;
+
+#ifdef BULLET_ENGINE_PROFILE
+    std::string name = "worker " + std::to_string(worker);
+    Profiler::instance().setThreadName(name.c_str());
+#endif
+
+    while (true)
+    {
+        const std::function<void(size_t)>* job = nullptr;
+        AllocationTracker::Context context;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_stop || m_generation != seen; });
+
+            if (m_stop)
+            {
+                return;
+            }
+
+            seen = m_generation;
+            job = m_job;
+            context = m_context;
+        }
+
+        {
+            // allocations of the job count for the system that started it
+            AllocationContextScope allocationContext(context);
+            BE_PROFILE_SCOPE("worker/job");
+            (*job)(worker);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending--;
+        }
+        m_done.notify_one();
+    }
+}
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,55 @@
+/*
+ * ThreadPool.h
+ */
+
+#pragma once
+
+#include "core/AllocationTracker.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BulletEngine {
+namespace core {
+
+// fixed set of engine worker threads, calling thread takes part as worker 0
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = defaultThreadCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // run job once on every worker, returns when all are finished
+    void run(const std::function<void(size_t worker)>& job);
+
+    // hand out [0, count) in chunks of grain items to whichever worker is free
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end, size_t worker)>& body);
+
+    size_t size() const { return m_threads.size() + 1; }
+
+    static size_t defaultThreadCount();
+
+private:
+    void workerLoop(size_t worker);
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const std::function<void(size_t)>* m_job = nullptr;
+    AllocationTracker::Context m_context = {};      // allocation tags of the caller of run
+    uint64_t m_generation = 0;
+    size_t m_pending = 0;
+    bool m_stop = false;
+};
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,173 @@
+/*
+ * TraceRecorder.cpp
+ */
+
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+namespace BulletEngine {
+namespace core {
+
+static double environmentNumber(const char* name, double fallback)
+{
+    const char* value = std::getenv(name);
+    if (!value || !*value)
+    {
+        return fallback;
+    }
+
+    char* end = nullptr;
+    double number = std::strtod(value, &end);
+    return end != value ? number : fallback;
+}
+
+// names are engine literals and thread labels, escape anyway so a stray quote cannot break the file
+static void writeString(std::FILE* file, const char* text)
+{
+    std::fputc('"', file);
+    for (const char* c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        }
+        else if (static_cast<unsigned char>(*c) < 0x20)
+        {
+            std::fprintf(file, "\\u%04x", static_cast<unsigned>(*c));
+        }
+        else
+        {
+            std::fputc(*c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+TraceRecorder::Config TraceRecorder::configFromEnvironment()
+{
+    Config config;
+    config.budgetBytes = static_cast<size_t>(std::max(0.0, environmentNumber("BE_TRACE_MB", 0.0)) * 1024.0 * 1024.0);
+    config.spikeMs = environmentNumber("BE_TRACE_SPIKE_MS", config.spikeMs);
+    config.cooldownFrames = static_cast<size_t>(std::max(0.0, environmentNumber("BE_TRACE_COOLDOWN", static_cast<double>(config.cooldownFrames))));
+    config.maxDumps = static_cast<size_t>(std::max(0.0, environmentNumber("BE_TRACE_MAX_DUMPS", static_cast<double>(config.maxDumps))));
+
+    if (const char* path = std::getenv("BE_TRACE_PATH"); path && *path)
+    {
+        config.path = path;
+    }
+
+    return config;
+}
+
+void TraceRecorder::configure(const Config& config)
+{
+    m_config = config;
+
+    std::vector<Event> events(config.budgetBytes / sizeof(Event));
+    m_events.swap(events);
+    m_next = 0;
+    m_count = 0;
+    m_frame = 0;
+    m_lastDumpFrame = 0;
+    m_dumps = 0;
+}
+
+void TraceRecorder::append(uint32_t scope, uint32_t thread, uint32_t depth, int64_t start, int64_t end)
+{
+    if (m_events.empty())
+    {
+        return;
+    }
+
+    m_events[m_next] = {scope, thread, depth, start, end};
+    m_next = (m_next + 1) % m_events.size();
+    m_count = std::min(m_count + 1, m_events.size());
+}
+
+bool TraceRecorder::endFrame(int64_t start, int64_t end)
+{
+    if (m_events.empty())
+    {
+        return false;
+    }
+
+    append(FRAME_SCOPE, 0, 0, start, end);
+    m_frame++;
+
+    if (m_config.spikeMs <= 0.0 || m_dumps >= m_config.maxDumps)
+    {
+        return false;
+    }
+
+    if (static_cast<double>(end - start) * 1e-6 < m_config.spikeMs)
+    {
+        return false;
+    }
+
+    // one stall often spans several slow frames, keep to the first
+    return m_dumps == 0 || m_frame - m_lastDumpFrame >= m_config.cooldownFrames;
+}
+
+std::string TraceRecorder::nextDumpPath()
+{
+    m_lastDumpFrame = m_frame;
+    return m_config.path + "-" + std::to_string(m_dumps++) + ".json";
+}
+
+bool TraceRecorder::write(const std::string& path, const std::vector<const char*>& scopeNames, const std::vector<std::string>& threadNames) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+    {
+        return false;
+    }
+
+    // oldest retained event first
+    size_t first = m_count < m_events.size() ? 0 : m_next;
+
+    // parents are recorded after their children, so the oldest start is not always first
+    int64_t origin = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < m_count; i++)
+    {
+        origin = std::min(origin, m_events[(first + i) % m_events.size()].start);
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+
+    // frames on their own track above the threads
+    std::fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"frames\"}}", file);
+    for (size_t i = 0; i < threadNames.size(); i++)
+    {
+        std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":", i + 1);
+        writeString(file, threadNames[i].c_str());
+        std::fprintf(file, "}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"sort_index\":%zu}}", i + 1, i + 1);
+    }
+
+    for (size_t i = 0; i < m_count; i++)
+    {
+        const auto& event = m_events[(first + i) % m_events.size()];
+
+        bool frame = event.scope == FRAME_SCOPE;
+        const char* name = frame ? "frame" : event.scope < scopeNames.size() ? scopeNames[event.scope] : "?";
+
+        // chrome trace times are in us
+        std::fputs(",\n{\"name\":", file);
+        writeString(file, name);
+        std::fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     frame ? "frame" : "engine", frame ? 0u : event.thread + 1,
+                     static_cast<double>(event.start - origin) * 1e-3, static_cast<double>(event.end - event.start) * 1e-3);
+    }
+
+    std::fputs("\n]}\n", file);
+
+    bool ok = !std::ferror(file);
+    return std::fclose(file) == 0 && ok;
+}
+
+} // namespace core
+} // namespace BulletEngine
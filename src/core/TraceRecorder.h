@@ -0,0 +1,73 @@
+/*
+ * TraceRecorder.h
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BulletEngine {
+namespace core {
+
+// rolling window of profiler events of the last frames, written out as chrome trace event json
+// memory is fixed at configure time, oldest events are overwritten
+class TraceRecorder {
+public:
+    static constexpr uint32_t FRAME_SCOPE = 0xFFFFFFFFu;      // scope of frame spans
+
+    struct Config {
+        size_t budgetBytes = 0;         // retained events, 0 disables recording
+        double spikeMs = 0.0;           // dump when a frame takes longer, 0 never
+        size_t cooldownFrames = 300;    // frames between spike dumps
+        size_t maxDumps = 8;            // spike dumps per run
+        std::string path = "trace";     // spike dumps go to <path>-<n>.json
+    };
+
+    // BE_TRACE_MB, BE_TRACE_SPIKE_MS, BE_TRACE_COOLDOWN, BE_TRACE_MAX_DUMPS, BE_TRACE_PATH
+    static Config configFromEnvironment();
+
+    // drops what was recorded
+    void configure(const Config& config);
+    const Config& getConfig() const { return m_config; }
+
+    bool isEnabled() const { return !m_events.empty(); }
+
+    void append(uint32_t scope, uint32_t thread, uint32_t depth, int64_t start, int64_t end);
+
+    // closes a frame, true if a spike dump is due
+    bool endFrame(int64_t start, int64_t end);
+
+    // scope and thread names indexed like the recorded ids
+    bool write(const std::string& path, const std::vector<const char*>& scopeNames, const std::vector<std::string>& threadNames) const;
+
+    // next spike dump file, counts it
+    std::string nextDumpPath();
+
+    size_t getEventCount() const { return m_count; }
+    size_t getCapacity() const { return m_events.size(); }
+    size_t getDumpCount() const { return m_dumps; }
+
+private:
+    struct Event {
+        uint32_t scope;
+        uint32_t thread;
+        uint32_t depth;
+        int64_t start;
+        int64_t end;
+    };
+
+    Config m_config;
+    std::vector<Event> m_events;
+    size_t m_next = 0;
+    size_t m_count = 0;
+
+    size_t m_frame = 0;
+    size_t m_lastDumpFrame = 0;
+    size_t m_dumps = 0;
+};
+
+} // namespace core
+} // namespace BulletEngine
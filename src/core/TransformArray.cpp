@@ -0,0 +1,277 @@
+/*
+ * TransformArray.cpp
+ */
+
+#include "TransformArray.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace BulletEngine {
+namespace core {
+
+uint32_t TransformArray::allocate()
+{
+    if (m_free.empty())
+    {
+        grow();
+    }
+
+    uint32_t slot = m_free.back();
+    m_free.pop_back();
+
+    m_px[slot] = m_py[slot] = m_pz[slot] = 0.0f;
+    m_qx[slot] = m_qy[slot] = m_qz[slot] = 0.0f;
+    m_qw[slot] = 1.0f;
+    m_sx[slot] = m_sy[slot] = m_sz[slot] = 1.0f;
+
+    markDirty(slot);
+    return slot;
+}
+
+void TransformArray::release(uint32_t slot)
+{
+    m_dirty[slot / BLOCK] &= ~(uint64_t(1) << (slot % BLOCK));
+    m_free.push_back(slot);
+}
+
+void TransformArray::setPosition(uint32_t slot, const glm::vec3& position)
+{
+    if (m_px[slot] == position.x && m_py[slot] == position.y && m_pz[slot] == position.z)
+    {
+        return;
+    }
+
+    m_px[slot] = position.x;
+    m_py[slot] = position.y;
+    m_pz[slot] = position.z;
+    markDirty(slot);
+}
+
+void TransformArray::setScale(uint32_t slot, const glm::vec3& scale)
+{
+    if (m_sx[slot] == scale.x && m_sy[slot] == scale.y && m_sz[slot] == scale.z)
+    {
+        return;
+    }
+
+    m_sx[slot] = scale.x;
+    m_sy[slot] = scale.y;
+    m_sz[slot] = scale.z;
+    markDirty(slot);
+}
+
+void TransformArray::setRotation(uint32_t slot, float x, float y, float z, float w)
+{
+    float length = std::sqrt(x * x + y * y + z * z + w * w);
+    if (length < 1e-12f)
+    {
+        return;
+    }
+
+    x /= length;
+    y /= length;
+    z /= length;
+    w /= length;
+
+    if (m_qx[slot] == x && m_qy[slot] == y && m_qz[slot] == z && m_qw[slot] == w)
+    {
+        return;
+    }
+
+    m_qx[slot] = x;
+    m_qy[slot] = y;
+    m_qz[slot] = z;
+    m_qw[slot] = w;
+    markDirty(slot);
+}
+
+void TransformArray::setDirection(uint32_t slot, const glm::vec3& from, const glm::vec3& to)
+{
+    glm::vec4 rotation;
+    if (rotationBetween(from, to, rotation))
+    {
+        setRotation(slot, rotation.x, rotation.y, rotation.z, rotation.w);
+    }
+}
+
+bool TransformArray::rotationBetween(const glm::vec3& from, const glm::vec3& to, glm::vec4& rotation)
+{
+    float fromLength = glm::length(from);
+    float toLength = glm::length(to);
+    if (fromLength < 1e-12f || toLength < 1e-12f)
+    {
+        return false;
+    }
+
+    glm::vec3 f = from / fromLength;
+    glm::vec3 t = to / toLength;
+    float d = glm::dot(f, t);
+
+    glm::vec4 q;
+    if (d < -0.999999f)
+    {
+        // opposite, half turn about any axis perpendicular to from
+        glm::vec3 axis = std::abs(f.x) < 0.9f ? glm::vec3{0.0f, -f.z, f.y} : glm::vec3{f.z, 0.0f, -f.x};
+        q = {axis.x, axis.y, axis.z, 0.0f};
+    }
+    else
+    {
+        // (from x to, 1 + from . to) normalized is the half angle quaternion
+        q = {f.y * t.z - f.z * t.y, f.z * t.x - f.x * t.z, f.x * t.y - f.y * t.x, 1.0f + d};
+    }
+
+    float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    rotation = {q.x / length, q.y / length, q.z / length, q.w / length};
+    return true;
+}
+
+void TransformArray::rotationAxes(const glm::vec4& rotation, glm::vec3 out[3])
+{
+    float x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+
+    out[0] = {1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y)};
+    out[1] = {2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x)};
+    out[2] = {2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y)};
+}
+
+const std::vector<uint32_t>& TransformArray::compose()
+{
+    m_composed.clear();
+
+    for (size_t word = 0; word < m_dirty.size(); word++)
+    {
+        uint64_t bits = m_dirty[word];
+        if (!bits)
+        {
+            continue;
+        }
+
+        uint32_t first = static_cast<uint32_t>(word) * BLOCK;
+
+        // whole block in one branch free pass, clean slots recompute to the same values
+        composeBlock(first);
+
+        while (bits)
+        {
+            m_composed.push_back(first + static_cast<uint32_t>(std::countr_zero(bits)));
+            bits &= bits - 1;
+        }
+
+        m_dirty[word] = 0;
+    }
+
+    return m_composed;
+}
+
+void TransformArray::composeBlock(uint32_t first)
+{
+    const float* qx = m_qx.data() + first;
+    const float* qy = m_qy.data() + first;
+    const float* qz = m_qz.data() + first;
+    const float* qw = m_qw.data() + first;
+
+    // local block cannot alias the inputs, lanes are independent so this vectorizes
+    alignas(ALIGNMENT) float r[9][BLOCK];
+
+    for (uint32_t i = 0; i < BLOCK; i++)
+    {
+        float x = qx[i], y = qy[i], z = qz[i], w = qw[i];
+
+        float xx = x * x, yy = y * y, zz = z * z;
+        float xy = x * y, xz = x * z, yz = y * z;
+        float wx = w * x, wy = w * y, wz = w * z;
+
+        r[0][i] = 1.0f - 2.0f * (yy + zz);
+        r[1][i] = 2.0f * (xy + wz);
+        r[2][i] = 2.0f * (xz - wy);
+
+        r[3][i] = 2.0f * (xy - wz);
+        r[4][i] = 1.0f - 2.0f * (xx + zz);
+        r[5][i] = 2.0f * (yz + wx);
+
+        r[6][i] = 2.0f * (xz + wy);
+        r[7][i] = 2.0f * (yz - wx);
+        r[8][i] = 1.0f - 2.0f * (xx + yy);
+    }
+
+    for (int k = 0; k < 9; k++)
+    {
+        std::copy(r[k], r[k] + BLOCK, m_r[k].data() + first);
+    }
+
+    const float* px = m_px.data() + first;
+    const float* py = m_py.data() + first;
+    const float* pz = m_pz.data() + first;
+    const float* sx = m_sx.data() + first;
+    const float* sy = m_sy.data() + first;
+    const float* sz = m_sz.data() + first;
+
+    // column major, scaled rotation columns then translation
+    float* out = &m_matrices[first][0][0];
+    for (uint32_t i = 0; i < BLOCK; i++)
+    {
+        float* m = out + i * 16;
+
+        m[0] = r[0][i] * sx[i];
+        m[1] = r[1][i] * sx[i];
+        m[2] = r[2][i] * sx[i];
+        m[3] = 0.0f;
+
+        m[4] = r[3][i] * sy[i];
+        m[5] = r[4][i] * sy[i];
+        m[6] = r[5][i] * sy[i];
+        m[7] = 0.0f;
+
+        m[8] = r[6][i] * sz[i];
+        m[9] = r[7][i] * sz[i];
+        m[10] = r[8][i] * sz[i];
+        m[11] = 0.0f;
+
+        m[12] = px[i];
+        m[13] = py[i];
+        m[14] = pz[i];
+        m[15] = 1.0f;
+    }
+}
+
+void TransformArray::axes(uint32_t slot, glm::vec3 out[3]) const
+{
+    out[0] = {m_r[0][slot], m_r[1][slot], m_r[2][slot]};
+    out[1] = {m_r[3][slot], m_r[4][slot], m_r[5][slot]};
+    out[2] = {m_r[6][slot], m_r[7][slot], m_r[8][slot]};
+}
+
+void TransformArray::grow()
+{
+    size_t first = m_matrices.size();
+    size_t size = first + BLOCK;
+
+    for (auto* v : {&m_px, &m_py, &m_pz, &m_qx, &m_qy, &m_qz})
+    {
+        v->resize(size, 0.0f);
+    }
+    for (auto* v : {&m_qw, &m_sx, &m_sy, &m_sz})
+    {
+        v->resize(size, 1.0f);
+    }
+
+    // identity axes until first compose
+    for (int k = 0; k < 9; k++)
+    {
+        m_r[k].resize(size, (k % 4 == 0) ? 1.0f : 0.0f);
+    }
+
+    m_matrices.resize(size, glm::mat4(1.0f));
+    m_dirty.push_back(0);
+
+    // lowest slot is handed out first
+    for (size_t slot = size; slot > first; slot--)
+    {
+        m_free.push_back(static_cast<uint32_t>(slot - 1));
+    }
+}
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,103 @@
+/*
+ * TransformArray.h
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace BulletEngine {
+namespace core {
+
+// allocator for vectors the compose pass streams through
+template<class T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<class U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment})); }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t{Alignment}); }
+
+    template<class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template<class U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// position, rotation and scale in structure of arrays form, model matrices composed in one pass over dirty slots
+class TransformArray {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr uint32_t BLOCK = 64;   // slots per dirty mask word
+
+    template<class T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T, ALIGNMENT>>;
+
+    // slots are reused after release, a new slot is identity
+    uint32_t allocate();
+    void release(uint32_t slot);
+
+    // setters mark slot dirty only if the value changed
+    void setPosition(uint32_t slot, const glm::vec3& position);
+    void setScale(uint32_t slot, const glm::vec3& scale);
+    void setRotation(uint32_t slot, float x, float y, float z, float w);
+
+    // shortest rotation taking model axis from onto direction to, neither need be normalized
+    void setDirection(uint32_t slot, const glm::vec3& from, const glm::vec3& to);
+
+    bool isDirty(uint32_t slot) const { return (m_dirty[slot / BLOCK] >> (slot % BLOCK)) & 1u; }
+
+    // compose matrices and axes of dirty slots, returns the slots composed, clears dirty mask
+    const std::vector<uint32_t>& compose();
+
+    // contiguous, aligned, indexed by slot
+    const glm::mat4* matrices() const { return m_matrices.data(); }
+    const glm::mat4& matrix(uint32_t slot) const { return m_matrices[slot]; }
+
+    // unit rotation axes as of last compose, the columns of the model matrix without scale
+    void axes(uint32_t slot, glm::vec3 out[3]) const;
+
+    glm::vec3 position(uint32_t slot) const { return {m_px[slot], m_py[slot], m_pz[slot]}; }
+
+    size_t capacity() const { return m_matrices.size(); }
+
+    // shortest rotation taking from onto to as quaternion (x, y, z, w), false if either is zero
+    static bool rotationBetween(const glm::vec3& from, const glm::vec3& to, glm::vec4& rotation);
+
+    // unit axes of rotation, same as the columns compose writes
+    static void rotationAxes(const glm::vec4& rotation, glm::vec3 out[3]);
+    size_t size() const { return m_matrices.size() - m_free.size(); }
+
+private:
+    void grow();
+    void markDirty(uint32_t slot) { m_dirty[slot / BLOCK] |= uint64_t(1) << (slot % BLOCK); }
+    void composeBlock(uint32_t first);
+
+    // state
+    AlignedVector<float> m_px, m_py, m_pz;
+    AlignedVector<float> m_qx, m_qy, m_qz, m_qw;
+    AlignedVector<float> m_sx, m_sy, m_sz;
+
+    // rotation columns, written by compose
+    AlignedVector<float> m_r[9];
+
+    AlignedVector<glm::mat4> m_matrices;
+
+    std::vector<uint64_t> m_dirty;
+    std::vector<uint32_t> m_free;
+    std::vector<uint32_t> m_composed;
+};
+
+} // namespace core
+} // namespace BulletEngine
@@ -0,0 +1,59 @@
+/*
+ * TripleBuffer.h
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace BulletEngine {
+namespace core {
+
+// lock-free single writer, single reader exchange of the latest complete value
+// writer and reader each own one slot, the third is handed over through an atomic index
+template<class T>
+class TripleBuffer {
+public:
+    // writer side, slot is private until publish
+    T& writeBuffer() { return m_slots[m_write].value; }
+
+    void publish()
+    {
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_write | FRESH), std::memory_order_acq_rel);
+        m_write = previous & INDEX;
+    }
+
+    // reader side, returns true if a newer value was taken, readBuffer stays valid until next acquire
+    bool acquire()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH))
+        {
+            return false;
+        }
+
+        uint8_t previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = previous & INDEX;
+        return true;
+    }
+
+    const T& readBuffer() const { return m_slots[m_read].value; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    // own cache line each, writer and reader never share one
+    struct alignas(64) Slot {
+        T value;
+    };
+
+    Slot m_slots[3];
+
+    alignas(64) uint8_t m_write = 0;
+    alignas(64) uint8_t m_read = 1;
+    alignas(64) std::atomic<uint8_t> m_middle{2};
+};
+
+} // namespace core
+} // namespace BulletEngine
@@ -5,15 +5,21 @@
 #pragma once
 
 #include "ecs/Ecs.h"
+#include "collision/Heightfield.h"
+#include "assets/AssetCache.h"
 
 #include "scene/Transform.h"
 #include "scene/Model.h"
 #include "render/Material.h"
 
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 #include "builtin/bodies/RigidBody.h"
 #include "builtin/collision/collider/Collider.h"
 #include "math/Vec3.h"
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -22,12 +28,23 @@ namespace ecs {
 
 class TransformComponent : public Component {
 public:
+    // matrix written by TransformSystemBase
     BulletRender::scene::Transform transform;
+
+    // pose composed by TransformSystemBase, position follows the rigid body if there is one
+    glm::vec3 position{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale{1.0f};
+
+    // model axis turned along body velocity, written into rotation of bodies unless zero
+    glm::vec3 alignAxis{0.0f};
 };
 
 class RenderableComponent : public Component {
 public:
     BulletRender::scene::Model* model = nullptr;
+    assets::ModelHandle asset;      // used instead of model if set
+    assets::ShaderHandle shader;    // used instead of material shader if set, built on render thread
     BulletRender::render::Material material;
 };
 
@@ -37,16 +54,35 @@ public:
     virtual ~RigidBodyComponent() = default;
 
     std::unique_ptr<BulletPhysics::builtin::bodies::RigidBody> body;
+
+    // not integrated, collision pairs with other resting bodies are not tested again
+    bool isSleeping = false;
 };
 
+// collision layer bits
+namespace CollisionLayer {
+    static constexpr uint32_t NONE = 0;
+    static constexpr uint32_t DEFAULT = 1u << 0;
+    static constexpr uint32_t STATIC = 1u << 1;
+    static constexpr uint32_t GROUND = 1u << 2;
+    static constexpr uint32_t PROJECTILE = 1u << 3;
+    static constexpr uint32_t ALL = 0xFFFFFFFFu;
+} // namespace CollisionLayer
+
 class ColliderComponent : public Component {
 public:
     std::shared_ptr<BulletPhysics::builtin::collision::collider::Collider> collider;
 
-    // debug visualization
+    // terrain, bodies are swept against it instead of pair tested
+    std::shared_ptr<collision::Heightfield> heightfield;
+
+    // pair filtering, pair is tested only if each layer is in the other mask
+    uint32_t layer = CollisionLayer::DEFAULT;
+    uint32_t mask = CollisionLayer::ALL;
+
+    // debug wireframe, drawn by DebugDrawSystemBase
     bool isVisible = false;
-    BulletRender::scene::Model* model = nullptr;
-    BulletRender::render::Material material;
+    glm::vec3 debugColor{0.0f, 1.0f, 0.0f};
 };
 
 } // namespace ecs
@@ -9,6 +9,7 @@ namespace ecs {
 
 Entity World::create()
 {
+    BE_ALLOCATION_SCOPE("ecs");
     Entity entity = m_nextId++;
     m_entities.push_back(entity);
     return entity;
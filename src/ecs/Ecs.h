@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "core/AllocationTracker.h"
+
 #include <cstdint>
 #include <vector>
 #include <memory>
@@ -30,6 +32,7 @@ public:
     template<class C, class... Args>
     C& add(Entity entity, Args&&... args)
     {
+        BE_ALLOCATION_SCOPE("ecs");
         auto& vec = m_components[entity];
         vec.emplace_back(std::make_unique<C>(std::forward<Args>(args)...));
         return *static_cast<C*>(vec.back().get());
@@ -4,47 +4,413 @@
 
 #include "CollisionSystem.h"
 
+#include "builtin/collision/collider/BoxCollider.h"
+#include "builtin/collision/collider/GroundCollider.h"
+
+#include "core/Profiler.h"
+#include "core/TransformArray.h"
+
+#include <algorithm>
+
 namespace BulletEngine {
 namespace ecs {
 namespace systems {
 
-CollisionSystemBase::CollisionSystemBase() : m_collisionDetector(std::make_unique<BulletPhysics::builtin::collision::Collision>()) {}
+// pairs handed to a worker at once
+static constexpr size_t PAIR_GRAIN = 64;
+
+CollisionSystemBase::CollisionSystemBase() : CollisionSystemBase(nullptr) {}
+
+CollisionSystemBase::CollisionSystemBase(core::ThreadPool* threadPool) : m_threadPool(threadPool)
+{
+    size_t workers = m_threadPool ? m_threadPool->size() : 1;
+
+    m_narrowphases.resize(workers);
+    for (auto& narrowphase : m_narrowphases)
+    {
+        narrowphase.detector = std::make_unique<BulletPhysics::builtin::collision::Collision>();
+    }
+}
 
 void CollisionSystemBase::update(World& world)
 {
-    // register all colliders
-    m_collisionDetector->clear();
+    BE_PROFILE_SCOPE("collision");
+
+    {
+        BE_PROFILE_SCOPE("collision/register");
+
+        // register all colliders
+        m_broadphase.clear();
+        m_terrains.clear();
+        m_resting.clear();
+        m_sleeping.clear();
+        m_poses.clear();
+
+        for (auto entity : world.entities())
+        {
+            auto* colliderComponent = world.get<ColliderComponent>(entity);
+            if (!colliderComponent)
+            {
+                continue;
+            }
+
+            if (colliderComponent->collider)
+            {
+                m_broadphase.add(entity, colliderComponent->collider.get(), colliderComponent->layer, colliderComponent->mask);
 
-    std::unordered_map<BulletPhysics::builtin::collision::collider::Collider*, Entity> colliderToEntity;    // map collider -> entity
+                // static or sleeping
+                auto* rigidBodyComponent = world.get<RigidBodyComponent>(entity);
+                bool sleeping = rigidBodyComponent && rigidBodyComponent->body && rigidBodyComponent->isSleeping;
+                m_resting.push_back(!rigidBodyComponent || !rigidBodyComponent->body || sleeping);
+                m_sleeping.push_back(sleeping);
+
+                // bodies own the collider pose, static colliders keep theirs
+                Pose pose;
+                if (rigidBodyComponent && rigidBodyComponent->body)
+                {
+                    pose.body = rigidBodyComponent->body.get();
+
+                    auto* transformComponent = world.get<TransformComponent>(entity);
+                    if (transformComponent)
+                    {
+                        const auto& q = transformComponent->rotation;
+                        pose.alignAxis = transformComponent->alignAxis;
+                        pose.rotation = {q.x, q.y, q.z, q.w};
+                        pose.hasRotation = true;
+                    }
+                }
+                m_poses.push_back(pose);
+            }
+
+            if (colliderComponent->heightfield)
+            {
+                m_terrains.push_back({entity, colliderComponent->heightfield.get(), colliderComponent->layer, colliderComponent->mask});
+            }
+        }
+    }
+
+    m_frame++;
+
+    {
+        BE_PROFILE_SCOPE("collision/broadphase");
+
+        // candidate pairs, filtered by layer and mask
+        m_broadphase.findPairs(m_candidates);
+
+        // pairs of resting bodies keep their cached contact instead of being tested again
+        // at least one side must be a sleeping body, colliders without one are posed by hand and always tested
+        m_pairs.clear();
+        m_carried.clear();
+
+        for (const auto& pair : m_candidates)
+        {
+            if (!m_resting[pair.a] || !m_resting[pair.b] || (!m_sleeping[pair.a] && !m_sleeping[pair.b]))
+            {
+                m_pairs.push_back(pair);
+                continue;
+            }
+
+            const auto* entry = m_pairCache.find(m_broadphase.proxy(pair.a).entity, m_broadphase.proxy(pair.b).entity);
+            if (entry)
+            {
+                m_carried.push_back({entry->entityA, entry->entityB, 0, entry->manifold, true});
+            }
+        }
+    }
 
-    for (auto entity : world.entities())
     {
-        auto* colliderComponent = world.get<ColliderComponent>(entity);
-        if (colliderComponent && colliderComponent->collider)
+        BE_PROFILE_SCOPE("collision/narrowphase");
+
+        // pose only colliders the narrowphase will test, before workers read them
+        for (const auto& pair : m_pairs)
         {
-            auto* collider = colliderComponent->collider.get();
-            m_collisionDetector->addCollider(collider);
-            colliderToEntity[collider] = entity;
+            syncPose(pair.a);
+            syncPose(pair.b);
         }
+
+        // detect collisions, pairs are independent
+        for (auto& narrowphase : m_narrowphases)
+        {
+            narrowphase.contacts.clear();
+        }
+
+        if (m_threadPool)
+        {
+            m_threadPool->parallelFor(m_pairs.size(), PAIR_GRAIN, [this](size_t begin, size_t end, size_t worker) {
+                BE_PROFILE_SCOPE("collision/pairs");
+                detectRange(m_narrowphases[worker], begin, end);
+            });
+        }
+        else
+        {
+            detectRange(m_narrowphases[0], 0, m_pairs.size());
+        }
+
+        // merge, order must not depend on thread count
+        m_contacts.clear();
+        for (auto& narrowphase : m_narrowphases)
+        {
+            m_contacts.insert(m_contacts.end(), narrowphase.contacts.begin(), narrowphase.contacts.end());
+        }
+        m_contacts.insert(m_contacts.end(), m_carried.begin(), m_carried.end());
+
+        std::sort(m_contacts.begin(), m_contacts.end(), [](const Contact& a, const Contact& b) {
+            if (a.entityA != b.entityA) return a.entityA < b.entityA;
+            if (a.entityB != b.entityB) return a.entityB < b.entityB;
+            return a.order < b.order;
+        });
     }
 
-    // detect collisions
-    std::vector<BulletPhysics::builtin::collision::Manifold> manifolds;
-    m_collisionDetector->detect(manifolds);
+    // before hooks run, they may destroy entities and their bodies
+    if (m_queriesEnabled)
+    {
+        buildQueryTree(world);
+    }
+
+    {
+        BE_PROFILE_SCOPE("collision/dispatch");
+
+        // handle collisions
+        for (const auto& contact : m_contacts)
+        {
+            // resting pairs were not detected again, their manifold is the last one seen
+            if (!contact.carried)
+            {
+                onCollision(world, contact.entityA, contact.entityB, contact.manifold);
+            }
+
+            // one event per pair, first manifold
+            if (contact.order != 0)
+            {
+                continue;
+            }
+
+            if (m_pairCache.touch(contact.entityA, contact.entityB, contact.manifold, m_frame))
+            {
+                onCollisionBegin(world, contact.entityA, contact.entityB, contact.manifold);
+            }
+            else
+            {
+                onCollisionStay(world, contact.entityA, contact.entityB, contact.manifold);
+            }
+        }
+
+        // pairs that stopped touching, or whose entity is gone
+        m_pairCache.removeStale(m_frame, m_ended);
+        for (const auto& entry : m_ended)
+        {
+            onCollisionEnd(world, entry.entityA, entry.entityB);
+        }
+    }
 
-    // handle collisions
-    for (const auto& manifold : manifolds)
+    if (!m_terrains.empty())
     {
-        auto itA = colliderToEntity.find(manifold.colliderA);
-        auto itB = colliderToEntity.find(manifold.colliderB);
+        sweepTerrain(world);
+    }
+}
+
+void CollisionSystemBase::sweepTerrain(World& world)
+{
+    BE_PROFILE_SCOPE("collision/terrain");
+
+    m_positions.clear();
 
-        if (itA == colliderToEntity.end() || itB == colliderToEntity.end())
+    for (const auto& proxy : m_broadphase.proxies())
+    {
+        auto* rigidBodyComponent = world.get<RigidBodyComponent>(proxy.entity);
+        if (!rigidBodyComponent || !rigidBodyComponent->body)
         {
             continue;
         }
 
-        onCollision(world, itA->second, itB->second, manifold);
+        // segment covered since last update
+        auto it = m_previousPositions.find(proxy.entity);
+        if (it != m_previousPositions.end())
+        {
+            const auto& from = it->second;
+            const auto& to = rigidBodyComponent->body->getPosition();
+
+            for (const auto& terrain : m_terrains)
+            {
+                if (!collision::Broadphase::canCollide(proxy.layer, proxy.mask, terrain.layer, terrain.mask))
+                {
+                    continue;
+                }
+
+                if (auto hit = terrain.heightfield->sweep(from, to))
+                {
+                    onTerrainHit(world, proxy.entity, terrain.entity, *hit);
+                }
+            }
+        }
+
+        // after hooks, they may move the body
+        m_positions[proxy.entity] = rigidBodyComponent->body->getPosition();
+    }
+
+    std::swap(m_positions, m_previousPositions);
+}
+
+void CollisionSystemBase::syncPose(uint32_t proxy)
+{
+    using namespace BulletPhysics::builtin::collision::collider;
+
+    auto& pose = m_poses[proxy];
+    if (pose.posed || !pose.body)
+    {
+        return;
+    }
+    pose.posed = true;
+
+    auto* collider = m_broadphase.proxy(proxy).collider;
+    collider->setPosition(pose.body->getPosition());
+
+    if (collider->getShape() != CollisionShape::Box)
+    {
+        return;
+    }
+
+    // orientation turns align axis onto velocity, resting bodies keep the last one, without align axis the transform rotation holds
+    glm::vec4 rotation = pose.rotation;
+    if (pose.alignAxis != glm::vec3(0.0f))
+    {
+        const auto& v = pose.body->getVelocity();
+        if (v.x * v.x + v.y * v.y + v.z * v.z <= 1e-6 || !core::TransformArray::rotationBetween(pose.alignAxis, {static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)}, rotation))
+        {
+            return;
+        }
     }
+    else if (!pose.hasRotation)
+    {
+        return;
+    }
+
+    core::TransformArray::rotationAxes(rotation, pose.axes);
+    pose.hasAxes = true;
+
+    const auto* axes = pose.axes;
+    static_cast<BoxCollider*>(collider)->setAxes({axes[0].x, axes[0].y, axes[0].z}, {axes[1].x, axes[1].y, axes[1].z}, {axes[2].x, axes[2].y, axes[2].z});
+}
+
+void CollisionSystemBase::detectRange(Narrowphase& narrowphase, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        const auto& proxyA = m_broadphase.proxy(m_pairs[i].a);
+        const auto& proxyB = m_broadphase.proxy(m_pairs[i].b);
+
+        narrowphase.detector->clear();
+        narrowphase.detector->addCollider(proxyA.collider);
+        narrowphase.detector->addCollider(proxyB.collider);
+
+        narrowphase.manifolds.clear();
+        narrowphase.detector->detect(narrowphase.manifolds);
+
+        uint32_t order = 0;
+        for (const auto& manifold : narrowphase.manifolds)
+        {
+            if (manifold.colliderA == proxyA.collider)
+            {
+                narrowphase.contacts.push_back({proxyA.entity, proxyB.entity, order++, manifold});
+            }
+            else
+            {
+                narrowphase.contacts.push_back({proxyB.entity, proxyA.entity, order++, manifold});
+            }
+        }
+    }
+}
+
+void CollisionSystemBase::setQueriesEnabled(bool enabled)
+{
+    m_queriesEnabled = enabled;
+
+    if (!enabled)
+    {
+        m_queryTree.clear();
+        m_queryOwners.clear();
+    }
+}
+
+void CollisionSystemBase::raycastBatch(std::span<const collision::Ray> rays, std::span<collision::RayHit> hits) const
+{
+    m_queryTree.raycast(rays, hits);
+}
+
+void CollisionSystemBase::buildQueryTree(World& world)
+{
+    BE_PROFILE_SCOPE("collision/query tree");
+
+    using namespace BulletPhysics::builtin::collision::collider;
+
+    m_queryTree.clear();
+    m_queryOwners.clear();
+
+    const auto& proxies = m_broadphase.proxies();
+    for (uint32_t index = 0; index < proxies.size(); index++)
+    {
+        const auto& proxy = proxies[index];
+        syncPose(index);
+
+        // tree keeps material pointers, the collider must outlive its entity until next update
+        m_queryOwners.push_back(world.get<ColliderComponent>(proxy.entity)->collider);
+
+        auto& material = proxy.collider->getMaterial();
+        const auto* materialPtr = material.has_value() ? &material.value() : nullptr;
+
+        switch (proxy.collider->getShape())
+        {
+            case CollisionShape::Box:
+            {
+                auto* box = static_cast<BoxCollider*>(proxy.collider);
+
+                // orientation of body pose, else from transform
+                BulletPhysics::math::Vec3 axes[3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+
+                auto* transformComponent = world.get<TransformComponent>(proxy.entity);
+                if (m_poses[index].hasAxes)
+                {
+                    for (int k = 0; k < 3; k++)
+                    {
+                        const auto& axis = m_poses[index].axes[k];
+                        axes[k] = {axis.x, axis.y, axis.z};
+                    }
+                }
+                else if (transformComponent)
+                {
+                    const auto& mat = transformComponent->transform.getMatrix();
+                    for (int k = 0; k < 3; k++)
+                    {
+                        BulletPhysics::math::Vec3 axis{mat[k].x, mat[k].y, mat[k].z};
+                        if (axis.length() > 1e-9)
+                        {
+                            axes[k] = axis.normalized();
+                        }
+                    }
+                }
+
+                const auto& size = box->getSize();
+                m_queryTree.addBox(proxy.entity, proxy.layer, proxy.collider->getPosition(), axes, size * 0.5, materialPtr);
+                break;
+            }
+            case CollisionShape::Ground:
+            {
+                auto* ground = static_cast<GroundCollider*>(proxy.collider);
+                m_queryTree.addPlane(proxy.entity, proxy.layer, ground->getHeight(), materialPtr);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    for (const auto& terrain : m_terrains)
+    {
+        m_queryOwners.push_back(world.get<ColliderComponent>(terrain.entity)->heightfield);
+        m_queryTree.addHeightfield(terrain.entity, terrain.layer, terrain.heightfield);
+    }
+
+    m_queryTree.build();
 }
 
 } // namespace systems
@@ -7,9 +7,19 @@
 #include "ecs/Ecs.h"
 #include "ecs/Components.h"
 
+#include "collision/Broadphase.h"
+#include "collision/PairCache.h"
+#include "collision/QueryTree.h"
+#include "core/ThreadPool.h"
+
 #include "builtin/collision/Collision.h"
 
+#include <glm/glm.hpp>
+
 #include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
 namespace BulletEngine {
 namespace ecs {
@@ -18,15 +28,96 @@ namespace systems {
 class CollisionSystemBase {
 public:
     CollisionSystemBase();
+    explicit CollisionSystemBase(core::ThreadPool* threadPool);
     virtual ~CollisionSystemBase() = default;
 
     void update(World& world);
 
+    // ray queries need a tree rebuilt every update, off by default, disabling frees the tree
+    void setQueriesEnabled(bool enabled);
+    bool isQueriesEnabled() const { return m_queriesEnabled; }
+
+    // ray queries against colliders as of last update before its hooks ran, hits[i] answers rays[i]
+    // every ray misses unless queries were enabled before that update
+    void raycastBatch(std::span<const collision::Ray> rays, std::span<collision::RayHit> hits) const;
+
 protected:
     // hooks
+    virtual void onCollisionBegin(World&, Entity, Entity, const BulletPhysics::builtin::collision::Manifold&) {}
+    virtual void onCollisionStay(World&, Entity, Entity, const BulletPhysics::builtin::collision::Manifold&) {}
+    virtual void onCollisionEnd(World&, Entity, Entity) {}
+
+    // every manifold the narrowphase found this update, resting pairs it skipped get onCollisionStay only
     virtual void onCollision(World&, Entity, Entity, const BulletPhysics::builtin::collision::Manifold&) {}
+    virtual void onTerrainHit(World&, Entity, Entity, const collision::TerrainHit&) {}
+
+    collision::Broadphase m_broadphase;
+
+private:
+    // manifold tagged with its entities, sort key for deterministic delivery
+    struct Contact {
+        Entity entityA = 0;
+        Entity entityB = 0;
+        uint32_t order = 0;
+        BulletPhysics::builtin::collision::Manifold manifold;
+        bool carried = false;       // cached manifold of a resting pair, not detected again
+    };
+
+    // per worker narrowphase state
+    struct Narrowphase {
+        std::unique_ptr<BulletPhysics::builtin::collision::Collision> detector;
+        std::vector<BulletPhysics::builtin::collision::Manifold> manifolds;
+        std::vector<Contact> contacts;
+    };
+
+    // collider pose of a body, derived from the body the first time an update needs it
+    struct Pose {
+        BulletPhysics::builtin::bodies::RigidBody* body = nullptr;
+        glm::vec3 alignAxis{0.0f};
+        glm::vec4 rotation{0.0f, 0.0f, 0.0f, 1.0f};     // x, y, z, w
+        glm::vec3 axes[3];
+        bool hasRotation = false;       // from transform, used without align axis
+        bool hasAxes = false;
+        bool posed = false;
+    };
+
+    struct Terrain {
+        Entity entity = 0;
+        const collision::Heightfield* heightfield = nullptr;
+        uint32_t layer = 0;
+        uint32_t mask = 0;
+    };
+
+    void syncPose(uint32_t proxy);
+    void detectRange(Narrowphase& narrowphase, size_t begin, size_t end);
+    void sweepTerrain(World& world);
+    void buildQueryTree(World& world);
+
+    core::ThreadPool* m_threadPool = nullptr;
+    std::vector<Narrowphase> m_narrowphases;
+
+    // reused between updates
+    std::vector<collision::Pair> m_candidates;
+    std::vector<collision::Pair> m_pairs;
+    std::vector<bool> m_resting;            // static or sleeping, by proxy
+    std::vector<bool> m_sleeping;           // sleeping body, by proxy
+    std::vector<Pose> m_poses;              // by proxy
+    std::vector<Contact> m_contacts;
+    std::vector<Contact> m_carried;
+    std::vector<collision::PairCache::Entry> m_ended;
+
+    collision::PairCache m_pairCache;
+    uint64_t m_frame = 0;
+
+    // built by update if queries are enabled, owners keep colliders and heightfields the tree points into alive
+    bool m_queriesEnabled = false;
+    collision::QueryTree m_queryTree;
+    std::vector<std::shared_ptr<const void>> m_queryOwners;
 
-    std::unique_ptr<BulletPhysics::builtin::collision::Collision> m_collisionDetector;
+    // body positions from previous update, start of terrain sweeps
+    std::vector<Terrain> m_terrains;
+    std::unordered_map<Entity, BulletPhysics::math::Vec3> m_positions;
+    std::unordered_map<Entity, BulletPhysics::math::Vec3> m_previousPositions;
 };
 
 } // namespace systems
@@ -0,0 +1,95 @@
+/*
+ * DebugDrawSystem.cpp
+ */
+
+#include "DebugDrawSystem.h"
+
+#include "builtin/collision/collider/BoxCollider.h"
+#include "builtin/collision/collider/GroundCollider.h"
+
+#include "core/Profiler.h"
+
+namespace BulletEngine {
+namespace ecs {
+namespace systems {
+
+void DebugDrawSystemBase::render(World& world, const glm::vec3& eye)
+{
+    BE_PROFILE_SCOPE("debug draw");
+
+    using namespace BulletPhysics::builtin::collision::collider;
+
+    if (!m_draw.isEnabled(rendering::DebugCategory::ALL))
+    {
+        m_draw.endFrame();
+        return;
+    }
+
+    for (auto entity : world.entities())
+    {
+        auto* colliderComponent = world.get<ColliderComponent>(entity);
+        if (!colliderComponent || !colliderComponent->isVisible || !colliderComponent->collider)
+        {
+            continue;
+        }
+
+        const auto& color = colliderComponent->debugColor;
+
+        switch (colliderComponent->collider->getShape())
+        {
+            case CollisionShape::Box:
+            {
+                if (!m_draw.isEnabled(rendering::DebugCategory::COLLIDER_BOX))
+                {
+                    break;
+                }
+
+                auto* box = static_cast<BoxCollider*>(colliderComponent->collider.get());
+
+                // orientation from transform, same as the query tree
+                glm::vec3 axes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+
+                auto* transformComponent = world.get<TransformComponent>(entity);
+                if (transformComponent)
+                {
+                    const auto& mat = transformComponent->transform.getMatrix();
+                    for (int k = 0; k < 3; k++)
+                    {
+                        glm::vec3 axis{mat[k].x, mat[k].y, mat[k].z};
+                        float length = glm::length(axis);
+                        if (length > 1e-9f)
+                        {
+                            axes[k] = axis / length;
+                        }
+                    }
+                }
+
+                // presentation pose, collider pose is only updated when collision needs it
+                const auto& p = box->getPosition();
+                glm::vec3 center = transformComponent ? transformComponent->position : glm::vec3{static_cast<float>(p.x), static_cast<float>(p.y), static_cast<float>(p.z)};
+
+                const auto& size = box->getSize();
+                glm::vec3 halfExtents{static_cast<float>(size.x * 0.5), static_cast<float>(size.y * 0.5), static_cast<float>(size.z * 0.5)};
+
+                m_draw.box(rendering::DebugCategory::COLLIDER_BOX, center, axes, halfExtents, color);
+                break;
+            }
+            case CollisionShape::Ground:
+            {
+                auto* ground = static_cast<GroundCollider*>(colliderComponent->collider.get());
+                m_draw.grid(rendering::DebugCategory::COLLIDER_GROUND, static_cast<float>(ground->getHeight()), eye, m_gridExtent, m_gridCell, color);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    onRender(world, m_draw);
+
+    m_draw.endFrame();
+}
+
+} // namespace systems
+} // namespace ecs
+} // namespace BulletEngine
@@ -0,0 +1,54 @@
+/*
+ * DebugDrawSystem.h
+ */
+
+#pragma once
+
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "rendering/DebugDraw.h"
+
+#include "render/passes/Lines.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+
+namespace BulletEngine {
+namespace ecs {
+namespace systems {
+
+// visible colliders as wireframes, all shapes share the one line buffer of the sink
+class DebugDrawSystemBase {
+public:
+    static constexpr float DEFAULT_GRID_EXTENT = 50.0f;    // m around eye
+    static constexpr float DEFAULT_GRID_CELL = 1.0f;        // m
+
+    explicit DebugDrawSystemBase(std::shared_ptr<BulletRender::render::Lines> lines) : m_draw(lines ? std::make_shared<rendering::LinesAdapter>(std::move(lines)) : nullptr) {}
+    explicit DebugDrawSystemBase(std::shared_ptr<rendering::LineSink> lines) : m_draw(std::move(lines)) {}
+    virtual ~DebugDrawSystemBase() = default;
+
+    // once per rendered frame, ground grid follows eye
+    void render(World& world, const glm::vec3& eye);
+
+    void setEnabled(uint32_t categories, bool enabled) { m_draw.setEnabled(categories, enabled); }
+    bool isEnabled(uint32_t category) const { return m_draw.isEnabled(category); }
+
+    void setGrid(float halfExtent, float cellSize) { m_gridExtent = halfExtent; m_gridCell = cellSize; }
+
+    rendering::DebugDraw& getDraw() { return m_draw; }
+
+protected:
+    // hook for extra shapes, drawn after colliders into the same frame
+    virtual void onRender(World&, rendering::DebugDraw&) {}
+
+private:
+    rendering::DebugDraw m_draw;
+
+    float m_gridExtent = DEFAULT_GRID_EXTENT;
+    float m_gridCell = DEFAULT_GRID_CELL;
+};
+
+} // namespace systems
+} // namespace ecs
+} // namespace BulletEngine
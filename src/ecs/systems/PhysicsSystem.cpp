@@ -4,6 +4,8 @@
 
 #include "PhysicsSystem.h"
 
+#include "core/Profiler.h"
+
 namespace BulletEngine {
 namespace ecs {
 namespace systems {
@@ -15,12 +17,13 @@ PhysicsSystemBase::PhysicsSystemBase(BulletPhysics::ballistics::external::Physic
 
 void PhysicsSystemBase::update(World& world, float dt)
 {
+    BE_PROFILE_SCOPE("physics");
+
     for (auto entity : world.entities())
     {
-        auto* transformComponent = world.get<TransformComponent>(entity);
         auto* rigidBodyComponent = world.get<RigidBodyComponent>(entity);
 
-        if (!rigidBodyComponent || !rigidBodyComponent->body)
+        if (!rigidBodyComponent || !rigidBodyComponent->body || rigidBodyComponent->isSleeping)
         {
             continue;
         }
@@ -33,20 +36,8 @@ void PhysicsSystemBase::update(World& world, float dt)
 
         afterIntegrate(world, entity, *rigidBodyComponent, dt);
 
-        // update transform
-        if (transformComponent)
-        {
-            const auto& p = rigidBodyComponent->body->getPosition();
-            transformComponent->transform.setPosition({static_cast<float>(p.x), static_cast<float>(p.y), static_cast<float>(p.z)});
-        }
-
-        // update collider
-        auto* colliderComponent = world.get<ColliderComponent>(entity);
-        if (colliderComponent && colliderComponent->collider && transformComponent)
-        {
-            const auto& p = rigidBodyComponent->body->getPosition();
-            colliderComponent->collider->setPosition(p);
-        }
+        // body is the only state a substep writes, collider pose is derived by the collision system
+        // and the render transform once per frame by the transform system
     }
 }
 
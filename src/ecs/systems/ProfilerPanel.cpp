@@ -0,0 +1,208 @@
+/*
+ * ProfilerPanel.cpp
+ */
+
+#include "ProfilerPanel.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <string>
+
+namespace BulletEngine {
+namespace ecs {
+namespace systems {
+
+// flame bar layout
+static constexpr float BAR_HEIGHT = 16.0f;
+static constexpr float THREAD_GAP = 6.0f;
+
+// stable color per scope
+static ImU32 scopeColor(uint32_t scope)
+{
+    uint32_t h = scope * 2654435761u;
+    return IM_COL32(80 + (h & 0x7F), 80 + ((h >> 8) & 0x7F), 80 + ((h >> 16) & 0x7F), 255);
+}
+
+void ProfilerPanel::render()
+{
+    m_frameTimes[m_frame % FRAME_HISTORY] = static_cast<float>(m_profiler.lastFrameTime());
+    m_frame++;
+
+    ImGui::Begin("Profiler");
+
+#ifndef BULLET_ENGINE_PROFILE
+    ImGui::Text("Profiler scopes compiled out, build with PROFILE=ON");
+#endif
+
+    bool enabled = m_profiler.isEnabled();
+    if (ImGui::Checkbox("Record", &enabled))
+    {
+        m_profiler.setEnabled(enabled);
+    }
+
+    // retained window as chrome trace json, enabled by BE_TRACE_MB
+    if (m_profiler.isTracing())
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("Dump trace"))
+        {
+            std::string path = "trace-manual-" + std::to_string(m_traceDumps++) + ".json";
+            m_traceStatus = m_profiler.dumpTrace(path) ? "wrote " + path : "failed to write " + path;
+        }
+
+        if (!m_traceStatus.empty())
+        {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(m_traceStatus.c_str());
+        }
+    }
+
+    // frame times, oldest first
+    size_t frames = std::min(m_frame, FRAME_HISTORY);
+    float maxFrame = *std::max_element(m_frameTimes, m_frameTimes + frames);
+    ImGui::Text("Frame: %.2f ms, max %.2f ms, threads %zu, dropped %zu", m_profiler.lastFrameTime(), maxFrame, m_profiler.getThreadCount(), m_profiler.getDroppedEvents());
+    ImGui::PlotLines("##frames", m_frameTimes, static_cast<int>(frames), static_cast<int>(m_frame >= FRAME_HISTORY ? m_frame % FRAME_HISTORY : 0), nullptr, 0.0f, maxFrame * 1.1f, ImVec2(0.0f, 40.0f));
+
+    ImGui::Separator();
+
+    // per scope statistics over history
+    m_profiler.stats(m_stats);
+    std::sort(m_stats.begin(), m_stats.end(), [](const auto& a, const auto& b) { return a.mean > b.mean; });
+
+    if (ImGui::BeginTable("scopes", 5))
+    {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("Mean ms");
+        ImGui::TableSetupColumn("P99 ms");
+        ImGui::TableSetupColumn("Last ms");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableHeadersRow();
+
+        for (const auto& scope : m_stats)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(scope.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", scope.mean);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", scope.p99);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", scope.last);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", scope.calls);
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::Separator();
+    renderFlame();
+
+    if (core::AllocationTracker::isCompiledIn())
+    {
+        ImGui::Separator();
+        renderAllocations();
+    }
+
+    ImGui::End();
+}
+
+void ProfilerPanel::renderAllocations()
+{
+    auto& tracker = core::AllocationTracker::instance();
+    tracker.stats(m_allocations);
+    std::sort(m_allocations.begin(), m_allocations.end(), [](const auto& a, const auto& b) { return a.allocations > b.allocations; });
+
+    ImGui::Text("Allocations: %llu total, %.1f MB live", static_cast<unsigned long long>(tracker.getAllocations()), static_cast<double>(tracker.getLiveBytes()) / (1024.0 * 1024.0));
+
+    // last frame, budgeted tags over their limit in red
+    if (ImGui::BeginTable("allocations", 5))
+    {
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Allocs");
+        ImGui::TableSetupColumn("Self");
+        ImGui::TableSetupColumn("Bytes");
+        ImGui::TableSetupColumn("Budget");
+        ImGui::TableHeadersRow();
+
+        for (const auto& tag : m_allocations)
+        {
+            bool over = tag.hasBudget && (tag.allocations > tag.budget.maxAllocations || tag.bytes > tag.budget.maxBytes);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(tag.name);
+            ImGui::TableNextColumn();
+            if (over)
+            {
+                ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%llu", static_cast<unsigned long long>(tag.allocations));
+            }
+            else
+            {
+                ImGui::Text("%llu", static_cast<unsigned long long>(tag.allocations));
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(tag.selfAllocations));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(tag.bytes));
+            ImGui::TableNextColumn();
+            if (tag.hasBudget)
+            {
+                ImGui::Text("%llu, %llu missed", static_cast<unsigned long long>(tag.budget.maxAllocations), static_cast<unsigned long long>(tag.violations));
+            }
+        }
+
+        ImGui::EndTable();
+    }
+}
+
+void ProfilerPanel::renderFlame()
+{
+    const auto& events = m_profiler.lastFrame();
+    double frameTime = m_profiler.lastFrameTime();
+    if (events.empty() || frameTime <= 0.0)
+    {
+        return;
+    }
+
+    // one lane per thread, nested scopes stack downward
+    uint32_t threads = 0;
+    uint32_t maxDepth = 0;
+    for (const auto& event : events)
+    {
+        threads = std::max(threads, event.thread + 1);
+        maxDepth = std::max(maxDepth, event.depth + 1);
+    }
+
+    float laneHeight = static_cast<float>(maxDepth) * BAR_HEIGHT + THREAD_GAP;
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    float height = static_cast<float>(threads) * laneHeight;
+
+    auto* drawList = ImGui::GetWindowDrawList();
+    float scale = width / static_cast<float>(frameTime);
+
+    for (const auto& event : events)
+    {
+        float x0 = origin.x + static_cast<float>(event.start) * scale;
+        float x1 = std::max(x0 + 1.0f, origin.x + static_cast<float>(event.start + event.duration) * scale);
+        float y0 = origin.y + static_cast<float>(event.thread) * laneHeight + static_cast<float>(event.depth) * BAR_HEIGHT;
+        float y1 = y0 + BAR_HEIGHT - 1.0f;
+
+        drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), scopeColor(event.scope));
+
+        // label only bars wide enough to read
+        if (x1 - x0 > ImGui::CalcTextSize(event.name).x + 4.0f)
+        {
+            drawList->AddText(ImVec2(x0 + 2.0f, y0 + 1.0f), IM_COL32(0, 0, 0, 255), event.name);
+        }
+    }
+
+    ImGui::Dummy(ImVec2(width, height));
+}
+
+} // namespace systems
+} // namespace ecs
+} // namespace BulletEngine
@@ -0,0 +1,43 @@
+/*
+ * ProfilerPanel.h
+ */
+
+#pragma once
+
+#include "core/Profiler.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace BulletEngine {
+namespace ecs {
+namespace systems {
+
+// imgui window with per scope times and flame bars of last frame, add to ImGuiSystemBase
+class ProfilerPanel {
+public:
+    static constexpr size_t FRAME_HISTORY = 240;
+
+    explicit ProfilerPanel(core::Profiler& profiler = core::Profiler::instance()) : m_profiler(profiler) {}
+
+    void render();
+
+private:
+    void renderFlame();
+    void renderAllocations();
+
+    core::Profiler& m_profiler;
+    std::vector<core::Profiler::ScopeStats> m_stats;
+    std::vector<core::AllocationTracker::TagStats> m_allocations;
+
+    float m_frameTimes[FRAME_HISTORY] = {};
+    size_t m_frame = 0;
+
+    size_t m_traceDumps = 0;
+    std::string m_traceStatus;
+};
+
+} // namespace systems
+} // namespace ecs
+} // namespace BulletEngine
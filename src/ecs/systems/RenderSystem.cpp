@@ -4,47 +4,249 @@
 
 #include "RenderSystem.h"
 
+#include "core/Profiler.h"
+
+#include <algorithm>
+
 namespace BulletEngine {
 namespace ecs {
 namespace systems {
 
-RenderSystemBase::RenderSystemBase(BulletRender::scene::Scene& scene) : m_scene(scene) {}
+// collapses every vertex onto the origin, nothing is rasterized
+static const glm::mat4 HIDDEN_MATRIX(0.0f);
+
+// hidden objects still cost a draw each, below this many they are never worth a rebuild
+static constexpr size_t MIN_HIDDEN = 64;
+
+RenderSystemBase::RenderSystemBase(BulletRender::scene::Scene& scene) : m_scene(&scene) {}
+
+RenderSystemBase::RenderSystemBase(rendering::InstanceRenderer& renderer) : m_instanceRenderer(&renderer) {}
+
+RenderSystemBase::~RenderSystemBase() = default;
+
+void RenderSystemBase::setInstanceRenderer(rendering::InstanceRenderer* renderer)
+{
+    m_instanceRenderer = renderer;
+}
 
 void RenderSystemBase::render(World& world)
 {
-    m_scene.clear();
+    BE_PROFILE_SCOPE("render");
+
+    extract(world, m_instances);
+    submit(m_instances, &world);
+}
+
+void RenderSystemBase::render(const rendering::FrameSnapshot& snapshot)
+{
+    BE_PROFILE_SCOPE("render");
+
+    submit(snapshot.instances, nullptr);
+}
+
+void RenderSystemBase::extract(World& world, std::vector<rendering::RenderInstance>& instances)
+{
+    BE_PROFILE_SCOPE("render/extract");
+
+    instances.clear();
 
     for (auto entity : world.entities())
     {
         auto* transformComponent = world.get<TransformComponent>(entity);
+        if (!transformComponent)
+        {
+            continue;
+        }
+
+        const auto& matrix = transformComponent->transform.getMatrix();
 
-        // render normal objects
         auto* renderableComponent = world.get<RenderableComponent>(entity);
-        if (transformComponent && renderableComponent && renderableComponent->model)
+        if (renderableComponent && (renderableComponent->asset || renderableComponent->model))
+        {
+            const auto& material = renderableComponent->material;
+            instances.push_back({entity, renderableComponent->model, renderableComponent->asset, material.getShader(), renderableComponent->shader, matrix, material.getColor()});
+        }
+    }
+}
+
+void RenderSystemBase::submit(const std::vector<rendering::RenderInstance>& instances, World* world)
+{
+    m_frame++;
+
+    bool batched = m_instanceRenderer != nullptr;
+    if (!batched && !m_scene)
+    {
+        return;
+    }
+
+    if (batched)
+    {
+        // objects left from before the switch to batching
+        if (m_scene && (!m_objects.empty() || m_hiddenCount > 0))
+        {
+            m_scene->clear();
+            m_objects.clear();
+            m_hidden.clear();
+            m_hiddenCount = 0;
+        }
+
+        m_batcher.begin();
+    }
+    else
+    {
+        prune(instances);
+    }
+
+    for (const auto& instance : instances)
+    {
+        // handle resolves to placeholder while loading, model swap replaces scene object
+        BulletRender::scene::Model* model = instance.asset ? instance.asset->get() : instance.model;
+
+        // shader asset is nullptr until the cache built it
+        const auto& shader = instance.shaderAsset ? instance.shaderAsset->get() : instance.shader;
+
+        // batches also take models that are still loading or never uploaded
+        if (batched)
+        {
+            const void* source = instance.asset ? static_cast<const void*>(instance.asset.get()) : model;
+            m_batcher.add(source, model, shader, instance.transform, instance.color);
+            continue;
+        }
+
+        if (!model || !m_scene)
+        {
+            continue;
+        }
+
+        auto& retained = m_objects[instance.entity];
+
+        sync(retained, model, instance.asset, shader, instance.color, instance.transform);
+        retained.frame = m_frame;
+
+        if (world)
         {
-            auto* object = m_scene.addObject(renderableComponent->model);
+            onObjectRender(*world, instance.entity, *retained.object);
+        }
+    }
 
-            object->getMaterial().setShader(renderableComponent->material.getShader());
-            object->getMaterial().setColor(renderableComponent->material.getColor());
+    if (batched)
+    {
+        m_batcher.end();
+        m_batcher.submit(*m_instanceRenderer);
+    }
+}
 
-            object->getTransform().setMatrix(transformComponent->transform.getMatrix());
+void RenderSystemBase::prune(const std::vector<rendering::RenderInstance>& instances)
+{
+    // swapped model hides the old object, sync then takes a hidden one of the new model or adds one
+    for (const auto& instance : instances)
+    {
+        BulletRender::scene::Model* model = instance.asset ? instance.asset->get() : instance.model;
+        if (!model)
+        {
+            continue;
+        }
 
-            onObjectRender(world, entity, *object);
+        auto it = m_objects.find(instance.entity);
+        if (it != m_objects.end())
+        {
+            it->second.frame = m_frame;
+            if (it->second.model != model)
+            {
+                hide(it->second);
+            }
         }
+    }
 
-        // render colliders
-        auto* colliderComponent = world.get<ColliderComponent>(entity);
-        if (transformComponent && colliderComponent && colliderComponent->isVisible && colliderComponent->model)
+    for (auto it = m_objects.begin(); it != m_objects.end();)
+    {
+        if (it->second.frame != m_frame)
         {
-            auto* collider = m_scene.addObject(colliderComponent->model);
+            hide(it->second);
+            it = m_objects.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
 
-            collider->getMaterial().setShader(colliderComponent->material.getShader());
-            collider->getMaterial().setColor(colliderComponent->material.getColor());
+    // rebuilding costs one add per survivor, paid at most once per as many removals
+    if (m_hiddenCount <= std::max(m_objects.size(), MIN_HIDDEN))
+    {
+        return;
+    }
 
-            collider->getTransform().setMatrix(transformComponent->transform.getMatrix());
+    // survivors are added again by sync with their last state
+    m_scene->clear();
+    m_hidden.clear();
+    m_hiddenCount = 0;
+    for (auto& [entity, retained] : m_objects)
+    {
+        retained.object = nullptr;
+    }
+}
 
-            onColliderRender(world, entity, *collider);
+void RenderSystemBase::hide(Retained& retained)
+{
+    if (!retained.object)
+    {
+        return;
+    }
+
+    retained.object->getTransform().setMatrix(HIDDEN_MATRIX);
+    m_hidden[retained.model].push_back({retained.object, std::move(retained.asset)});
+    m_hiddenCount++;
+
+    retained.object = nullptr;
+}
+
+void RenderSystemBase::sync(Retained& retained, BulletRender::scene::Model* model, const assets::ModelHandle& asset, const std::shared_ptr<BulletRender::render::Shader>& shader, const glm::vec3& color, const glm::mat4& matrix)
+{
+    // new object, hidden by prune or gone with a rebuild
+    if (!retained.object)
+    {
+        auto hidden = m_hidden.find(model);
+        if (hidden != m_hidden.end() && !hidden->second.empty())
+        {
+            retained.object = hidden->second.back().object;
+            hidden->second.pop_back();
+            m_hiddenCount--;
+        }
+        else
+        {
+            retained.object = m_scene->addObject(model);
         }
+
+        retained.model = model;
+        retained.asset = asset;
+        retained.shader = shader.get();
+        retained.color = color;
+        retained.matrix = matrix;
+
+        retained.object->getMaterial().setShader(shader);
+        retained.object->getMaterial().setColor(color);
+        retained.object->getTransform().setMatrix(matrix);
+        return;
+    }
+
+    // copy only what changed
+    if (retained.shader != shader.get())
+    {
+        retained.shader = shader.get();
+        retained.object->getMaterial().setShader(shader);
+    }
+
+    if (retained.color != color)
+    {
+        retained.color = color;
+        retained.object->getMaterial().setColor(color);
+    }
+
+    if (retained.matrix != matrix)
+    {
+        retained.matrix = matrix;
+        retained.object->getTransform().setMatrix(matrix);
     }
 }
 
@@ -7,8 +7,15 @@
 #include "ecs/Ecs.h"
 #include "ecs/Components.h"
 
+#include "rendering/InstanceBatcher.h"
+#include "rendering/FrameSnapshot.h"
+
 #include "scene/Scene.h"
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 namespace BulletEngine {
 namespace ecs {
 namespace systems {
@@ -16,18 +23,70 @@ namespace systems {
 class RenderSystemBase {
 public:
     explicit RenderSystemBase(BulletRender::scene::Scene& scene);
-    virtual ~RenderSystemBase() = default;
+
+    // headless, renderables always go to renderer
+    explicit RenderSystemBase(rendering::InstanceRenderer& renderer);
+    virtual ~RenderSystemBase();
 
     void render(World& world);
 
+    // draw state published by a simulation thread, hooks are not called
+    void render(const rendering::FrameSnapshot& snapshot);
+
+    // collect drawables of world, safe on simulation thread, assets are not resolved
+    static void extract(World& world, std::vector<rendering::RenderInstance>& instances);
+
+    // draw renderables as batches through renderer instead of scene objects, nullptr to switch back
+    void setInstanceRenderer(rendering::InstanceRenderer* renderer);
+
+    // counters of last batched frame
+    const rendering::BatchStats& getBatchStats() const { return m_batcher.stats(); }
+
 protected:
-    // hooks
+    // hooks, onObjectRender is not called for batched renderables
     virtual void onObjectRender(World&, Entity, BulletRender::scene::SceneObject&) {}
-    virtual void onColliderRender(World&, Entity, BulletRender::scene::SceneObject&) {}
 
-    BulletRender::scene::Scene& m_scene;
-};
+    BulletRender::scene::Scene* m_scene = nullptr;
 
+private:
+    // scene object kept alive across frames, with the state last copied into it
+    struct Retained {
+        BulletRender::scene::SceneObject* object = nullptr;
+        BulletRender::scene::Model* model = nullptr;
+        assets::ModelHandle asset;          // keeps the model alive while the object shows it
+        const BulletRender::render::Shader* shader = nullptr;
+        glm::vec3 color{0.0f};
+        glm::mat4 matrix{1.0f};
+        uint64_t frame = 0;
+    };
+
+    // object nobody draws, kept for the next entity with the same model
+    struct Hidden {
+        BulletRender::scene::SceneObject* object = nullptr;
+        assets::ModelHandle asset;
+    };
+
+    // world is nullptr for snapshots, hooks are skipped then
+    void submit(const std::vector<rendering::RenderInstance>& instances, World* world);
+
+    // create, reuse a hidden one or update object
+    void sync(Retained& retained, BulletRender::scene::Model* model, const assets::ModelHandle& asset, const std::shared_ptr<BulletRender::render::Shader>& shader, const glm::vec3& color, const glm::mat4& matrix);
+
+    // hide objects of entities that are gone and of swapped models, clear scene once hidden ones outnumber the rest
+    void prune(const std::vector<rendering::RenderInstance>& instances);
+
+    // scene has no per-object removal, the object is moved out of view instead
+    void hide(Retained& retained);
+
+    std::unordered_map<Entity, Retained> m_objects;
+    std::unordered_map<BulletRender::scene::Model*, std::vector<Hidden>> m_hidden;
+    size_t m_hiddenCount = 0;
+    uint64_t m_frame = 0;
+
+    std::vector<rendering::RenderInstance> m_instances;
+    rendering::InstanceBatcher m_batcher;
+    rendering::InstanceRenderer* m_instanceRenderer = nullptr;
+};
 
 } // namespace systems
 } // namespace ecs
@@ -0,0 +1,125 @@
+/*
+ * TransformSystem.cpp
+ */
+
+#include "TransformSystem.h"
+
+#include "builtin/collision/collider/BoxCollider.h"
+
+#include "core/Profiler.h"
+
+namespace BulletEngine {
+namespace ecs {
+namespace systems {
+
+void TransformSystemBase::update(World& world)
+{
+    BE_PROFILE_SCOPE("transforms");
+
+    m_frame++;
+
+    // gather pose into arrays, only changed values mark a slot dirty
+    for (auto entity : world.entities())
+    {
+        auto* transformComponent = world.get<TransformComponent>(entity);
+        if (!transformComponent)
+        {
+            continue;
+        }
+
+        auto [it, inserted] = m_slots.try_emplace(entity, Slot{0, 0});
+        if (inserted)
+        {
+            it->second.index = m_transforms.allocate();
+            if (m_entities.size() < m_transforms.capacity())
+            {
+                m_entities.resize(m_transforms.capacity(), 0);
+            }
+            m_entities[it->second.index] = entity;
+        }
+        it->second.frame = m_frame;
+
+        uint32_t slot = it->second.index;
+
+        // bodies own position, their transform follows
+        auto* rigidBodyComponent = world.get<RigidBodyComponent>(entity);
+        if (rigidBodyComponent && rigidBodyComponent->body)
+        {
+            const auto& p = rigidBodyComponent->body->getPosition();
+            transformComponent->position = {static_cast<float>(p.x), static_cast<float>(p.y), static_cast<float>(p.z)};
+
+            // turn model axis along velocity, stored as rotation so resting bodies and a cleared align axis keep the last one
+            const auto& v = rigidBodyComponent->body->getVelocity();
+            const auto& axis = transformComponent->alignAxis;
+            glm::vec4 rotation;
+            if ((axis.x != 0.0f || axis.y != 0.0f || axis.z != 0.0f) && v.x * v.x + v.y * v.y + v.z * v.z > 1e-6
+                && core::TransformArray::rotationBetween(axis, {static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)}, rotation))
+            {
+                transformComponent->rotation = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
+            }
+        }
+
+        const auto& q = transformComponent->rotation;
+        m_transforms.setRotation(slot, q.x, q.y, q.z, q.w);
+        m_transforms.setPosition(slot, transformComponent->position);
+        m_transforms.setScale(slot, transformComponent->scale);
+    }
+
+    // free slots of entities that are gone or lost their transform
+    for (auto it = m_slots.begin(); it != m_slots.end();)
+    {
+        if (it->second.frame != m_frame)
+        {
+            m_transforms.release(it->second.index);
+            m_entities[it->second.index] = 0;
+            it = m_slots.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    const auto& composed = m_transforms.compose();
+    m_lastComposed = composed.size();
+
+    // scatter results to render transforms and static colliders, colliders of bodies are posed by the collision system
+    for (uint32_t slot : composed)
+    {
+        Entity entity = m_entities[slot];
+
+        auto* transformComponent = world.get<TransformComponent>(entity);
+        transformComponent->transform.setPosition(transformComponent->position);
+        transformComponent->transform.setMatrix(m_transforms.matrix(slot));
+
+        auto* colliderComponent = world.get<ColliderComponent>(entity);
+        if (colliderComponent && colliderComponent->collider && !world.has<RigidBodyComponent>(entity))
+        {
+            using namespace BulletPhysics::builtin::collision::collider;
+
+            const auto& p = transformComponent->position;
+            colliderComponent->collider->setPosition({p.x, p.y, p.z});
+
+            if (colliderComponent->collider->getShape() == CollisionShape::Box)
+            {
+                glm::vec3 axes[3];
+                m_transforms.axes(slot, axes);
+
+                auto* box = static_cast<BoxCollider*>(colliderComponent->collider.get());
+                box->setAxes({axes[0].x, axes[0].y, axes[0].z}, {axes[1].x, axes[1].y, axes[1].z}, {axes[2].x, axes[2].y, axes[2].z});
+            }
+        }
+
+        onCompose(world, entity, *transformComponent);
+    }
+}
+
+uint32_t TransformSystemBase::getSlot(Entity entity) const
+{
+    auto it = m_slots.find(entity);
+    return it != m_slots.end() ? it->second.index : INVALID_SLOT;
+}
+
+} // namespace systems
+} // namespace ecs
+} // namespace BulletEngine
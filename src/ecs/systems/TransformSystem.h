@@ -0,0 +1,55 @@
+/*
+ * TransformSystem.h
+ */
+
+#pragma once
+
+#include "ecs/Ecs.h"
+#include "ecs/Components.h"
+#include "core/TransformArray.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace BulletEngine {
+namespace ecs {
+namespace systems {
+
+// composes model matrices of all transforms in one batched pass, once per rendered frame
+// colliders of entities without a body take their pose from the same data
+class TransformSystemBase {
+public:
+    virtual ~TransformSystemBase() = default;
+
+    void update(World& world);
+
+    // slot of entity in getTransforms, INVALID_SLOT if it has no transform
+    uint32_t getSlot(Entity entity) const;
+
+    const core::TransformArray& getTransforms() const { return m_transforms; }
+    size_t getLastComposed() const { return m_lastComposed; }
+
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+protected:
+    // hook, called for every composed entity after its matrix and collider axes are written
+    virtual void onCompose(World&, Entity, TransformComponent&) {}
+
+private:
+    struct Slot {
+        uint32_t index;
+        uint64_t frame;
+    };
+
+    core::TransformArray m_transforms;
+    std::unordered_map<Entity, Slot> m_slots;
+    std::vector<Entity> m_entities;         // by slot index
+    uint64_t m_frame = 0;
+    size_t m_lastComposed = 0;
+};
+
+} // namespace systems
+} // namespace ecs
+} // namespace BulletEngine
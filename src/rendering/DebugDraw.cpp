@@ -0,0 +1,89 @@
+/*
+ * DebugDraw.cpp
+ */
+
+#include "DebugDraw.h"
+
+#include <cmath>
+
+namespace BulletEngine {
+namespace rendering {
+
+void DebugDraw::setEnabled(uint32_t categories, bool enabled)
+{
+    if (enabled)
+    {
+        m_categories |= categories;
+    }
+    else
+    {
+        m_categories &= ~categories;
+    }
+}
+
+void DebugDraw::box(uint32_t category, const glm::vec3& center, const glm::vec3 axes[3], const glm::vec3& halfExtents, const glm::vec3& color)
+{
+    if (!isEnabled(category))
+    {
+        return;
+    }
+
+    glm::vec3 x = axes[0] * halfExtents.x;
+    glm::vec3 y = axes[1] * halfExtents.y;
+    glm::vec3 z = axes[2] * halfExtents.z;
+
+    // corner i has sign bits (x, y, z) = (i & 1, i & 2, i & 4)
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; i++)
+    {
+        corners[i] = center + ((i & 1) ? x : -x) + ((i & 2) ? y : -y) + ((i & 4) ? z : -z);
+    }
+
+    // edges connect corners differing in one bit
+    for (int i = 0; i < 8; i++)
+    {
+        for (int bit = 1; bit < 8; bit <<= 1)
+        {
+            if (!(i & bit))
+            {
+                line(corners[i], corners[i | bit], color);
+            }
+        }
+    }
+}
+
+void DebugDraw::grid(uint32_t category, float height, const glm::vec3& center, float halfExtent, float cellSize, const glm::vec3& color)
+{
+    if (!isEnabled(category) || cellSize <= 0.0f || halfExtent <= 0.0f)
+    {
+        return;
+    }
+
+    int cells = static_cast<int>(std::ceil(halfExtent / cellSize));
+    float extent = static_cast<float>(cells) * cellSize;
+
+    float cx = std::round(center.x / cellSize) * cellSize;
+    float cz = std::round(center.z / cellSize) * cellSize;
+
+    for (int i = -cells; i <= cells; i++)
+    {
+        float offset = static_cast<float>(i) * cellSize;
+        line({cx + offset, height, cz - extent}, {cx + offset, height, cz + extent}, color);
+        line({cx - extent, height, cz + offset}, {cx + extent, height, cz + offset}, color);
+    }
+}
+
+void DebugDraw::endFrame()
+{
+    m_lastFrameLines = m_frameLines;
+    m_frameLines = 0;
+}
+
+void DebugDraw::line(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color)
+{
+    m_lines->addLine(a, b, color);
+    m_frameLines++;
+}
+
+} // namespace rendering
+} // namespace BulletEngine
@@ -0,0 +1,60 @@
+/*
+ * DebugDraw.h
+ */
+
+#pragma once
+
+#include "rendering/LineSink.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace BulletEngine {
+namespace rendering {
+
+// debug draw category bits
+namespace DebugCategory {
+    static constexpr uint32_t NONE = 0;
+    static constexpr uint32_t COLLIDER_BOX = 1u << 0;
+    static constexpr uint32_t COLLIDER_GROUND = 1u << 1;
+    static constexpr uint32_t COLLIDERS = COLLIDER_BOX | COLLIDER_GROUND;
+    static constexpr uint32_t ALL = 0xFFFFFFFFu;
+} // namespace DebugCategory
+
+// wireframe shapes as line segments into one sink, disabled categories cost a mask test
+class DebugDraw {
+public:
+    explicit DebugDraw(std::shared_ptr<LineSink> lines = nullptr) : m_lines(std::move(lines)) {}
+
+    void setLines(std::shared_ptr<LineSink> lines) { m_lines = std::move(lines); }
+
+    void setEnabled(uint32_t categories, bool enabled);
+    bool isEnabled(uint32_t category) const { return m_lines && (m_categories & category) != 0; }
+    uint32_t getCategories() const { return m_categories; }
+
+    // oriented box, axes are unit length
+    void box(uint32_t category, const glm::vec3& center, const glm::vec3 axes[3], const glm::vec3& halfExtents, const glm::vec3& color);
+
+    // horizontal grid at height, snapped to cell size so it does not swim with center
+    void grid(uint32_t category, float height, const glm::vec3& center, float halfExtent, float cellSize, const glm::vec3& color);
+
+    // keep counters of finished frame and start a new one
+    void endFrame();
+
+    size_t getLastFrameLines() const { return m_lastFrameLines; }
+
+private:
+    void line(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color);
+
+    std::shared_ptr<LineSink> m_lines;
+    uint32_t m_categories = DebugCategory::ALL;
+
+    size_t m_frameLines = 0;
+    size_t m_lastFrameLines = 0;
+};
+
+} // namespace rendering
+} // namespace BulletEngine
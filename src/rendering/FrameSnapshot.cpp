@@ -0,0 +1,54 @@
+/*
+ * FrameSnapshot.cpp
+ */
+
+#include "FrameSnapshot.h"
+
+namespace BulletEngine {
+namespace rendering {
+
+void FrameSnapshot::clear()
+{
+    step = 0;
+    simTime = 0.0;
+    instances.clear();
+    polylinePoints.clear();
+    polylines.clear();
+    segments.clear();
+}
+
+void SnapshotLines::addLine(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color)
+{
+    if (m_target)
+    {
+        m_target->segments.push_back({a, b, color});
+    }
+}
+
+void SnapshotLines::addPolyline(const std::vector<glm::vec3>& points, const glm::vec3& color)
+{
+    if (m_target)
+    {
+        m_target->polylines.push_back({m_target->polylinePoints.size(), points.size(), color});
+        m_target->polylinePoints.insert(m_target->polylinePoints.end(), points.begin(), points.end());
+    }
+}
+
+void SnapshotLines::replay(const FrameSnapshot& snapshot, LineSink& lines)
+{
+    for (const auto& segment : snapshot.segments)
+    {
+        lines.addLine(segment.a, segment.b, segment.color);
+    }
+
+    // sink takes vectors, reuse one per thread
+    thread_local std::vector<glm::vec3> points;
+    for (const auto& polyline : snapshot.polylines)
+    {
+        points.assign(snapshot.polylinePoints.begin() + polyline.first, snapshot.polylinePoints.begin() + polyline.first + polyline.count);
+        lines.addPolyline(points, polyline.color);
+    }
+}
+
+} // namespace rendering
+} // namespace BulletEngine
@@ -0,0 +1,75 @@
+/*
+ * FrameSnapshot.h
+ */
+
+#pragma once
+
+#include "ecs/Ecs.h"
+#include "assets/AssetCache.h"
+#include "rendering/LineSink.h"
+
+#include "scene/Model.h"
+#include "render/Shader.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace BulletEngine {
+namespace rendering {
+
+// one drawable extracted from the world, model and shader of assets are resolved when drawn
+struct RenderInstance {
+    ecs::Entity entity = 0;
+    BulletRender::scene::Model* model = nullptr;
+    assets::ModelHandle asset;
+    std::shared_ptr<BulletRender::render::Shader> shader;
+    assets::ShaderHandle shaderAsset;
+    glm::mat4 transform{1.0f};
+    glm::vec3 color{0.0f};
+};
+
+// everything the render thread needs from one simulation state
+struct FrameSnapshot {
+    struct Polyline {
+        size_t first;           // index into polylinePoints
+        size_t count;
+        glm::vec3 color;
+    };
+
+    struct Segment {
+        glm::vec3 a;
+        glm::vec3 b;
+        glm::vec3 color;
+    };
+
+    uint64_t step = 0;          // simulation steps taken
+    double simTime = 0.0;       // s
+
+    std::vector<RenderInstance> instances;
+    std::vector<glm::vec3> polylinePoints;
+    std::vector<Polyline> polylines;
+    std::vector<Segment> segments;
+
+    // keeps capacity
+    void clear();
+};
+
+// records lines into a snapshot, replayed on the render thread
+class SnapshotLines : public LineSink {
+public:
+    void setTarget(FrameSnapshot* snapshot) { m_target = snapshot; }
+
+    void addLine(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color) override;
+    void addPolyline(const std::vector<glm::vec3>& points, const glm::vec3& color) override;
+
+    static void replay(const FrameSnapshot& snapshot, LineSink& lines);
+
+private:
+    FrameSnapshot* m_target = nullptr;
+};
+
+} // namespace rendering
+} // namespace BulletEngine
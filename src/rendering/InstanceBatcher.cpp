@@ -0,0 +1,110 @@
+/*
+ * InstanceBatcher.cpp
+ */
+
+#include "InstanceBatcher.h"
+
+#include <algorithm>
+
+namespace BulletEngine {
+namespace rendering {
+
+void InstanceBatcher::begin()
+{
+    // batches unused for a frame go, their source may be gone and its address reused
+    if (std::erase_if(m_batches, [](const auto& batch) { return batch->transforms.empty(); }) > 0)
+    {
+        m_lookup.clear();
+        for (size_t i = 0; i < m_batches.size(); i++)
+        {
+            m_lookup.emplace(Key{m_batches[i]->source, m_batches[i]->shader.get()}, i);
+        }
+    }
+
+    // keep capacity, most batches come back next frame
+    for (auto& batch : m_batches)
+    {
+        batch->transforms.clear();
+        batch->colors.clear();
+    }
+
+    m_order.clear();
+    m_stats = {};
+}
+
+void InstanceBatcher::add(const void* source, BulletRender::scene::Model* model, const std::shared_ptr<BulletRender::render::Shader>& shader, const glm::mat4& transform, const glm::vec3& color)
+{
+    Key key{source, shader.get()};
+
+    auto it = m_lookup.find(key);
+    if (it == m_lookup.end())
+    {
+        auto batch = std::make_unique<InstanceBatch>();
+        batch->source = source;
+        batch->shader = shader;
+
+        it = m_lookup.emplace(key, m_batches.size()).first;
+        m_batches.push_back(std::move(batch));
+    }
+
+    // asset swaps placeholder for loaded model
+    auto& batch = *m_batches[it->second];
+    batch.model = model;
+    batch.transforms.push_back(transform);
+    batch.colors.push_back(color);
+}
+
+void InstanceBatcher::end()
+{
+    m_order.clear();
+
+    for (const auto& batch : m_batches)
+    {
+        if (!batch->transforms.empty())
+        {
+            m_order.push_back(batch.get());
+        }
+    }
+
+    // shader switches cost more than buffer switches
+    std::sort(m_order.begin(), m_order.end(), [](const InstanceBatch* a, const InstanceBatch* b) {
+        if (a->shader.get() != b->shader.get()) return a->shader.get() < b->shader.get();
+        return a->source < b->source;
+    });
+
+    m_stats = {};
+
+    const BulletRender::render::Shader* boundShader = nullptr;
+    const void* boundSource = nullptr;
+
+    for (const auto* batch : m_order)
+    {
+        m_stats.instances += batch->transforms.size();
+        m_stats.batches++;
+
+        if (m_stats.batches == 1 || batch->shader.get() != boundShader)
+        {
+            m_stats.shaderChanges++;
+            boundShader = batch->shader.get();
+        }
+
+        if (m_stats.batches == 1 || batch->source != boundSource)
+        {
+            m_stats.modelChanges++;
+            boundSource = batch->source;
+        }
+    }
+}
+
+void InstanceBatcher::submit(InstanceRenderer& renderer) const
+{
+    for (const auto* batch : m_order)
+    {
+        renderer.draw(*batch);
+    }
+
+    renderer.finish();
+}
+
+} // namespace rendering
+} // namespace BulletEngine
@@ -0,0 +1,96 @@
+/*
+ * InstanceBatcher.h
+ */
+
+#pragma once
+
+#include "scene/Model.h"
+#include "render/Shader.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace BulletEngine {
+namespace rendering {
+
+// all instances drawn with one model and one shader
+struct InstanceBatch {
+    const void* source = nullptr;                   // model asset or model the batch was keyed by
+    BulletRender::scene::Model* model = nullptr;    // nullptr while loading or headless
+    std::shared_ptr<BulletRender::render::Shader> shader;
+
+    // per instance, same length
+    std::vector<glm::mat4> transforms;
+    std::vector<glm::vec3> colors;
+};
+
+// cpu side counters of last frame, a batch is one draw call only for a backend that draws instanced
+struct BatchStats {
+    size_t instances = 0;
+    size_t batches = 0;
+    size_t shaderChanges = 0;       // between consecutive batches
+    size_t modelChanges = 0;
+
+    size_t stateChanges() const { return shaderChanges + modelChanges; }
+};
+
+// backend receiving the batches of a frame in draw order
+class InstanceRenderer {
+public:
+    virtual ~InstanceRenderer() = default;
+    virtual void draw(const InstanceBatch& batch) = 0;
+
+    // after the last batch of a frame
+    virtual void finish() {}
+};
+
+// groups instances by (source, shader), batch storage is kept while the batch is drawn every frame
+class InstanceBatcher {
+public:
+    // drops batches that were empty last frame
+    void begin();
+    void add(const void* source, BulletRender::scene::Model* model, const std::shared_ptr<BulletRender::render::Shader>& shader, const glm::mat4& transform, const glm::vec3& color);
+
+    // order batches by shader then source and count state changes
+    void end();
+
+    void submit(InstanceRenderer& renderer) const;
+
+    // non-empty batches in draw order, valid after end
+    const std::vector<const InstanceBatch*>& batches() const { return m_order; }
+    const BatchStats& stats() const { return m_stats; }
+
+    // batches kept in storage, including those empty this frame
+    size_t storedBatches() const { return m_batches.size(); }
+
+private:
+    struct Key {
+        const void* source;
+        const BulletRender::render::Shader* shader;
+
+        bool operator==(const Key& other) const { return source == other.source && shader == other.shader; }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const
+        {
+            auto a = reinterpret_cast<uintptr_t>(key.source);
+            auto b = reinterpret_cast<uintptr_t>(key.shader);
+            return std::hash<uintptr_t>()(a ^ (b * 0x9E3779B97F4A7C15ull));
+        }
+    };
+
+    std::vector<std::unique_ptr<InstanceBatch>> m_batches;
+    std::unordered_map<Key, size_t, KeyHash> m_lookup;
+
+    std::vector<const InstanceBatch*> m_order;
+    BatchStats m_stats;
+};
+
+} // namespace rendering
+} // namespace BulletEngine
@@ -0,0 +1,39 @@
+/*
+ * LineSink.h
+ */
+
+#pragma once
+
+#include "render/passes/Lines.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace BulletEngine {
+namespace rendering {
+
+// destination for debug and trajectory lines
+class LineSink {
+public:
+    virtual ~LineSink() = default;
+
+    virtual void addLine(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color) = 0;
+    virtual void addPolyline(const std::vector<glm::vec3>& points, const glm::vec3& color) = 0;
+};
+
+// forwards to a BulletRender lines pass
+class LinesAdapter : public LineSink {
+public:
+    explicit LinesAdapter(std::shared_ptr<BulletRender::render::Lines> lines) : m_lines(std::move(lines)) {}
+
+    void addLine(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color) override { m_lines->addLine(a, b, color); }
+    void addPolyline(const std::vector<glm::vec3>& points, const glm::vec3& color) override { m_lines->addPolyline(points, color); }
+
+private:
+    std::shared_ptr<BulletRender::render::Lines> m_lines;
+};
+
+} // namespace rendering
+} // namespace BulletEngine
@@ -0,0 +1,54 @@
+/*
+ * NullBackend.cpp
+ */
+
+#include "NullBackend.h"
+
+namespace BulletEngine {
+namespace rendering {
+
+void NullLines::addLine(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color)
+{
+    m_segments.push_back({a, b, color});
+}
+
+void NullLines::addPolyline(const std::vector<glm::vec3>& points, const glm::vec3& color)
+{
+    for (size_t i = 0; i + 1 < points.size(); ++i)
+    {
+        m_segments.push_back({points[i], points[i + 1], color});
+    }
+    m_polylines++;
+}
+
+void NullLines::endFrame()
+{
+    m_lastFrameSegments = m_segments.size();
+    m_lastFramePolylines = m_polylines;
+    m_totalSegments += m_segments.size();
+
+    // keep capacity, next frame submits about as much
+    m_segments.clear();
+    m_polylines = 0;
+}
+
+void NullInstanceRenderer::draw(const InstanceBatch& batch)
+{
+    m_submissions.push_back({batch.source, batch.shader.get(), m_transforms.size(), batch.transforms.size()});
+    m_transforms.insert(m_transforms.end(), batch.transforms.begin(), batch.transforms.end());
+    m_colors.insert(m_colors.end(), batch.colors.begin(), batch.colors.end());
+}
+
+void NullInstanceRenderer::endFrame()
+{
+    m_lastFrameBatches = m_submissions.size();
+    m_lastFrameInstances = m_transforms.size();
+    m_totalInstances += m_transforms.size();
+
+    m_submissions.clear();
+    m_transforms.clear();
+    m_colors.clear();
+}
+
+} // namespace rendering
+} // namespace BulletEngine
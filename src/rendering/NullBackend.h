@@ -0,0 +1,83 @@
+/*
+ * NullBackend.h
+ */
+
+#pragma once
+
+#include "rendering/LineSink.h"
+#include "rendering/InstanceBatcher.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace BulletEngine {
+namespace rendering {
+
+// records lines instead of drawing them, for headless runs
+class NullLines : public LineSink {
+public:
+    struct Segment {
+        glm::vec3 a;
+        glm::vec3 b;
+        glm::vec3 color;
+    };
+
+    void addLine(const glm::vec3& a, const glm::vec3& b, const glm::vec3& color) override;
+    void addPolyline(const std::vector<glm::vec3>& points, const glm::vec3& color) override;
+
+    // segments of current frame, polylines are split into segments
+    const std::vector<Segment>& segments() const { return m_segments; }
+
+    // keep counters of finished frame and start a new one
+    void endFrame();
+
+    size_t getLastFrameSegments() const { return m_lastFrameSegments; }
+    size_t getLastFramePolylines() const { return m_lastFramePolylines; }
+    size_t getTotalSegments() const { return m_totalSegments; }
+
+private:
+    std::vector<Segment> m_segments;
+    size_t m_polylines = 0;
+
+    size_t m_lastFrameSegments = 0;
+    size_t m_lastFramePolylines = 0;
+    size_t m_totalSegments = 0;
+};
+
+// records batches instead of drawing them, for headless runs
+class NullInstanceRenderer : public InstanceRenderer {
+public:
+    struct Submission {
+        const void* source;
+        const BulletRender::render::Shader* shader;
+        size_t first;           // index into transforms
+        size_t count;
+    };
+
+    void draw(const InstanceBatch& batch) override;
+
+    // submissions of current frame, transforms and colors concatenated in draw order
+    const std::vector<Submission>& submissions() const { return m_submissions; }
+    const std::vector<glm::mat4>& transforms() const { return m_transforms; }
+    const std::vector<glm::vec3>& colors() const { return m_colors; }
+
+    void endFrame();
+
+    size_t getLastFrameBatches() const { return m_lastFrameBatches; }
+    size_t getLastFrameInstances() const { return m_lastFrameInstances; }
+    size_t getTotalInstances() const { return m_totalInstances; }
+
+private:
+    std::vector<Submission> m_submissions;
+    std::vector<glm::mat4> m_transforms;
+    std::vector<glm::vec3> m_colors;
+
+    size_t m_lastFrameBatches = 0;
+    size_t m_lastFrameInstances = 0;
+    size_t m_totalInstances = 0;
+};
+
+} // namespace rendering
+} // namespace BulletEngine
@@ -0,0 +1,87 @@
+/*
+ * SceneInstanceRenderer.cpp
+ */
+
+#include "SceneInstanceRenderer.h"
+
+namespace BulletEngine {
+namespace rendering {
+
+void SceneInstanceRenderer::draw(const InstanceBatch& batch)
+{
+    // nothing to draw while loading without placeholder
+    if (batch.model)
+    {
+        m_batches.push_back(&batch);
+    }
+}
+
+void SceneInstanceRenderer::finish()
+{
+    // layout is the model of every instance in draw order, appending keeps the objects there are
+    size_t count = 0;
+    bool rebuild = false;
+
+    for (const auto* batch : m_batches)
+    {
+        for (size_t i = 0; i < batch->transforms.size(); i++, count++)
+        {
+            rebuild |= count < m_objects.size() && m_objects[count].model != batch->model;
+        }
+    }
+    rebuild |= count < m_objects.size();
+
+    // scene has no per-object removal
+    if (rebuild)
+    {
+        m_scene.clear();
+        m_objects.clear();
+        m_rebuilds++;
+    }
+
+    size_t index = 0;
+    for (const auto* batch : m_batches)
+    {
+        for (size_t i = 0; i < batch->transforms.size(); i++, index++)
+        {
+            const auto& color = batch->colors[i];
+            const auto& matrix = batch->transforms[i];
+
+            if (index == m_objects.size())
+            {
+                auto* object = m_scene.addObject(batch->model);
+                object->getMaterial().setShader(batch->shader);
+                object->getMaterial().setColor(color);
+                object->getTransform().setMatrix(matrix);
+
+                m_objects.push_back({object, batch->model, batch->shader.get(), color, matrix});
+                continue;
+            }
+
+            // copy only what changed
+            auto& object = m_objects[index];
+            if (object.shader != batch->shader.get())
+            {
+                object.shader = batch->shader.get();
+                object.object->getMaterial().setShader(batch->shader);
+            }
+
+            if (object.color != color)
+            {
+                object.color = color;
+                object.object->getMaterial().setColor(color);
+            }
+
+            if (object.matrix != matrix)
+            {
+                object.matrix = matrix;
+                object.object->getTransform().setMatrix(matrix);
+            }
+        }
+    }
+
+    m_batches.clear();
+}
+
+} // namespace rendering
+} // namespace BulletEngine
@@ -0,0 +1,51 @@
+/*
+ * SceneInstanceRenderer.h
+ */
+
+#pragma once
+
+#include "rendering/InstanceBatcher.h"
+
+#include "scene/Scene.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace BulletEngine {
+namespace rendering {
+
+// draws batches through the gl renderer of a scene, owns every object of that scene
+// renderer has no instanced draw call, instances become scene objects laid out in batch order, one draw each
+// objects are kept across frames, only changed state is copied, scene is rebuilt when the layout changes
+class SceneInstanceRenderer : public InstanceRenderer {
+public:
+    explicit SceneInstanceRenderer(BulletRender::scene::Scene& scene) : m_scene(scene) {}
+
+    void draw(const InstanceBatch& batch) override;
+    void finish() override;
+
+    size_t getObjectCount() const { return m_objects.size(); }
+    size_t getRebuilds() const { return m_rebuilds; }
+
+private:
+    struct Object {
+        BulletRender::scene::SceneObject* object;
+        BulletRender::scene::Model* model;
+        const BulletRender::render::Shader* shader;
+        glm::vec3 color;
+        glm::mat4 matrix;
+    };
+
+    BulletRender::scene::Scene& m_scene;
+
+    // batches of current frame, valid until the batcher begins the next one
+    std::vector<const InstanceBatch*> m_batches;
+
+    std::vector<Object> m_objects;      // in draw order
+    size_t m_rebuilds = 0;
+};
+
+} // namespace rendering
+} // namespace BulletEngine
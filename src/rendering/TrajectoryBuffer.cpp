@@ -0,0 +1,302 @@
+/*
+ * TrajectoryBuffer.cpp
+ */
+
+#include "TrajectoryBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BulletEngine {
+namespace rendering {
+
+static float distanceToSegment(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b)
+{
+    glm::vec3 ab = b - a;
+    float lengthSq = glm::dot(ab, ab);
+    float t = lengthSq > 0.0f ? std::clamp(glm::dot(p - a, ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+    return glm::length(p - (a + ab * t));
+}
+
+static float colorDelta(const glm::vec3& a, const glm::vec3& b)
+{
+    return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z)});
+}
+
+void TrajectoryBuffer::append(ecs::Entity entity, const glm::vec3& point, const glm::vec3& color)
+{
+    if (m_maxPoints == 0)
+    {
+        return;
+    }
+
+    auto& track = m_tracks[entity];
+
+    if (track.count == track.points.size())
+    {
+        // full ring, unroll so it can grow at the back
+        if (track.head != 0)
+        {
+            std::rotate(track.points.begin(), track.points.begin() + track.head, track.points.end());
+            std::rotate(track.colors.begin(), track.colors.begin() + track.head, track.colors.end());
+            track.head = 0;
+        }
+
+        track.points.push_back(point);
+        track.colors.push_back(color);
+    }
+    else
+    {
+        size_t slot = (track.head + track.count) % track.points.size();
+        track.points[slot] = point;
+        track.colors[slot] = color;
+    }
+
+    if (track.count > 0 && color != track.colorAt(0))
+    {
+        track.uniform = false;
+    }
+
+    track.count++;
+    m_total++;
+
+    // stale entries are dropped on the way, rebuilt once they outnumber tracks
+    if (m_longest.size() > 2 * m_tracks.size() + 16)
+    {
+        m_longest.clear();
+        for (const auto& [id, other] : m_tracks)
+        {
+            m_longest.push_back({other.count, id});
+        }
+        std::make_heap(m_longest.begin(), m_longest.end());
+    }
+    else
+    {
+        m_longest.push_back({track.count, entity});
+        std::push_heap(m_longest.begin(), m_longest.end());
+    }
+
+    if (m_total > m_maxPoints)
+    {
+        evictOldest();
+    }
+}
+
+void TrajectoryBuffer::record(ecs::Entity entity, const glm::vec3& point, const glm::vec3& color, const SimplifyTolerance& tolerance)
+{
+    auto& track = m_tracks[entity];
+
+    // first point, or anchor lost to eviction
+    if (track.count < 2 || track.window.empty())
+    {
+        append(entity, point, color);
+        track.window.assign(1, {point, point, 0.0f});
+        return;
+    }
+
+    const glm::vec3& anchor = track.at(track.count - 2);
+    bool keep = colorDelta(color, track.colorAt(track.count - 2)) > tolerance.color;
+
+    // distance to a segment is convex, a chord is no farther than its ends, its samples no farther than that plus radius
+    for (size_t i = 0; i < track.window.size() && !keep; ++i)
+    {
+        const auto& run = track.window[i];
+        keep = std::max(distanceToSegment(run.from, anchor, point), distanceToSegment(run.to, anchor, point)) + run.radius > tolerance.distance;
+    }
+
+    if (keep)
+    {
+        // provisional point becomes the anchor of the next segment
+        append(entity, point, color);
+        track.window.assign(1, {point, point, 0.0f});
+    }
+    else
+    {
+        replaceLast(track, point, color);
+
+        // long smooth segments merge neighbouring runs instead of growing the check, radius keeps the bound
+        if (track.window.size() >= SIMPLIFY_WINDOW)
+        {
+            size_t kept = 0;
+            for (size_t i = 0; i + 1 < track.window.size(); i += 2)
+            {
+                const auto& a = track.window[i];
+                const auto& b = track.window[i + 1];
+
+                // merged chord shares the outer ends, only the inner ones add distance
+                float radiusA = a.radius + distanceToSegment(a.to, a.from, b.to);
+                float radiusB = b.radius + distanceToSegment(b.from, a.from, b.to);
+                track.window[kept++] = {a.from, b.to, std::max(radiusA, radiusB)};
+            }
+            if (track.window.size() % 2 != 0)
+            {
+                track.window[kept++] = track.window.back();
+            }
+            track.window.resize(kept);
+        }
+        track.window.push_back({point, point, 0.0f});
+    }
+}
+
+const glm::vec3* TrajectoryBuffer::last(ecs::Entity entity) const
+{
+    auto it = m_tracks.find(entity);
+    if (it == m_tracks.end() || it->second.count == 0)
+    {
+        return nullptr;
+    }
+    return &it->second.at(it->second.count - 1);
+}
+
+void TrajectoryBuffer::remove(ecs::Entity entity)
+{
+    auto it = m_tracks.find(entity);
+    if (it != m_tracks.end())
+    {
+        m_total -= it->second.count;
+        m_tracks.erase(it);
+    }
+}
+
+void TrajectoryBuffer::clear()
+{
+    m_tracks.clear();
+    m_longest.clear();
+    m_total = 0;
+}
+
+void TrajectoryBuffer::keep(ecs::Entity entity)
+{
+    auto it = m_tracks.find(entity);
+    if (it != m_tracks.end())
+    {
+        it->second.frame = m_frame;
+    }
+}
+
+void TrajectoryBuffer::emit(ecs::Entity entity, LineSink& lines, const glm::vec3& eye, float lodAngle)
+{
+    auto it = m_tracks.find(entity);
+    if (it == m_tracks.end())
+    {
+        return;
+    }
+
+    auto& track = it->second;
+    track.frame = m_frame;
+
+    if (track.count < 2)
+    {
+        return;
+    }
+
+    // keep points that span at least lodAngle as seen from eye, first and last always stay
+    auto visible = [&](size_t i, const glm::vec3& emitted) {
+        if (lodAngle <= 0.0f || i + 1 == track.count)
+        {
+            return true;
+        }
+        const glm::vec3& p = track.at(i);
+        return glm::length(p - emitted) >= lodAngle * glm::length(p - eye);
+    };
+
+    if (!track.uniform)
+    {
+        // segment takes the mean of its end colors
+        size_t from = 0;
+        for (size_t i = 1; i < track.count; ++i)
+        {
+            if (visible(i, track.at(from)))
+            {
+                lines.addLine(track.at(from), track.at(i), (track.colorAt(from) + track.colorAt(i)) * 0.5f);
+                m_emittedSegments++;
+                from = i;
+            }
+        }
+        return;
+    }
+
+    // unwrapped ring at full detail can be handed over directly
+    if (lodAngle <= 0.0f && track.head == 0 && track.count == track.points.size())
+    {
+        lines.addPolyline(track.points, track.colors[0]);
+        m_emittedSegments += track.count - 1;
+        return;
+    }
+
+    m_scratch.clear();
+    m_scratch.push_back(track.at(0));
+    for (size_t i = 1; i < track.count; ++i)
+    {
+        if (visible(i, m_scratch.back()))
+        {
+            m_scratch.push_back(track.at(i));
+        }
+    }
+
+    lines.addPolyline(m_scratch, track.colorAt(0));
+    m_emittedSegments += m_scratch.size() - 1;
+}
+
+void TrajectoryBuffer::endFrame()
+{
+    for (auto it = m_tracks.begin(); it != m_tracks.end();)
+    {
+        if (it->second.frame != m_frame)
+        {
+            m_total -= it->second.count;
+            it = m_tracks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    m_frame++;
+    m_lastFrameSegments = m_emittedSegments;
+    m_emittedSegments = 0;
+}
+
+void TrajectoryBuffer::replaceLast(Track& track, const glm::vec3& point, const glm::vec3& color)
+{
+    size_t slot = (track.head + track.count - 1) % track.points.size();
+    track.points[slot] = point;
+    track.colors[slot] = color;
+
+    if (track.count > 1 && color != track.colorAt(0))
+    {
+        track.uniform = false;
+    }
+}
+
+void TrajectoryBuffer::evictOldest()
+{
+    while (!m_longest.empty())
+    {
+        auto [count, entity] = m_longest.front();
+        std::pop_heap(m_longest.begin(), m_longest.end());
+        m_longest.pop_back();
+
+        auto it = m_tracks.find(entity);
+        if (it == m_tracks.end() || it->second.count != count || count == 0)
+        {
+            continue;
+        }
+
+        auto& track = it->second;
+        track.head = (track.head + 1) % track.points.size();
+        track.count--;
+        m_total--;
+
+        if (track.count > 0)
+        {
+            m_longest.push_back({track.count, entity});
+            std::push_heap(m_longest.begin(), m_longest.end());
+        }
+        return;
+    }
+}
+
+} // namespace rendering
+} // namespace BulletEngine
@@ -0,0 +1,110 @@
+/*
+ * TrajectoryBuffer.h
+ */
+
+#pragma once
+
+#include "ecs/Ecs.h"
+
+#include "rendering/LineSink.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BulletEngine {
+namespace rendering {
+
+// error bounds of streaming simplification
+struct SimplifyTolerance {
+    float distance = 0.01f;     // max distance of a dropped sample from the kept polyline, m
+    float color = 0.02f;        // max color channel change along one kept segment
+};
+
+// append-only point history per entity, total point count is capped across all entities
+// recording may run every physics substep, emitting is meant once per rendered frame
+class TrajectoryBuffer {
+public:
+    static constexpr size_t DEFAULT_MAX_POINTS = 1u << 20;
+    static constexpr size_t SIMPLIFY_WINDOW = 32;     // runs of samples checked per candidate segment, halved when full
+
+    explicit TrajectoryBuffer(size_t maxPoints = DEFAULT_MAX_POINTS) : m_maxPoints(maxPoints) {}
+
+    // over the cap the longest track loses its oldest point
+    void append(ecs::Entity entity, const glm::vec3& point, const glm::vec3& color);
+
+    // streaming simplification, last point follows the samples and is kept only once
+    // the segment to the next sample would leave the tolerance of the samples in between
+    void record(ecs::Entity entity, const glm::vec3& point, const glm::vec3& color, const SimplifyTolerance& tolerance);
+
+    // last appended point, nullptr if entity has none
+    const glm::vec3* last(ecs::Entity entity) const;
+
+    void remove(ecs::Entity entity);
+    void clear();
+
+    // one polyline for single colored tracks, one line per segment otherwise
+    // points closer than lodAngle * camera distance to the last emitted one are skipped
+    void emit(ecs::Entity entity, LineSink& lines, const glm::vec3& eye = glm::vec3(0.0f), float lodAngle = 0.0f);
+
+    // keep track through the next endFrame without emitting it, for runs without lines
+    void keep(ecs::Entity entity);
+
+    // drop tracks that were not emitted or kept since the previous call
+    void endFrame();
+
+    // segments emitted since the previous endFrame
+    size_t getEmittedSegments() const { return m_emittedSegments; }
+    size_t getLastFrameSegments() const { return m_lastFrameSegments; }
+
+    size_t size() const { return m_total; }
+    size_t trackCount() const { return m_tracks.size(); }
+    size_t getMaxPoints() const { return m_maxPoints; }
+
+private:
+    // consecutive samples, each within radius of the chord from first to last
+    struct Run {
+        glm::vec3 from;
+        glm::vec3 to;
+        float radius;
+    };
+
+    // ring over points and colors, grows until first eviction wraps it
+    struct Track {
+        std::vector<glm::vec3> points;
+        std::vector<glm::vec3> colors;
+        size_t head = 0;
+        size_t count = 0;
+        bool uniform = true;        // every point has colors[0]
+        uint64_t frame = 0;
+
+        // samples since the last kept point as chords with the max distance of their samples, last point is provisional while non-empty
+        std::vector<Run> window;
+
+        const glm::vec3& at(size_t i) const { return points[(head + i) % points.size()]; }
+        const glm::vec3& colorAt(size_t i) const { return colors[(head + i) % colors.size()]; }
+    };
+
+    void replaceLast(Track& track, const glm::vec3& point, const glm::vec3& color);
+    void evictOldest();
+
+    std::unordered_map<ecs::Entity, Track> m_tracks;
+
+    // max-heap of (count, entity) for eviction, an entry is stale once its track count changed
+    std::vector<std::pair<size_t, ecs::Entity>> m_longest;
+    size_t m_total = 0;
+    size_t m_maxPoints;
+    uint64_t m_frame = 1;
+
+    size_t m_emittedSegments = 0;
+    size_t m_lastFrameSegments = 0;
+
+    std::vector<glm::vec3> m_scratch;
+};
+
+} // namespace rendering
+} // namespace BulletEngine